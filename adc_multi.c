@@ -0,0 +1,135 @@
+/**
+ * @file adc_multi.c
+ * @brief Simultaneous dual/triple ADC sampling of paired sensor channels
+ */
+
+#include "stm32f4xx.h"
+#include "adc_multi.h"
+
+// DMA ring: DEPTH packed words (dual) or DEPTH * 3 half-words (triple)
+SIM_RAM static uint32_t adc_multi_ring[(ADC_MULTI_DEPTH * ADC_MULTI_MAX_ADCS + 1) / 2];
+SIM_RAM static uint8_t adc_multi_count = 0;
+
+/**
+ * @brief Configure one ADC for a single regular channel
+ */
+static void ADC_Multi_Channel_Init(ADC_TypeDef *adc, uint8_t channel)
+{
+    // Set resolution to 12-bit
+    adc->CR1 &= ~ADC_CR1_RES;
+
+    // Sample time 480 cycles (same as ADC1_Init)
+    if (channel < 10)
+    {
+        adc->SMPR2 |= 7UL << (3 * channel);
+    }
+    else
+    {
+        adc->SMPR1 |= 7UL << (3 * (channel - 10));
+    }
+
+    // Single conversion in the regular sequence
+    adc->SQR1 = 0;
+    adc->SQR3 = channel;
+    adc->CR2 |= ADC_CR2_ADON;
+}
+
+/**
+ * @brief Start simultaneous sampling on 2 or 3 ADCs
+ * @param channels: Channel per ADC (channels[0] on ADC1, [1] on ADC2, [2] on ADC3)
+ * @param count: 2 (dual mode) or 3 (triple mode)
+ * @return 0 on success, -1 on invalid arguments
+ *
+ * Channels 0-7 are taken to be on PA0-PA7 and are switched to analog mode.
+ */
+int ADC_Multi_Init(const uint8_t *channels, uint8_t count)
+{
+    ADC_TypeDef *adcs[ADC_MULTI_MAX_ADCS] = { ADC1, ADC2, ADC3 };
+
+    if (count < 2 || count > ADC_MULTI_MAX_ADCS) return -1;
+
+    // Clocks
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_DMA2EN;
+    RCC->APB2ENR |= RCC_APB2ENR_ADC1EN | RCC_APB2ENR_ADC2EN;
+    if (count == 3) RCC->APB2ENR |= RCC_APB2ENR_ADC3EN;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (channels[i] > 15) return -1;
+        if (channels[i] < 8) GPIOA->MODER |= 3UL << (2 * channels[i]); // Analog mode
+        ADC_Multi_Channel_Init(adcs[i], channels[i]);
+    }
+
+    // DMA2 Stream0, channel 0 (ADC1): common data register -> circular ring
+    DMA2_Stream0->CR &= ~DMA_SxCR_EN;
+    DMA2_Stream0->PAR = (addr_reg_t)(uintptr_t)&ADC123_COMMON->CDR;
+    DMA2_Stream0->M0AR = (addr_reg_t)(uintptr_t)adc_multi_ring;
+    if (count == 2)
+    {
+        DMA2_Stream0->NDTR = ADC_MULTI_DEPTH;
+        DMA2_Stream0->CR = (0UL << DMA_SxCR_CHSEL_Pos) |
+                           (DMA_SxCR_SIZE_32 << DMA_SxCR_MSIZE_Pos) |
+                           (DMA_SxCR_SIZE_32 << DMA_SxCR_PSIZE_Pos) |
+                           DMA_SxCR_MINC | DMA_SxCR_CIRC;
+    }
+    else
+    {
+        DMA2_Stream0->NDTR = ADC_MULTI_DEPTH * 3;
+        DMA2_Stream0->CR = (0UL << DMA_SxCR_CHSEL_Pos) |
+                           (DMA_SxCR_SIZE_16 << DMA_SxCR_MSIZE_Pos) |
+                           (DMA_SxCR_SIZE_16 << DMA_SxCR_PSIZE_Pos) |
+                           DMA_SxCR_MINC | DMA_SxCR_CIRC;
+    }
+    DMA2_Stream0->CR |= DMA_SxCR_EN;
+
+    // Regular simultaneous mode, continuous DMA requests
+    ADC123_COMMON->CCR &= ~(ADC_CCR_MULTI | ADC_CCR_DMA);
+    ADC123_COMMON->CCR |= ADC_CCR_DDS |
+                          ((count == 2) ? (ADC_CCR_MULTI_DUAL_REGSIMULT | ADC_CCR_DMA_MODE2)
+                                        : (ADC_CCR_MULTI_TRIPLE_REGSIMULT | ADC_CCR_DMA_MODE1));
+    adc_multi_count = count;
+
+    // Master runs continuously; slaves convert in lock-step with it
+    ADC1->CR2 |= ADC_CR2_CONT;
+    ADC1->CR2 |= ADC_CR2_SWSTART;
+
+    return 0;
+}
+
+/**
+ * @brief Most recent complete time-aligned record
+ * @param record: Destination (unused entries are zero)
+ * @return 0 on success, -1 if simultaneous sampling is not running
+ *
+ * Before the first conversion completes the record reads as zeros.
+ */
+int ADC_Multi_Latest(ADC_Multi_Record *record)
+{
+    uint32_t total = (adc_multi_count == 2) ? ADC_MULTI_DEPTH : ADC_MULTI_DEPTH * 3;
+    uint32_t remaining = DMA2_Stream0->NDTR;
+
+    if (adc_multi_count == 0 || remaining == 0 || remaining > total) return -1;
+
+    // Next transfer index; NDTR counts down and reloads in circular mode
+    uint32_t next = total - remaining;
+
+    if (adc_multi_count == 2)
+    {
+        // One word per record, written atomically by the DMA
+        uint32_t word = adc_multi_ring[(next + ADC_MULTI_DEPTH - 1) % ADC_MULTI_DEPTH];
+        record->value[0] = (uint16_t)(word & 0xFFFF);
+        record->value[1] = (uint16_t)(word >> 16);
+        record->value[2] = 0;
+    }
+    else
+    {
+        // Last record whose three half-words have all been written
+        const uint16_t *halves = (const uint16_t *)adc_multi_ring;
+        uint32_t slot = (next / 3 + ADC_MULTI_DEPTH - 1) % ADC_MULTI_DEPTH;
+        record->value[0] = halves[slot * 3 + 0];
+        record->value[1] = halves[slot * 3 + 1];
+        record->value[2] = halves[slot * 3 + 2];
+    }
+
+    return 0;
+}
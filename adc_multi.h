@@ -0,0 +1,31 @@
+/**
+ * @file adc_multi.h
+ * @brief Simultaneous dual/triple ADC sampling of paired sensor channels
+ * @description ADC1 (master) and ADC2/ADC3 (slaves) run in regular
+ *              simultaneous mode, so paired channels (e.g. inlet/outlet
+ *              temperature) are sampled at the same instant instead of one
+ *              scan slot apart. One DMA stream (DMA2 Stream0) moves the
+ *              results from the common data register into a circular buffer.
+ *
+ * Dual mode uses DMA mode 2: each transfer is one 32-bit word holding
+ * ADC2 (high half-word) and ADC1 (low half-word) from the same conversion.
+ * Triple mode uses DMA mode 1: three consecutive half-words per conversion.
+ */
+
+#ifndef ADC_MULTI_H
+#define ADC_MULTI_H
+
+#include <stdint.h>
+
+#define ADC_MULTI_MAX_ADCS     3
+#define ADC_MULTI_DEPTH        16  // Records kept in the DMA ring
+
+// One time-aligned record: value[i] was converted by ADC(i+1) at the same instant
+typedef struct {
+    uint16_t value[ADC_MULTI_MAX_ADCS];
+} ADC_Multi_Record;
+
+int ADC_Multi_Init(const uint8_t *channels, uint8_t count);
+int ADC_Multi_Latest(ADC_Multi_Record *record);
+
+#endif /* ADC_MULTI_H */
@@ -0,0 +1,82 @@
+/**
+ * @file anomaly.c
+ * @brief Streaming change detector (CUSUM + rolling z-score) per sensor channel
+ */
+
+#include "anomaly.h"
+#include <string.h>
+
+/**
+ * @brief Reset detector state
+ * @param state: Channel state
+ */
+void Anomaly_Init(Anomaly_State *state)
+{
+    memset(state, 0, sizeof(*state));
+}
+
+/**
+ * @brief Feed one raw ADC reading
+ * @param state: Channel state
+ * @param cfg: Detector configuration
+ * @param adc_value: ADC reading (0-4095)
+ * @return ANOMALY_NONE, or the event detected on this sample
+ */
+int Anomaly_Update(Anomaly_State *state, const Anomaly_Config *cfg, uint16_t adc_value)
+{
+    // Decimate by block averaging
+    state->accum += adc_value;
+    if (++state->count < cfg->decimation) return ANOMALY_NONE;
+
+    int32_t x_q8 = (state->accum << 8) / (int32_t)state->count;
+    state->accum = 0;
+    state->count = 0;
+
+    // First sample seeds the running mean
+    if (state->trained == 0)
+    {
+        state->mean_q8 = x_q8;
+        state->var_q8 = cfg->var_floor_q8;
+        state->trained = 1;
+        return ANOMALY_NONE;
+    }
+
+    int32_t residual_q8 = x_q8 - state->mean_q8;
+    int64_t residual_sq_q16 = (int64_t)residual_q8 * residual_q8;
+    uint32_t var_q8 = (state->var_q8 > cfg->var_floor_q8) ? state->var_q8 : cfg->var_floor_q8;
+    int event = ANOMALY_NONE;
+
+    if (state->trained >= cfg->warmup)
+    {
+        // Rolling z-score: |x - mean| > z * sigma, compared squared (no sqrt)
+        int64_t limit_q16 = (int64_t)cfg->z_limit * cfg->z_limit * ((int64_t)var_q8 << 8);
+
+        // Two-sided CUSUM on the residual
+        state->cusum_pos_q8 += residual_q8 - cfg->cusum_k_q8;
+        if (state->cusum_pos_q8 < 0) state->cusum_pos_q8 = 0;
+        state->cusum_neg_q8 -= residual_q8 + cfg->cusum_k_q8;
+        if (state->cusum_neg_q8 < 0) state->cusum_neg_q8 = 0;
+
+        // A jump also pushes the CUSUM over, so report it as a spike first
+        if (residual_sq_q16 > limit_q16) event = ANOMALY_SPIKE;
+        else if (state->cusum_pos_q8 > cfg->cusum_h_q8) event = ANOMALY_DRIFT_UP;
+        else if (state->cusum_neg_q8 > cfg->cusum_h_q8) event = ANOMALY_DRIFT_DOWN;
+
+        if (event != ANOMALY_NONE)
+        {
+            state->cusum_pos_q8 = 0;
+            state->cusum_neg_q8 = 0;
+        }
+    }
+    else
+    {
+        state->trained++;
+    }
+
+    // Update running mean and variance (exponentially weighted)
+    state->mean_q8 += residual_q8 >> cfg->ewma_shift;
+    int64_t var_delta = (residual_sq_q16 >> 8) - (int64_t)state->var_q8;
+    state->var_q8 = (uint32_t)((int64_t)state->var_q8 + (var_delta >> cfg->ewma_shift));
+
+    return event;
+}
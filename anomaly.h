@@ -0,0 +1,51 @@
+/**
+ * @file anomaly.h
+ * @brief Streaming change detector (CUSUM + rolling z-score) per sensor channel
+ * @description O(1) work per ADC sample and six words of state per channel.
+ *
+ * Raw readings are block-averaged by `decimation`, then each decimated sample
+ * is compared against an exponentially weighted running mean/variance:
+ *   - two-sided CUSUM of the residual catches slow drifts that are too
+ *     gradual to be heard as a pitch change
+ *   - the z-score test catches sudden jumps relative to the recent noise
+ * All arithmetic is fixed point (ADC counts in Q8).
+ */
+
+#ifndef ANOMALY_H
+#define ANOMALY_H
+
+#include <stdint.h>
+
+// Detector events
+#define ANOMALY_NONE           0
+#define ANOMALY_DRIFT_UP       1
+#define ANOMALY_DRIFT_DOWN     2
+#define ANOMALY_SPIKE          3
+
+typedef struct {
+    uint16_t decimation;    // Raw samples averaged per detector sample
+    uint8_t ewma_shift;     // Mean/variance time constant = 2^shift detector samples
+    uint8_t z_limit;        // Spike threshold in standard deviations
+    int32_t cusum_k_q8;     // CUSUM allowance (counts, Q8)
+    int32_t cusum_h_q8;     // CUSUM alarm threshold (counts, Q8)
+    uint32_t var_floor_q8;  // Minimum variance (counts^2, Q8), masks quantization
+    uint16_t warmup;        // Detector samples before alarms are enabled
+} Anomaly_Config;
+
+typedef struct {
+    int32_t accum;          // Decimation accumulator
+    uint16_t count;         // Raw samples in accumulator
+    uint16_t trained;       // Detector samples seen (saturates at warmup)
+    int32_t mean_q8;        // Running mean (counts, Q8)
+    uint32_t var_q8;        // Running variance (counts^2, Q8)
+    int32_t cusum_pos_q8;   // Upper CUSUM statistic
+    int32_t cusum_neg_q8;   // Lower CUSUM statistic
+} Anomaly_State;
+
+// 100 ms main loop: 1 s detector samples, ~1 min memory, 2 counts allowance
+#define ANOMALY_CONFIG_DEFAULT { 10, 6, 5, 2 * 256, 40 * 256, 4 * 256, 64 }
+
+void Anomaly_Init(Anomaly_State *state);
+int Anomaly_Update(Anomaly_State *state, const Anomaly_Config *cfg, uint16_t adc_value);
+
+#endif /* ANOMALY_H */
@@ -0,0 +1,108 @@
+/**
+ * @file autorange.c
+ * @brief Sliding-window min/max (monotonic deques) and ADC span selection
+ */
+
+#include "autorange.h"
+#include "pipeline.h"
+#include <stdlib.h>
+
+#define AUTORANGE_MASK         (AUTORANGE_MAX_WINDOW - 1)
+
+/**
+ * @brief Reset to the full ADC span with an empty window
+ * @param state: Auto-ranging state
+ */
+void Autorange_Init(Autorange_State *state)
+{
+    state->low.head = 0;
+    state->low.count = 0;
+    state->high.head = 0;
+    state->high.count = 0;
+    state->readings = 0;
+    state->since = 0;
+    state->adc_low = 0;
+    state->adc_high = PIPELINE_ADC_MAX;
+}
+
+/**
+ * @brief Add a reading to one monotonic deque
+ * @param dq: Deque
+ * @param value: Reading
+ * @param now: Reading number
+ * @param window: Window length in readings
+ * @param is_max: Nonzero for the maximum deque, zero for the minimum
+ */
+static void Autorange_Push(Autorange_Deque *dq, uint16_t value, uint16_t now, uint16_t window, int is_max)
+{
+    // Readings are numbered consecutively, so at most the front expires
+    if (dq->count > 0 && (uint16_t)(now - dq->index[dq->head]) >= window)
+    {
+        dq->head = (dq->head + 1) & AUTORANGE_MASK;
+        dq->count--;
+    }
+
+    // Entries the new reading dominates can never be the extreme again
+    while (dq->count > 0)
+    {
+        uint16_t back = dq->value[(dq->head + dq->count - 1) & AUTORANGE_MASK];
+        if (is_max ? back > value : back < value) break;
+        dq->count--;
+    }
+
+    uint16_t slot = (dq->head + dq->count) & AUTORANGE_MASK;
+    dq->value[slot] = value;
+    dq->index[slot] = now;
+    dq->count++;
+}
+
+/**
+ * @brief Feed one filtered reading
+ * @param state: Auto-ranging state
+ * @param cfg: Auto-ranging configuration
+ * @param adc_value: Filtered ADC reading (0-4095)
+ * @return 1 if state->adc_low/adc_high changed and the map must be updated, else 0
+ */
+int Autorange_Update(Autorange_State *state, const Autorange_Config *cfg, uint16_t adc_value)
+{
+    uint16_t now = state->readings++;
+
+    Autorange_Push(&state->low, adc_value, now, cfg->window, 0);
+    Autorange_Push(&state->high, adc_value, now, cfg->window, 1);
+
+    if (++state->since < cfg->interval) return 0;
+    state->since = 0;
+
+    // Observed range plus headroom, widened to the minimum span
+    int32_t low = state->low.value[state->low.head];
+    int32_t high = state->high.value[state->high.head];
+    int32_t margin = (high - low) >> AUTORANGE_MARGIN_SHIFT;
+    low -= margin;
+    high += margin;
+    if (high - low < cfg->min_span)
+    {
+        low = (low + high - cfg->min_span) / 2;
+        high = low + cfg->min_span;
+    }
+
+    // Slide back inside the ADC range
+    if (low < 0)
+    {
+        high -= low;
+        low = 0;
+    }
+    if (high > PIPELINE_ADC_MAX)
+    {
+        low -= high - PIPELINE_ADC_MAX;
+        high = PIPELINE_ADC_MAX;
+        if (low < 0) low = 0;
+    }
+
+    // Small moves are not worth a table rebuild
+    int32_t slack = (state->adc_high - state->adc_low) >> AUTORANGE_MARGIN_SHIFT;
+    if (abs(low - state->adc_low) <= slack && abs(high - state->adc_high) <= slack) return 0;
+
+    state->adc_low = (uint16_t)low;
+    state->adc_high = (uint16_t)high;
+    return 1;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file autorange.h
+ * @brief Auto-ranging of the ADC span mapped onto the pitch range
+ * @description Tracks the minimum and maximum filtered reading over a sliding
+ *              window and proposes the ADC span (Pipeline_Config adc_low /
+ *              adc_high) that makes the observed range cover the whole pitch
+ *              range, so a sensor that only moves over a few dozen counts
+ *              still sweeps 200-2000 Hz.
+ *
+ * Window extremes come from two monotonic deques (increasing values for the
+ * minimum, decreasing for the maximum): each reading is pushed once and
+ * popped at most once, so an update is O(1) amortised and the extremes are
+ * the deque fronts.
+ *
+ * The span is re-evaluated only every `interval` readings and only adopted
+ * when an end moved by more than 1/8 of the current span, because each
+ * change costs a rebuild of the DDS increment table. The proposed span
+ * leaves 1/8 of the observed range as headroom on both sides and is never
+ * narrower than `min_span`, so ADC noise on a steady sensor is not blown up
+ * to the full pitch range.
+ */
+
+#ifndef AUTORANGE_H
+#define AUTORANGE_H
+
+#include <stdint.h>
+
+#define AUTORANGE_MAX_WINDOW   512  // Readings per window (power of two)
+#define AUTORANGE_MARGIN_SHIFT 3    // Headroom and hysteresis: span / 8
+
+typedef struct {
+    uint16_t window;        // Readings in the sliding window (<= AUTORANGE_MAX_WINDOW)
+    uint16_t interval;      // Readings between span updates (rebuild rate limit)
+    uint16_t min_span;      // Narrowest ADC span mapped onto the pitch range (>= 1)
+} Autorange_Config;
+
+typedef struct {
+    uint16_t value[AUTORANGE_MAX_WINDOW];
+    uint16_t index[AUTORANGE_MAX_WINDOW];  // Reading number (wraps at 65536)
+    uint16_t head;          // Ring slot of the front (the window extreme)
+    uint16_t count;
+} Autorange_Deque;
+
+typedef struct {
+    Autorange_Deque low;    // Increasing values: front is the window minimum
+    Autorange_Deque high;   // Decreasing values: front is the window maximum
+    uint16_t readings;      // Number of the next reading (wraps)
+    uint16_t since;         // Readings since the last span update
+    uint16_t adc_low;       // Span currently proposed
+    uint16_t adc_high;
+} Autorange_State;
+
+// 100 ms main loop: 30 s window, span revisited every 5 s, at least 32 counts (~0.8 C)
+#define AUTORANGE_CONFIG_DEFAULT { 300, 50, 32 }
+
+void Autorange_Init(Autorange_State *state);
+int Autorange_Update(Autorange_State *state, const Autorange_Config *cfg, uint16_t adc_value);
+
+#endif /* AUTORANGE_H */
@@ -0,0 +1,382 @@
+/**
+ * @file bench.c
+ * @brief On-device kernel benchmark mode
+ */
+
+#include "stm32f4xx.h"
+#include "config.h"
+#include "bench.h"
+#include "pipeline.h"
+#include "packed12.h"
+#include "uart.h"
+#if FEATURE_ANOMALY
+#include "anomaly.h"
+#endif
+#if FEATURE_POLICY
+#include "policy.h"
+#endif
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+#include "dds.h"
+#endif
+#if FEATURE_MULTIRATE
+#include "multirate.h"
+#endif
+#if FEATURE_LAG
+#include "lag.h"
+#endif
+#if FEATURE_FFT
+#include "fft.h"
+#endif
+#if FEATURE_AUTORANGE
+#include "autorange.h"
+#endif
+#if FEATURE_LIMITER
+#include "limiter.h"
+#endif
+
+#ifdef HOST_SIMULATION
+#include <time.h>
+#define BENCH_UNIT             "ns"
+#else
+#define BENCH_UNIT             "cycles"
+#endif
+
+#define BENCH_BLOCK            64  // Samples per block for block kernels
+
+// Keeps kernel results alive so the compiler cannot drop the work
+static volatile uint32_t bench_sink;
+
+/**
+ * @brief Cycle counter
+ */
+static inline uint32_t Bench_Now(void)
+{
+#ifdef HOST_SIMULATION
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+/**
+ * @brief Test input: deterministic pseudo-random ADC readings
+ */
+static inline uint16_t Bench_Input(uint32_t i)
+{
+    return (uint16_t)((i * 2654435761UL) >> 20);
+}
+
+/* ---------------------------------------------------------------- kernels */
+
+static uint32_t Bench_Empty(uint32_t iterations)
+{
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) acc += Bench_Input(i);
+    return acc;
+}
+
+static uint32_t Bench_Pipeline_Map(uint32_t iterations)
+{
+    const Pipeline_Config cfg = PIPELINE_CONFIG_DEFAULT;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) acc += Pipeline_Map(&cfg, Bench_Input(i));
+    return acc;
+}
+
+static uint32_t Bench_Pipeline_Step(uint32_t iterations)
+{
+    // Filter and glide active (when compiled in)
+    Pipeline_Config cfg = PIPELINE_CONFIG_DEFAULT;
+    Pipeline_State state;
+    uint32_t acc = 0;
+
+    cfg.filter_alpha = PIPELINE_Q16_ONE / 8;
+    cfg.glide_alpha = PIPELINE_Q16_ONE / 4;
+    Pipeline_Init(&state, &cfg, 440);
+    for (uint32_t i = 0; i < iterations; i++) acc += (uint32_t)Pipeline_Step(&state, &cfg, Bench_Input(i));
+    return acc + state.frequency;
+}
+
+#if FEATURE_ANOMALY
+static uint32_t Bench_Anomaly_Update(uint32_t iterations)
+{
+    const Anomaly_Config cfg = ANOMALY_CONFIG_DEFAULT;
+    Anomaly_State state;
+    uint32_t acc = 0;
+
+    Anomaly_Init(&state);
+    for (uint32_t i = 0; i < iterations; i++) acc += (uint32_t)Anomaly_Update(&state, &cfg, 2000 + (Bench_Input(i) & 15));
+    return acc;
+}
+#endif
+
+#if FEATURE_AUTORANGE
+static Autorange_State bench_autorange;
+
+static uint32_t Bench_Autorange_Update(uint32_t iterations)
+{
+    const Autorange_Config cfg = AUTORANGE_CONFIG_DEFAULT;
+    uint32_t acc = 0;
+
+    Autorange_Init(&bench_autorange);
+    for (uint32_t i = 0; i < iterations; i++) acc += (uint32_t)Autorange_Update(&bench_autorange, &cfg, 2000 + (Bench_Input(i) & 63));
+    return acc + bench_autorange.adc_low;
+}
+#endif
+
+#if FEATURE_POLICY
+extern Policy_Table policy_table;  // Compiled by App_Init()
+
+static uint32_t Bench_Policy_Evaluate(uint32_t iterations)
+{
+    uint8_t zone = 0;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        zone = Policy_Evaluate(&policy_table, zone, Bench_Input(i));
+        acc += zone;
+    }
+    return acc;
+}
+#endif
+
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+extern uint32_t tone_increments[];  // Built by App_Init()
+
+static uint32_t Bench_Tone_Increment_Divide(uint32_t iterations)
+{
+    const Pipeline_Config cfg = PIPELINE_CONFIG_DEFAULT;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) acc += DDS_Increment(Pipeline_Map(&cfg, Bench_Input(i)), DDS_SAMPLE_RATE);
+    return acc;
+}
+
+static uint32_t Bench_Tone_Increment_Table(uint32_t iterations)
+{
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) acc += tone_increments[Bench_Input(i) & PIPELINE_ADC_MAX];
+    return acc;
+}
+
+// Full table rebuild (once per pitch range or mapped span change)
+extern Pipeline_Config pipeline_config;
+
+static uint32_t Bench_Tone_Table_Build(uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++) Pipeline_Build_Increment_Table(&pipeline_config, DDS_SAMPLE_RATE, tone_increments);
+    return tone_increments[7];
+}
+#endif
+
+#if FEATURE_LIMITER
+// Two full-scale voices (440 Hz + 660 Hz) summed, twice the DAC range
+static int32_t bench_mix[BENCH_BLOCK];
+
+static uint32_t Bench_Limiter_Process(uint32_t iterations)
+{
+    const Limiter_Config cfg = LIMITER_CONFIG_DEFAULT;
+    Limiter_State state;
+    uint32_t acc = 0;
+
+    for (uint32_t i = 0; i < BENCH_BLOCK; i++)
+    {
+        bench_mix[i] = (DDS_Sine(i * DDS_Increment(440, DDS_SAMPLE_RATE)) * 2047 >> 15)
+                     + (DDS_Sine(i * DDS_Increment(660, DDS_SAMPLE_RATE)) * 2047 >> 15);
+    }
+    Limiter_Init(&state);
+    for (uint32_t i = 0; i < iterations; i++) acc += (uint32_t)Limiter_Process(&state, &cfg, bench_mix[i % BENCH_BLOCK]);
+    return acc;
+}
+#endif
+
+static uint16_t bench_samples[BENCH_BLOCK];
+static uint8_t bench_packed[PACKED12_BYTES(BENCH_BLOCK)];
+
+static uint32_t Bench_Packed12_Pack(uint32_t iterations)
+{
+    for (uint32_t i = 0; i < BENCH_BLOCK; i++) bench_samples[i] = Bench_Input(i);
+    for (uint32_t i = 0; i < iterations; i++) Packed12_Pack(bench_packed, 0, bench_samples, BENCH_BLOCK);
+    return bench_packed[7];
+}
+
+static uint32_t Bench_Packed12_Unpack(uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++) Packed12_Unpack(bench_samples, bench_packed, 0, BENCH_BLOCK);
+    return bench_samples[5];
+}
+
+#if FEATURE_MULTIRATE
+// 8 kHz -> 1 kHz -> 8 kHz: one decimator and one interpolator link
+static Multirate_Chain bench_chain;
+
+static uint32_t Bench_Multirate_Batch(uint32_t iterations)
+{
+    static const Multirate_Stage stages[] = {
+        { "acquire", 8000, 0, 0 },
+        { "control", 1000, 0, 0 },
+        { "audio",   8000, 0, 0 },
+    };
+
+    if (bench_chain.stage_count == 0) Multirate_Init(&bench_chain, stages, 3, BENCH_BLOCK);
+    for (uint32_t i = 0; i < BENCH_BLOCK; i++) bench_samples[i] = Bench_Input(i) & PIPELINE_ADC_MAX;
+    for (uint32_t i = 0; i < iterations; i++) Multirate_Push(&bench_chain, (const int16_t *)bench_samples, BENCH_BLOCK);
+    return (uint16_t)bench_chain.buffer[2][3];
+}
+#endif
+
+#if FEATURE_LAG
+// One full lag estimate with the default window (64 samples, 33 lags)
+static Lag_State bench_lag;
+
+static uint32_t Bench_Lag_Correlate(uint32_t iterations)
+{
+    const Lag_Config cfg = LAG_CONFIG_DEFAULT;
+    uint32_t acc = 0;
+
+    if (bench_lag.count < LAG_RING)
+    {
+        Lag_Init(&bench_lag);
+        for (uint32_t i = 0; i < LAG_RING; i++)
+        {
+            // Downstream follows upstream by 5 samples
+            Lag_Update(&bench_lag, &cfg, Bench_Input(i + 5) & PIPELINE_ADC_MAX, Bench_Input(i) & PIPELINE_ADC_MAX);
+        }
+    }
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        Lag_Correlate(&bench_lag, &cfg);
+        acc += (uint32_t)bench_lag.lag_q8;
+    }
+    return acc;
+}
+#endif
+
+#if FEATURE_FFT
+// 256-point Q15 real FFT (plan built on first use)
+static Fft_Q15_Plan bench_fft;
+static int16_t bench_fft_in[256];
+static int16_t bench_fft_re[129], bench_fft_im[129];
+
+static uint32_t Bench_Fft_Q15(uint32_t iterations)
+{
+    if (bench_fft.n == 0)
+    {
+        Fft_Q15_Init(&bench_fft, 256);
+        for (uint32_t i = 0; i < 256; i++) bench_fft_in[i] = (int16_t)((Bench_Input(i) & PIPELINE_ADC_MAX) - 2048);
+    }
+    for (uint32_t i = 0; i < iterations; i++) Fft_Q15_Real(&bench_fft, bench_fft_in, bench_fft_re, bench_fft_im);
+    return (uint16_t)bench_fft_re[3];
+}
+#endif
+
+// Kernel table; block kernels report cost per BENCH_BLOCK-sample block
+static const Bench_Kernel bench_kernels[] = {
+    { "pipeline_map",      Bench_Pipeline_Map },
+    { "pipeline_step",     Bench_Pipeline_Step },
+#if FEATURE_ANOMALY
+    { "anomaly_update",    Bench_Anomaly_Update },
+#endif
+#if FEATURE_AUTORANGE
+    { "autorange_update",  Bench_Autorange_Update },
+#endif
+#if FEATURE_POLICY
+    { "policy_evaluate",   Bench_Policy_Evaluate },
+#endif
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+    { "tone_increment_divide", Bench_Tone_Increment_Divide },
+    { "tone_increment_table", Bench_Tone_Increment_Table },
+    { "tone_table_build",  Bench_Tone_Table_Build },
+#endif
+#if FEATURE_LIMITER
+    { "limiter_process",   Bench_Limiter_Process },
+#endif
+    { "packed12_pack_64",  Bench_Packed12_Pack },
+    { "packed12_unpack_64", Bench_Packed12_Unpack },
+#if FEATURE_MULTIRATE
+    { "multirate_batch_64", Bench_Multirate_Batch },
+#endif
+#if FEATURE_LAG
+    { "lag_correlate",     Bench_Lag_Correlate },
+#endif
+#if FEATURE_FFT
+    { "fft_q15_256",       Bench_Fft_Q15 },
+#endif
+};
+
+/* ----------------------------------------------------------------- report */
+
+/**
+ * @brief Check the benchmark strap (PA6 pulled high at boot)
+ * @return 1 if benchmark mode is requested
+ */
+int Bench_Requested(void)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
+    GPIOA->MODER &= ~GPIO_MODER_MODER6;                                 // Input
+    GPIOA->PUPDR = (GPIOA->PUPDR & ~GPIO_PUPDR_PUPDR6) | GPIO_PUPDR_PUPDR6_1;
+
+    // Let the pull-down settle
+    for (volatile uint32_t i = 0; i < 1000; i++);
+
+    return (GPIOA->IDR & GPIO_IDR_IDR6) != 0;
+}
+
+/**
+ * @brief Run every kernel and stream the report
+ */
+void Bench_Run(void)
+{
+    UART_Init();
+
+    // Enable the DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA;
+
+    // Loop overhead, subtracted from every kernel
+    __disable_irq();
+    uint32_t start = Bench_Now();
+    bench_sink = Bench_Empty(BENCH_ITERATIONS);
+    uint32_t overhead = Bench_Now() - start;
+    __enable_irq();
+
+    UART_Puts("# bench version=1 board=" BENCH_BOARD " core_hz=");
+    UART_Put_Uint(BENCH_CORE_HZ);
+    UART_Puts(" flash_ws=");
+    UART_Put_Uint(FLASH->ACR & FLASH_ACR_LATENCY);
+    UART_Puts(" unit=" BENCH_UNIT " profile=" PROFILE_NAME "\n");
+    UART_Puts("kernel,iterations,total,per_iteration\n");
+
+    for (uint32_t k = 0; k < sizeof(bench_kernels) / sizeof(bench_kernels[0]); k++)
+    {
+        // Warm-up pass (caches, flash prefetch), then the timed pass. The
+        // DDS sample ISR and the profiler sampler would be counted in the
+        // kernel, so both passes run with interrupts masked.
+        __disable_irq();
+        bench_sink = bench_kernels[k].run(BENCH_ITERATIONS / 8);
+        start = Bench_Now();
+        bench_sink = bench_kernels[k].run(BENCH_ITERATIONS);
+        uint32_t total = Bench_Now() - start;
+        __enable_irq();
+        total = (total > overhead) ? total - overhead : 0;
+
+        // per_iteration with two decimals, integer arithmetic only
+        uint32_t per_x100 = (uint32_t)(((uint64_t)total * 100) / BENCH_ITERATIONS);
+
+        UART_Puts(bench_kernels[k].name);
+        UART_Putc(',');
+        UART_Put_Uint(BENCH_ITERATIONS);
+        UART_Putc(',');
+        UART_Put_Uint(total);
+        UART_Putc(',');
+        UART_Put_Uint(per_x100 / 100);
+        UART_Putc('.');
+        UART_Putc((char)('0' + (per_x100 / 10) % 10));
+        UART_Putc((char)('0' + per_x100 % 10));
+        UART_Putc('\n');
+    }
+
+    UART_Puts("# end\n");
+}
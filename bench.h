@@ -0,0 +1,48 @@
+/**
+ * @file bench.h
+ * @brief On-device kernel benchmark mode
+ * @description Runs each processing kernel for a fixed number of iterations,
+ *              timing it with the DWT cycle counter, and streams a CSV report
+ *              over USART2 (PA2, 115200 8N1).
+ *
+ * Selected at boot by strapping PA6 high (it has a pull-down). The report
+ * starts with a "# bench" line naming the board, core clock and flash wait
+ * states, so runs on different boards can be compared directly:
+ *
+ *   # bench version=1 board=STM32F4 core_hz=84000000 flash_ws=2 unit=cycles profile=full
+ *   kernel,iterations,total,per_iteration
+ *   pipeline_map,1024,12345,12.05
+ *   ...
+ *   # end
+ *
+ * The empty-loop overhead is measured first and subtracted from every
+ * kernel. Interrupts are masked while a kernel is timed, so the 32 kHz DDS
+ * sample interrupt and the profiler sampler are not counted in it (the
+ * tone stalls for up to ~0.1 s per kernel). In the host simulation the
+ * unit is host nanoseconds instead of cycles and the report goes to stdout.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+#define BENCH_ITERATIONS       1024
+
+#ifndef BENCH_BOARD
+#define BENCH_BOARD            "STM32F4"
+#endif
+#ifndef BENCH_CORE_HZ
+#define BENCH_CORE_HZ          84000000UL
+#endif
+
+// One benchmarked kernel: runs `iterations` calls, returns a checksum
+typedef struct {
+    const char *name;
+    uint32_t (*run)(uint32_t iterations);
+} Bench_Kernel;
+
+int Bench_Requested(void);
+void Bench_Run(void);
+
+#endif /* BENCH_H */
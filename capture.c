@@ -0,0 +1,182 @@
+/**
+ * @file capture.c
+ * @brief Pre-trigger capture of raw ADC history around anomaly events
+ */
+
+#include "capture.h"
+#include "uart.h"
+#include <stddef.h>
+
+/**
+ * @brief Start recording into the first region
+ * @param cap: Capture state
+ */
+void Capture_Init(Capture_State *cap)
+{
+    for (uint32_t i = 0; i < CAPTURE_REGIONS; i++) cap->region[i].state = CAPTURE_FREE;
+    cap->active = &cap->region[0];
+    cap->active->state = CAPTURE_RECORDING;
+    cap->head = 0;
+    cap->count = 0;
+    cap->post_left = 0;
+    cap->dropped = 0;
+    cap->sending = NULL;
+    cap->cursor = 0;
+}
+
+/**
+ * @brief A free region other than the active one
+ */
+static Capture_Region *Capture_Free_Region(Capture_State *cap)
+{
+    for (uint32_t i = 0; i < CAPTURE_REGIONS; i++)
+    {
+        if (cap->region[i].state == CAPTURE_FREE) return &cap->region[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Record one reading of every channel
+ * @param cap: Capture state
+ * @param values: CAPTURE_CHANNELS readings (0-4095)
+ * @return 1 if this reading completed a capture (a region was frozen), else 0
+ */
+int Capture_Record(Capture_State *cap, const uint16_t *values)
+{
+    Capture_Region *region = cap->active;
+
+    for (uint32_t ch = 0; ch < CAPTURE_CHANNELS; ch++)
+    {
+        Packed12_Buffer ring = { region->data[ch], CAPTURE_DEPTH };
+        Packed12_Set(&ring, cap->head, values[ch]);
+    }
+    cap->head = (cap->head + 1 == CAPTURE_DEPTH) ? 0 : cap->head + 1;
+    if (cap->count < CAPTURE_DEPTH) cap->count++;
+
+    if (cap->post_left == 0 || --cap->post_left != 0) return 0;
+
+    // Freeze: hand the region over as is and record into a spare one
+    region->start = (cap->count == CAPTURE_DEPTH) ? cap->head : 0;
+    region->count = cap->count;
+    region->state = CAPTURE_FROZEN;
+
+    cap->active = Capture_Free_Region(cap);  // Reserved by Capture_Trigger()
+    cap->active->state = CAPTURE_RECORDING;
+    cap->head = 0;
+    cap->count = 0;
+    return 1;
+}
+
+/**
+ * @brief Mark an event; the reading recorded next is the event reading
+ * @param cap: Capture state
+ * @param event: Event code stored with the capture
+ * @param tick: Main loop tick of the event
+ * @return 1 if a capture started, 0 if one is already running (the event
+ *         falls inside its window), -1 if no region is free (dropped)
+ */
+int Capture_Trigger(Capture_State *cap, uint8_t event, uint32_t tick)
+{
+    if (cap->post_left != 0) return 0;
+    if (Capture_Free_Region(cap) == NULL)
+    {
+        cap->dropped++;
+        return -1;
+    }
+
+    cap->active->event = event;
+    cap->active->tick = tick;
+    cap->post_left = CAPTURE_POST;
+    return 1;
+}
+
+/**
+ * @brief Take ownership of the oldest frozen capture
+ * @param cap: Capture state
+ * @return Region (read-only until Capture_Release()), NULL if none
+ */
+Capture_Region *Capture_Take(Capture_State *cap)
+{
+    Capture_Region *oldest = NULL;
+
+    for (uint32_t i = 0; i < CAPTURE_REGIONS; i++)
+    {
+        Capture_Region *region = &cap->region[i];
+        if (region->state == CAPTURE_FROZEN && (oldest == NULL || region->tick < oldest->tick)) oldest = region;
+    }
+    if (oldest != NULL) oldest->state = CAPTURE_TAKEN;
+    return oldest;
+}
+
+/**
+ * @brief Give a taken region back for recording
+ */
+void Capture_Release(Capture_State *cap, Capture_Region *region)
+{
+    (void)cap;
+    region->state = CAPTURE_FREE;
+}
+
+/**
+ * @brief Reading of a captured region
+ * @param region: Frozen or taken region
+ * @param channel: Channel (< CAPTURE_CHANNELS)
+ * @param index: 0 = oldest reading, count - CAPTURE_POST = event reading
+ * @return 12-bit reading
+ */
+uint16_t Capture_Get(const Capture_Region *region, uint8_t channel, uint32_t index)
+{
+    uint32_t slot = region->start + index;
+    if (slot >= CAPTURE_DEPTH) slot -= CAPTURE_DEPTH;
+
+    const Packed12_Buffer ring = { (uint8_t *)region->data[channel], CAPTURE_DEPTH };
+    return Packed12_Get(&ring, slot);
+}
+
+/**
+ * @brief Stream frozen captures over USART2, CAPTURE_LINES_PER_POLL rows per call
+ * @param cap: Capture state
+ */
+void Capture_Poll(Capture_State *cap)
+{
+    if (cap->sending == NULL)
+    {
+        cap->sending = Capture_Take(cap);
+        if (cap->sending == NULL) return;
+        cap->cursor = 0;
+
+        UART_Puts("# capture version=1 event=");
+        UART_Put_Uint(cap->sending->event);
+        UART_Puts(" tick=");
+        UART_Put_Uint(cap->sending->tick);
+        UART_Puts(" channels=");
+        UART_Put_Uint(CAPTURE_CHANNELS);
+        UART_Puts(" pre=");
+        UART_Put_Uint(cap->sending->count - CAPTURE_POST);
+        UART_Puts(" post=");
+        UART_Put_Uint(CAPTURE_POST);
+        UART_Puts(" dropped=");
+        UART_Put_Uint(cap->dropped);
+        UART_Putc('\n');
+    }
+
+    Capture_Region *region = cap->sending;
+    for (uint32_t line = 0; line < CAPTURE_LINES_PER_POLL && cap->cursor < region->count; line++)
+    {
+        for (uint8_t ch = 0; ch < CAPTURE_CHANNELS; ch++)
+        {
+            if (ch != 0) UART_Putc(',');
+            UART_Put_Uint(Capture_Get(region, ch, cap->cursor));
+        }
+        UART_Putc('\n');
+        cap->cursor++;
+    }
+
+    if (cap->cursor == region->count)
+    {
+        UART_Puts("# end\n");
+        Capture_Release(cap, region);
+        cap->sending = NULL;
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file capture.h
+ * @brief Pre-trigger capture of raw ADC history around anomaly events
+ * @description Every reading of every channel goes into a circular buffer
+ *              (12-bit packed, see packed12.h). When an event fires the
+ *              capture keeps recording CAPTURE_POST more readings, then the
+ *              whole region is frozen: CAPTURE_PRE readings before the event
+ *              and CAPTURE_POST from it on.
+ *
+ * Hand-off is zero-copy. Freezing only swaps the recorder over to a free
+ * region; the frozen region is passed to the consumer (Capture_Take()) and
+ * returned with Capture_Release(). Capture_Poll() streams frozen regions
+ * over USART2 a few lines per call, so a report never stalls the main loop:
+ *
+ *   # capture version=1 event=3 tick=1234 channels=2 pre=100 post=50 dropped=0
+ *   2048,2051
+ *   ...                    (pre + post rows, row `pre` is the event reading)
+ *   # end
+ *
+ * The region swapped in after a capture starts empty, so an event less than
+ * CAPTURE_PRE readings after the previous capture has a shorter pre-trigger
+ * window (`pre` in the header). If an event fires while every spare region is
+ * still waiting to be shipped, it is counted in `dropped` and not captured.
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "packed12.h"
+
+// Temperature, plus the paired probe with the dual acquisition back-end
+#if ACQUISITION_BACKEND == ACQUISITION_DUAL
+#define CAPTURE_CHANNELS       2
+#else
+#define CAPTURE_CHANNELS       1
+#endif
+#define CAPTURE_PRE            100  // Readings kept before the event (10 s at 100 ms)
+#define CAPTURE_POST           50   // Readings recorded from the event on
+#define CAPTURE_DEPTH          (CAPTURE_PRE + CAPTURE_POST)
+#define CAPTURE_REGIONS        3    // One recording, the rest frozen or free
+#define CAPTURE_LINES_PER_POLL 8    // Report rows sent per Capture_Poll()
+
+// Region states
+#define CAPTURE_FREE           0
+#define CAPTURE_RECORDING      1
+#define CAPTURE_FROZEN         2
+#define CAPTURE_TAKEN          3
+
+typedef struct {
+    uint8_t data[CAPTURE_CHANNELS][PACKED12_BYTES(CAPTURE_DEPTH)];
+    uint32_t start;         // Ring index of the oldest reading
+    uint32_t count;         // Valid readings (CAPTURE_DEPTH unless captured early)
+    uint32_t tick;          // Tick of the event
+    uint8_t event;          // Event code (ANOMALY_*)
+    uint8_t state;          // CAPTURE_FREE ... CAPTURE_TAKEN
+} Capture_Region;
+
+typedef struct {
+    Capture_Region region[CAPTURE_REGIONS];
+    Capture_Region *active;     // Region being recorded
+    uint32_t head;              // Next ring index in the active region
+    uint32_t count;             // Valid readings in the active region
+    uint32_t post_left;         // Readings left after an event, 0 = armed
+    uint32_t dropped;           // Events lost (no free region)
+    Capture_Region *sending;    // Region being streamed by Capture_Poll()
+    uint32_t cursor;            // Next row of `sending`
+} Capture_State;
+
+void Capture_Init(Capture_State *cap);
+int Capture_Record(Capture_State *cap, const uint16_t *values);
+int Capture_Trigger(Capture_State *cap, uint8_t event, uint32_t tick);
+Capture_Region *Capture_Take(Capture_State *cap);
+void Capture_Release(Capture_State *cap, Capture_Region *region);
+uint16_t Capture_Get(const Capture_Region *region, uint8_t channel, uint32_t index);
+void Capture_Poll(Capture_State *cap);
+
+#endif /* CAPTURE_H */
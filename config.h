@@ -0,0 +1,221 @@
+/**
+ * @file config.h
+ * @brief Compile-time feature profiles
+ * @description A profile selects the acquisition, filter, alarm and output
+ *              back-ends at compile time. Disabled stages are removed by the
+ *              preprocessor, so a small board does not pay flash or cycles
+ *              for features it does not use.
+ *
+ * Select a profile with -DPROFILE_MINIMAL, -DPROFILE_STANDARD or
+ * -DPROFILE_FULL (default). Individual FEATURE_* / *_BACKEND settings can
+ * still be overridden on the command line after the profile is chosen.
+ * tools/profile_report.sh builds every profile and reports its size and
+ * per-sample cost.
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+// Acquisition back-ends
+#define ACQUISITION_SINGLE     0  // ADC1 channel 0, polled
+#define ACQUISITION_DUAL       1  // ADC1/ADC2 simultaneous pair via DMA (adc_multi.c)
+
+// Output back-ends
+#define OUTPUT_DAC_TRIANGLE    0  // DAC1 triangle generator clocked by TIM2 TRGO
+#define OUTPUT_BUZZER          1  // TIM2 CH1 50% PWM square wave on PA5
+#define OUTPUT_PIEZO_BRIDGE    2  // TIM1 CH1/CH1N complementary pair on PA8/PA7
+#define OUTPUT_DAC_DDS         3  // DAC1 sine samples from a DDS in the TIM2 update interrupt
+
+#if !defined(PROFILE_MINIMAL) && !defined(PROFILE_STANDARD) && !defined(PROFILE_FULL)
+#define PROFILE_FULL
+#endif
+
+#if defined(PROFILE_MINIMAL)
+// One sensor, square-wave buzzer, no processing beyond the linear map
+#define PROFILE_NAME           "minimal"
+#ifndef ACQUISITION_BACKEND
+#define ACQUISITION_BACKEND    ACQUISITION_SINGLE
+#endif
+#ifndef OUTPUT_BACKEND
+#define OUTPUT_BACKEND         OUTPUT_BUZZER
+#endif
+#ifndef FEATURE_FILTER
+#define FEATURE_FILTER         0
+#endif
+#ifndef FEATURE_ANOMALY
+#define FEATURE_ANOMALY        0
+#endif
+#ifndef FEATURE_CAPTURE
+#define FEATURE_CAPTURE        0
+#endif
+#ifndef FEATURE_LAG
+#define FEATURE_LAG            0
+#endif
+#ifndef FEATURE_POLICY
+#define FEATURE_POLICY         0
+#endif
+#ifndef FEATURE_GATED_CADENCE
+#define FEATURE_GATED_CADENCE  0
+#endif
+#ifndef FEATURE_BENCH
+#define FEATURE_BENCH          0
+#endif
+#ifndef FEATURE_FFT
+#define FEATURE_FFT            0
+#endif
+#ifndef FEATURE_MULTIRATE
+#define FEATURE_MULTIRATE      0
+#endif
+#ifndef FEATURE_LIMITER
+#define FEATURE_LIMITER        0
+#endif
+
+#elif defined(PROFILE_STANDARD)
+// One sensor, DAC output, filtering, alarm zones and benchmark mode
+#define PROFILE_NAME           "standard"
+#ifndef ACQUISITION_BACKEND
+#define ACQUISITION_BACKEND    ACQUISITION_SINGLE
+#endif
+#ifndef OUTPUT_BACKEND
+#define OUTPUT_BACKEND         OUTPUT_DAC_TRIANGLE
+#endif
+#ifndef FEATURE_FILTER
+#define FEATURE_FILTER         1
+#endif
+#ifndef FEATURE_ANOMALY
+#define FEATURE_ANOMALY        0
+#endif
+#ifndef FEATURE_CAPTURE
+#define FEATURE_CAPTURE        0
+#endif
+#ifndef FEATURE_LAG
+#define FEATURE_LAG            0
+#endif
+#ifndef FEATURE_POLICY
+#define FEATURE_POLICY         1
+#endif
+#ifndef FEATURE_GATED_CADENCE
+#define FEATURE_GATED_CADENCE  1  // Pulsed zones: TIM3 gates TIM2 in hardware
+#endif
+#ifndef FEATURE_BENCH
+#define FEATURE_BENCH          1
+#endif
+#ifndef FEATURE_FFT
+#define FEATURE_FFT            0
+#endif
+#ifndef FEATURE_MULTIRATE
+#define FEATURE_MULTIRATE      0
+#endif
+#ifndef FEATURE_LIMITER
+#define FEATURE_LIMITER        1  // Soft limiter on the DDS mix bus (limiter.c)
+#endif
+
+#else
+// Everything enabled
+#define PROFILE_NAME           "full"
+#ifndef ACQUISITION_BACKEND
+#define ACQUISITION_BACKEND    ACQUISITION_SINGLE
+#endif
+#ifndef OUTPUT_BACKEND
+#define OUTPUT_BACKEND         OUTPUT_DAC_TRIANGLE
+#endif
+#ifndef FEATURE_FILTER
+#define FEATURE_FILTER         1
+#endif
+#ifndef FEATURE_ANOMALY
+#define FEATURE_ANOMALY        1
+#endif
+#ifndef FEATURE_CAPTURE
+#define FEATURE_CAPTURE        1  // Raw history around anomaly events over USART2
+#endif
+#ifndef FEATURE_LAG
+#define FEATURE_LAG            1  // Probe-to-probe lag over USART2 (dual acquisition only)
+#endif
+#ifndef FEATURE_POLICY
+#define FEATURE_POLICY         1
+#endif
+#ifndef FEATURE_GATED_CADENCE
+#define FEATURE_GATED_CADENCE  1  // Pulsed zones: TIM3 gates TIM2 in hardware
+#endif
+#ifndef FEATURE_BENCH
+#define FEATURE_BENCH          1
+#endif
+#ifndef FEATURE_FFT
+#define FEATURE_FFT            1  // Q15 real FFT (fft.c) kernel in benchmark mode
+#endif
+#ifndef FEATURE_MULTIRATE
+#define FEATURE_MULTIRATE      1  // 1 kHz oversampled acquisition decimated to the 10 Hz loop (multirate.c)
+#endif
+#ifndef FEATURE_LIMITER
+#define FEATURE_LIMITER        1  // Soft limiter on the DDS mix bus (limiter.c)
+#endif
+#endif
+
+// Captures are triggered by the anomaly detector
+#if !FEATURE_ANOMALY
+#undef FEATURE_CAPTURE
+#define FEATURE_CAPTURE        0
+#endif
+
+// The lag estimate needs the paired probe
+#if ACQUISITION_BACKEND != ACQUISITION_DUAL
+#undef FEATURE_LAG
+#define FEATURE_LAG            0
+#endif
+
+// Oversampling reads ADC1 directly; the paired back-end delivers DMA records
+#if ACQUISITION_BACKEND == ACQUISITION_DUAL
+#undef FEATURE_MULTIRATE
+#define FEATURE_MULTIRATE      0
+#endif
+
+// The cadence gate only serves pulsed policy zones
+#if !FEATURE_POLICY
+#undef FEATURE_GATED_CADENCE
+#define FEATURE_GATED_CADENCE  0
+#endif
+
+// Gating TIM2 under the DDS back-end would stop the sample interrupt and
+// leave the DAC on an arbitrary sample; pulsed zones then use the software
+// cadence of Policy_Tone()
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+#undef FEATURE_GATED_CADENCE
+#define FEATURE_GATED_CADENCE  0
+#endif
+
+// Only the DDS back-end has a sample-rate mix bus to limit
+#if OUTPUT_BACKEND != OUTPUT_DAC_DDS
+#undef FEATURE_LIMITER
+#define FEATURE_LIMITER        0
+#endif
+
+// Auto-ranging, independent of the profile (off unless requested): absolute
+// pitch then no longer means absolute temperature and tools/decode cannot
+// invert recordings
+#ifndef FEATURE_AUTORANGE
+#define FEATURE_AUTORANGE      0  // Pitch range follows the observed temperature range (autorange.c)
+#endif
+
+// Setpoint beat mode, independent of the profile (off unless requested)
+#ifndef FEATURE_BEAT
+#define FEATURE_BEAT           0  // Reference tone at the setpoint pitch beats against the sensor tone
+#endif
+
+// The beat sums two DDS voices, which needs the mix-bus limiter
+#if !FEATURE_LIMITER
+#undef FEATURE_BEAT
+#define FEATURE_BEAT           0
+#endif
+
+// The beat rate only encodes the error under a fixed map
+#if FEATURE_BEAT
+#undef FEATURE_AUTORANGE
+#define FEATURE_AUTORANGE      0
+#endif
+
+// Development tools, independent of the profile (off unless requested)
+#ifndef FEATURE_PROFILER
+#define FEATURE_PROFILER       0  // PC-sampling profiler, report over USART2 (profiler.c)
+#endif
+
+#endif /* CONFIG_H */
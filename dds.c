@@ -0,0 +1,31 @@
+/**
+ * @file dds.c
+ * @brief Direct digital synthesis: 32-bit phase accumulator and sine table
+ */
+
+#include "dds.h"
+#include <math.h>
+
+int16_t dds_sine_lut[DDS_LUT_SIZE];
+
+/**
+ * @brief Fill the sine table (call once at start-up)
+ */
+void DDS_Init(void)
+{
+    for (uint32_t i = 0; i < DDS_LUT_SIZE; i++)
+    {
+        dds_sine_lut[i] = (int16_t)lrintf(32767.0f * sinf(6.28318531f * (float)i / (float)DDS_LUT_SIZE));
+    }
+}
+
+/**
+ * @brief Phase increment for a frequency
+ * @param frequency_hz: Tone frequency
+ * @param sample_rate: Samples per second
+ * @return Phase advance per sample
+ */
+uint32_t DDS_Increment(uint32_t frequency_hz, uint32_t sample_rate)
+{
+    return (uint32_t)(((uint64_t)frequency_hz << 32) / sample_rate);
+}
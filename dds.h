@@ -0,0 +1,48 @@
+/**
+ * @file dds.h
+ * @brief Direct digital synthesis: 32-bit phase accumulator and sine table
+ * @description Shared by the firmware and the host tools. A full turn is
+ *              2^32 phase units; the top DDS_LUT_BITS bits of the phase index
+ *              a Q15 sine table, so a retune only changes the increment and
+ *              never introduces a phase jump.
+ */
+
+#ifndef DDS_H
+#define DDS_H
+
+#include <stdint.h>
+
+#define DDS_LUT_BITS           10
+#define DDS_LUT_SIZE           (1UL << DDS_LUT_BITS)
+#define DDS_QUARTER_TURN       0x40000000UL  // Phase offset of cos() from sin()
+#define DDS_SAMPLE_RATE        32000UL       // Firmware output rate (OUTPUT_DAC_DDS)
+
+typedef struct {
+    uint32_t phase;         // Current phase (2^32 = one turn)
+    uint32_t increment;     // Phase advance per sample
+} DDS_Osc;
+
+extern int16_t dds_sine_lut[DDS_LUT_SIZE];
+
+void DDS_Init(void);
+uint32_t DDS_Increment(uint32_t frequency_hz, uint32_t sample_rate);
+
+/**
+ * @brief Q15 sine of a phase
+ */
+static inline int16_t DDS_Sine(uint32_t phase)
+{
+    return dds_sine_lut[phase >> (32 - DDS_LUT_BITS)];
+}
+
+/**
+ * @brief Next Q15 sample of an oscillator
+ */
+static inline int16_t DDS_Next(DDS_Osc *osc)
+{
+    int16_t sample = DDS_Sine(osc->phase);
+    osc->phase += osc->increment;
+    return sample;
+}
+
+#endif /* DDS_H */
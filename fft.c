@@ -0,0 +1,413 @@
+/**
+ * @file fft.c
+ * @brief Real-input FFT for power-of-two sizes (float for the host tools,
+ *        Q15 for the Cortex-M4)
+ */
+
+#include "fft.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FFT_TWO_PI             6.283185307179586
+
+#if FFT_SIMD
+typedef float Fft_V4 __attribute__((vector_size(16)));
+
+static inline Fft_V4 Fft_Load(const float *p)
+{
+    Fft_V4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void Fft_Store(float *p, Fft_V4 v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+#endif
+
+/**
+ * @brief log2 of a power of two, -1 otherwise
+ */
+static int Fft_Log2(uint32_t n)
+{
+    int bits = 0;
+
+    if (n == 0 || (n & (n - 1)) != 0) return -1;
+    while ((1UL << bits) < n) bits++;
+    return bits;
+}
+
+/**
+ * @brief Bit-reversed value of i over `bits` bits
+ */
+static uint32_t Fft_Reverse(uint32_t i, int bits)
+{
+    uint32_t r = 0;
+
+    for (int b = 0; b < bits; b++)
+    {
+        r = (r << 1) | (i & 1);
+        i >>= 1;
+    }
+    return r;
+}
+
+/**
+ * @brief Quarter size of the first radix-4 stage (after the optional radix-2 stage)
+ */
+static uint32_t Fft_First_Quarter(int log2_half)
+{
+    return (log2_half & 1) ? 2 : 1;
+}
+
+/**
+ * @brief Fill the stage tables: for each radix-4 stage with quarter size h,
+ *        W^2j, W^j and W^3j (j < h, W = exp(-2 pi i / 4h)), re/im split
+ * @param twiddle: Output, visited in stage order
+ * @param half: Complex transform size
+ * @param log2_half: log2(half)
+ * @param scale: 1 for float tables, 32767 for Q15
+ * @param q15: Q15 output (int16_t *) instead of float
+ */
+static void Fft_Build_Twiddles(void *twiddle, uint32_t half, int log2_half, double scale, int q15)
+{
+    uint32_t offset = 0;
+
+    for (uint32_t h = Fft_First_Quarter(log2_half); 4 * h <= half; h *= 4)
+    {
+        for (uint32_t j = 0; j < h; j++)
+        {
+            const uint32_t power[3] = { 2 * j, j, 3 * j };
+            for (int t = 0; t < 3; t++)
+            {
+                double angle = -FFT_TWO_PI * (double)power[t] / (double)(4 * h);
+                double re = cos(angle) * scale;
+                double im = sin(angle) * scale;
+                uint32_t at_re = offset + (uint32_t)(2 * t) * h + j;
+                uint32_t at_im = at_re + h;
+                if (q15)
+                {
+                    ((int16_t *)twiddle)[at_re] = (int16_t)lrint(re);
+                    ((int16_t *)twiddle)[at_im] = (int16_t)lrint(im);
+                }
+                else
+                {
+                    ((float *)twiddle)[at_re] = (float)re;
+                    ((float *)twiddle)[at_im] = (float)im;
+                }
+            }
+        }
+        offset += 6 * h;
+    }
+}
+
+/* ------------------------------------------------------------------ float */
+
+/**
+ * @brief One fused radix-4 stage (two radix-2 DIT stages)
+ * @param re, im: Complex data (split format)
+ * @param m: Complex transform size
+ * @param h: Quarter size of the butterfly group
+ * @param tw: Stage table (W^2j, W^j, W^3j; re then im, h entries each)
+ */
+static void Fft_Radix4(float *re, float *im, uint32_t m, uint32_t h, const float *tw)
+{
+    const float *w1r = tw, *w1i = tw + h;
+    const float *w2r = tw + 2 * h, *w2i = tw + 3 * h;
+    const float *w3r = tw + 4 * h, *w3i = tw + 5 * h;
+
+    for (uint32_t base = 0; base < m; base += 4 * h)
+    {
+        float *r0 = re + base, *r1 = r0 + h, *r2 = r1 + h, *r3 = r2 + h;
+        float *i0 = im + base, *i1 = i0 + h, *i2 = i1 + h, *i3 = i2 + h;
+        uint32_t j = 0;
+
+#if FFT_SIMD
+        for (; j + 4 <= h; j += 4)
+        {
+            Fft_V4 x0r = Fft_Load(r0 + j), x0i = Fft_Load(i0 + j);
+            Fft_V4 x1r = Fft_Load(r1 + j), x1i = Fft_Load(i1 + j);
+            Fft_V4 x2r = Fft_Load(r2 + j), x2i = Fft_Load(i2 + j);
+            Fft_V4 x3r = Fft_Load(r3 + j), x3i = Fft_Load(i3 + j);
+            Fft_V4 ar = Fft_Load(w1r + j), ai = Fft_Load(w1i + j);
+            Fft_V4 br = Fft_Load(w2r + j), bi = Fft_Load(w2i + j);
+            Fft_V4 cr = Fft_Load(w3r + j), ci = Fft_Load(w3i + j);
+
+            Fft_V4 t1r = x1r * ar - x1i * ai, t1i = x1r * ai + x1i * ar;
+            Fft_V4 t2r = x2r * br - x2i * bi, t2i = x2r * bi + x2i * br;
+            Fft_V4 t3r = x3r * cr - x3i * ci, t3i = x3r * ci + x3i * cr;
+
+            Fft_V4 s0r = x0r + t1r, s0i = x0i + t1i;
+            Fft_V4 s1r = x0r - t1r, s1i = x0i - t1i;
+            Fft_V4 s2r = t2r + t3r, s2i = t2i + t3i;
+            Fft_V4 dr = t2r - t3r, di = t2i - t3i;
+
+            Fft_Store(r0 + j, s0r + s2r);
+            Fft_Store(i0 + j, s0i + s2i);
+            Fft_Store(r2 + j, s0r - s2r);
+            Fft_Store(i2 + j, s0i - s2i);
+            Fft_Store(r1 + j, s1r + di);
+            Fft_Store(i1 + j, s1i - dr);
+            Fft_Store(r3 + j, s1r - di);
+            Fft_Store(i3 + j, s1i + dr);
+        }
+#endif
+        for (; j < h; j++)
+        {
+            float t1r = r1[j] * w1r[j] - i1[j] * w1i[j], t1i = r1[j] * w1i[j] + i1[j] * w1r[j];
+            float t2r = r2[j] * w2r[j] - i2[j] * w2i[j], t2i = r2[j] * w2i[j] + i2[j] * w2r[j];
+            float t3r = r3[j] * w3r[j] - i3[j] * w3i[j], t3i = r3[j] * w3i[j] + i3[j] * w3r[j];
+
+            float s0r = r0[j] + t1r, s0i = i0[j] + t1i;
+            float s1r = r0[j] - t1r, s1i = i0[j] - t1i;
+            float s2r = t2r + t3r, s2i = t2i + t3i;
+            float dr = t2r - t3r, di = t2i - t3i;
+
+            // y1 = s1 - i d, y3 = s1 + i d
+            r0[j] = s0r + s2r;
+            i0[j] = s0i + s2i;
+            r2[j] = s0r - s2r;
+            i2[j] = s0i - s2i;
+            r1[j] = s1r + di;
+            i1[j] = s1i - dr;
+            r3[j] = s1r - di;
+            i3[j] = s1i + dr;
+        }
+    }
+}
+
+/**
+ * @brief Create a float plan (tables and work buffers on the heap)
+ * @param plan: Plan to initialize
+ * @param n: Real transform size (power of two, >= 4)
+ * @return 0 on success, -1 on a bad size or out of memory
+ */
+int Fft_Init(Fft_Plan *plan, uint32_t n)
+{
+    int log2_n = Fft_Log2(n);
+
+    memset(plan, 0, sizeof(*plan));
+    if (log2_n < 2) return -1;
+
+    plan->n = n;
+    plan->half = n / 2;
+    plan->bitrev = (uint32_t *)malloc(plan->half * sizeof(uint32_t));
+    plan->twiddle = (float *)malloc(2 * plan->half * sizeof(float));
+    plan->split_cos = (float *)malloc(plan->half * sizeof(float));
+    plan->split_sin = (float *)malloc(plan->half * sizeof(float));
+    plan->work_re = (float *)malloc(plan->half * sizeof(float));
+    plan->work_im = (float *)malloc(plan->half * sizeof(float));
+    if (!plan->bitrev || !plan->twiddle || !plan->split_cos || !plan->split_sin || !plan->work_re || !plan->work_im)
+    {
+        Fft_Free(plan);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < plan->half; i++)
+    {
+        plan->bitrev[i] = Fft_Reverse(i, log2_n - 1);
+        plan->split_cos[i] = (float)cos(FFT_TWO_PI * i / n);
+        plan->split_sin[i] = (float)sin(FFT_TWO_PI * i / n);
+    }
+    Fft_Build_Twiddles(plan->twiddle, plan->half, log2_n - 1, 1.0, 0);
+    return 0;
+}
+
+/**
+ * @brief Release a float plan
+ */
+void Fft_Free(Fft_Plan *plan)
+{
+    free(plan->bitrev);
+    free(plan->twiddle);
+    free(plan->split_cos);
+    free(plan->split_sin);
+    free(plan->work_re);
+    free(plan->work_im);
+    memset(plan, 0, sizeof(*plan));
+}
+
+/**
+ * @brief Forward transform of n real samples
+ * @param plan: Plan from Fft_Init()
+ * @param in: n samples
+ * @param out_re, out_im: n/2 + 1 bins each (unscaled DFT)
+ */
+void Fft_Real(Fft_Plan *plan, const float *in, float *out_re, float *out_im)
+{
+    const uint32_t m = plan->half;
+    float *re = plan->work_re, *im = plan->work_im;
+    int log2_half = Fft_Log2(m);
+
+    // z[k] = x[2k] + i x[2k+1], loaded in bit-reversed order
+    for (uint32_t k = 0; k < m; k++)
+    {
+        uint32_t r = plan->bitrev[k];
+        re[r] = in[2 * k];
+        im[r] = in[2 * k + 1];
+    }
+
+    if (log2_half & 1)
+    {
+        for (uint32_t i = 0; i < m; i += 2)
+        {
+            float ar = re[i], ai = im[i];
+            re[i] = ar + re[i + 1];
+            im[i] = ai + im[i + 1];
+            re[i + 1] = ar - re[i + 1];
+            im[i + 1] = ai - im[i + 1];
+        }
+    }
+
+    const float *tw = plan->twiddle;
+    for (uint32_t h = Fft_First_Quarter(log2_half); 4 * h <= m; h *= 4)
+    {
+        Fft_Radix4(re, im, m, h, tw);
+        tw += 6 * h;
+    }
+
+    // Split: X[k] = E[k] + W^k O[k], E/O = transforms of the even/odd samples
+    out_re[0] = re[0] + im[0];
+    out_im[0] = 0.0f;
+    out_re[m] = re[0] - im[0];
+    out_im[m] = 0.0f;
+    for (uint32_t k = 1; k < m; k++)
+    {
+        float er = 0.5f * (re[k] + re[m - k]), ei = 0.5f * (im[k] - im[m - k]);
+        float or_ = 0.5f * (im[k] + im[m - k]), oi = -0.5f * (re[k] - re[m - k]);
+        float c = plan->split_cos[k], s = plan->split_sin[k];
+
+        out_re[k] = er + c * or_ + s * oi;
+        out_im[k] = ei + c * oi - s * or_;
+    }
+}
+
+/* -------------------------------------------------------------------- Q15 */
+
+/**
+ * @brief Saturate to int16_t
+ */
+static inline int16_t Fft_Q15_Sat(int32_t x)
+{
+    return (int16_t)(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+}
+
+/**
+ * @brief Q15 complex multiply, rounded
+ */
+static inline void Fft_Q15_Mul(int32_t ar, int32_t ai, int32_t wr, int32_t wi, int32_t *pr, int32_t *pi)
+{
+    *pr = (ar * wr - ai * wi + 0x4000) >> 15;
+    *pi = (ar * wi + ai * wr + 0x4000) >> 15;
+}
+
+/**
+ * @brief Create a Q15 plan (no heap; sizes up to FFT_Q15_MAX_N)
+ * @param plan: Plan to initialize
+ * @param n: Real transform size (power of two, 4..FFT_Q15_MAX_N)
+ * @return 0 on success, -1 on a bad size
+ */
+int Fft_Q15_Init(Fft_Q15_Plan *plan, uint32_t n)
+{
+    int log2_n = Fft_Log2(n);
+
+    if (log2_n < 2 || n > FFT_Q15_MAX_N) return -1;
+
+    plan->n = n;
+    plan->half = n / 2;
+    for (uint32_t i = 0; i < plan->half; i++)
+    {
+        plan->bitrev[i] = (uint16_t)Fft_Reverse(i, log2_n - 1);
+        plan->split_cos[i] = (int16_t)lrint(32767.0 * cos(FFT_TWO_PI * i / n));
+        plan->split_sin[i] = (int16_t)lrint(32767.0 * sin(FFT_TWO_PI * i / n));
+    }
+    Fft_Build_Twiddles(plan->twiddle, plan->half, log2_n - 1, 32767.0, 1);
+    return 0;
+}
+
+/**
+ * @brief Forward transform of n real Q15 samples
+ * @param plan: Plan from Fft_Q15_Init()
+ * @param in: n samples within +-16384
+ * @param out_re, out_im: n/2 + 1 bins each, DFT / (n/2)
+ */
+void Fft_Q15_Real(Fft_Q15_Plan *plan, const int16_t *in, int16_t *out_re, int16_t *out_im)
+{
+    const uint32_t m = plan->half;
+    int16_t *re = plan->work_re, *im = plan->work_im;
+    int log2_half = Fft_Log2(m);
+
+    for (uint32_t k = 0; k < m; k++)
+    {
+        uint32_t r = plan->bitrev[k];
+        re[r] = in[2 * k];
+        im[r] = in[2 * k + 1];
+    }
+
+    if (log2_half & 1)
+    {
+        for (uint32_t i = 0; i < m; i += 2)
+        {
+            int32_t ar = re[i], ai = im[i], br = re[i + 1], bi = im[i + 1];
+            re[i] = (int16_t)((ar + br) >> 1);
+            im[i] = (int16_t)((ai + bi) >> 1);
+            re[i + 1] = (int16_t)((ar - br) >> 1);
+            im[i + 1] = (int16_t)((ai - bi) >> 1);
+        }
+    }
+
+    const int16_t *tw = plan->twiddle;
+    for (uint32_t h = Fft_First_Quarter(log2_half); 4 * h <= m; h *= 4)
+    {
+        const int16_t *w1r = tw, *w1i = tw + h, *w2r = tw + 2 * h, *w2i = tw + 3 * h, *w3r = tw + 4 * h, *w3i = tw + 5 * h;
+
+        for (uint32_t base = 0; base < m; base += 4 * h)
+        {
+            int16_t *r0 = re + base, *r1 = r0 + h, *r2 = r1 + h, *r3 = r2 + h;
+            int16_t *i0 = im + base, *i1 = i0 + h, *i2 = i1 + h, *i3 = i2 + h;
+
+            for (uint32_t j = 0; j < h; j++)
+            {
+                int32_t t1r, t1i, t2r, t2i, t3r, t3i;
+                Fft_Q15_Mul(r1[j], i1[j], w1r[j], w1i[j], &t1r, &t1i);
+                Fft_Q15_Mul(r2[j], i2[j], w2r[j], w2i[j], &t2r, &t2i);
+                Fft_Q15_Mul(r3[j], i3[j], w3r[j], w3i[j], &t3r, &t3i);
+
+                int32_t s0r = r0[j] + t1r, s0i = i0[j] + t1i;
+                int32_t s1r = r0[j] - t1r, s1i = i0[j] - t1i;
+                int32_t s2r = t2r + t3r, s2i = t2i + t3i;
+                int32_t dr = t2r - t3r, di = t2i - t3i;
+
+                // Scaled by 1/4 per stage
+                r0[j] = (int16_t)((s0r + s2r) >> 2);
+                i0[j] = (int16_t)((s0i + s2i) >> 2);
+                r2[j] = (int16_t)((s0r - s2r) >> 2);
+                i2[j] = (int16_t)((s0i - s2i) >> 2);
+                r1[j] = (int16_t)((s1r + di) >> 2);
+                i1[j] = (int16_t)((s1i - dr) >> 2);
+                r3[j] = (int16_t)((s1r - di) >> 2);
+                i3[j] = (int16_t)((s1i + dr) >> 2);
+            }
+        }
+        tw += 6 * h;
+    }
+
+    // Split step; re/im now hold Z / (n/2), so the bins come out as DFT / (n/2)
+    out_re[0] = Fft_Q15_Sat((int32_t)re[0] + im[0]);
+    out_im[0] = 0;
+    out_re[m] = Fft_Q15_Sat((int32_t)re[0] - im[0]);
+    out_im[m] = 0;
+    for (uint32_t k = 1; k < m; k++)
+    {
+        int32_t er = ((int32_t)re[k] + re[m - k]) >> 1, ei = ((int32_t)im[k] - im[m - k]) >> 1;
+        int32_t or_ = ((int32_t)im[k] + im[m - k]) >> 1, oi = -(((int32_t)re[k] - re[m - k]) >> 1);
+        int32_t c = plan->split_cos[k], s = plan->split_sin[k];
+
+        int32_t xr = er + ((c * or_ + s * oi + 0x4000) >> 15);
+        int32_t xi = ei + ((c * oi - s * or_ + 0x4000) >> 15);
+        out_re[k] = Fft_Q15_Sat(xr);
+        out_im[k] = Fft_Q15_Sat(xi);
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file fft.h
+ * @brief Real-input FFT for power-of-two sizes (float for the host tools,
+ *        Q15 for the Cortex-M4)
+ * @description Shared by the firmware and the host tools. An n-point real
+ *              transform runs as an n/2-point complex FFT of the even/odd
+ *              samples followed by a split step, so it costs about half a
+ *              complex transform of the same size.
+ *
+ * The complex FFT is decimation in time on bit-reversed input, in split
+ * format (separate real and imaginary arrays). Pairs of radix-2 stages are
+ * fused into radix-4 butterflies (three complex multiplies per four points);
+ * when log2(n/2) is odd one twiddle-free radix-2 stage runs first. Each
+ * stage reads its own contiguous twiddle table, built once by the plan, so
+ * both data and twiddles stream sequentially.
+ *
+ * Float path: with GCC on a host that has SSE2/AVX or NEON the butterflies
+ * of stages with at least four butterflies per group run four at a time
+ * through GCC vector extensions (FFT_SIMD, -DFFT_SIMD=0 forces scalar).
+ *
+ * Q15 path: fixed tables in the plan (no heap), each radix-4 stage scaled by
+ * 1/4 and the radix-2 stage by 1/2 so nothing overflows for inputs within
+ * +-16384 (ADC counts always are). Output bins are the DFT divided by n/2.
+ *
+ * Output of both: bins 0..n/2 (n/2 + 1 values), bin k at k * rate / n Hz.
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+
+#ifndef FFT_SIMD
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON))
+#define FFT_SIMD               1
+#else
+#define FFT_SIMD               0
+#endif
+#endif
+
+#define FFT_Q15_MAX_N          512  // Largest Q15 transform (plan size ~3.5 KB)
+
+typedef struct {
+    uint32_t n;             // Real transform size
+    uint32_t half;          // Complex transform size (n / 2)
+    uint32_t *bitrev;       // Bit-reversed index per complex input
+    float *twiddle;         // Stage tables: per stage 6 * quarter floats
+    float *split_cos;       // cos(2 pi k / n), k < n / 2
+    float *split_sin;       // sin(2 pi k / n)
+    float *work_re;         // Complex work buffer (n / 2)
+    float *work_im;
+} Fft_Plan;
+
+typedef struct {
+    uint32_t n;
+    uint32_t half;
+    uint16_t bitrev[FFT_Q15_MAX_N / 2];
+    int16_t twiddle[FFT_Q15_MAX_N];
+    int16_t split_cos[FFT_Q15_MAX_N / 2];
+    int16_t split_sin[FFT_Q15_MAX_N / 2];
+    int16_t work_re[FFT_Q15_MAX_N / 2];
+    int16_t work_im[FFT_Q15_MAX_N / 2];
+} Fft_Q15_Plan;
+
+int Fft_Init(Fft_Plan *plan, uint32_t n);
+void Fft_Free(Fft_Plan *plan);
+void Fft_Real(Fft_Plan *plan, const float *in, float *out_re, float *out_im);
+
+int Fft_Q15_Init(Fft_Q15_Plan *plan, uint32_t n);
+void Fft_Q15_Real(Fft_Q15_Plan *plan, const int16_t *in, int16_t *out_re, int16_t *out_im);
+
+#endif /* FFT_H */
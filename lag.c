@@ -0,0 +1,144 @@
+/**
+ * @file lag.c
+ * @brief Transport lag between an upstream and a downstream probe
+ */
+
+#include "lag.h"
+#include <math.h>
+
+/**
+ * @brief Clear history and the estimate
+ * @param state: State to initialize
+ */
+void Lag_Init(Lag_State *state)
+{
+    state->head = 0;
+    state->count = 0;
+    state->since = 0;
+    state->pending = 0;
+    state->accum_up = 0;
+    state->accum_down = 0;
+    state->lag_q8 = 0;
+    state->rho_q15 = 0;
+}
+
+/**
+ * @brief Add one reading of both probes
+ * @param state: Lag state
+ * @param cfg: Configuration
+ * @param upstream: Upstream probe reading (0-4095)
+ * @param downstream: Downstream probe reading (0-4095)
+ * @return 1 if a new estimate is in lag_q8/rho_q15, else 0
+ */
+int Lag_Update(Lag_State *state, const Lag_Config *cfg, uint16_t upstream, uint16_t downstream)
+{
+    state->accum_up += upstream;
+    state->accum_down += downstream;
+    if (++state->pending < cfg->decimation) return 0;
+
+    // Block average, centred on mid-scale so products stay within 32 bits
+    int16_t up = (int16_t)(state->accum_up / cfg->decimation - 2048);
+    int16_t down = (int16_t)(state->accum_down / cfg->decimation - 2048);
+    state->accum_up = 0;
+    state->accum_down = 0;
+    state->pending = 0;
+
+    // Each sample is stored twice, so the newest LAG_RING are always contiguous
+    state->up[state->head] = state->up[state->head + LAG_RING] = up;
+    state->down[state->head] = state->down[state->head + LAG_RING] = down;
+    state->head = (uint16_t)((state->head + 1 == LAG_RING) ? 0 : state->head + 1);
+    if (state->count < LAG_RING) state->count++;
+
+    if (++state->since < cfg->hop) return 0;
+    state->since = 0;
+    return Lag_Correlate(state, cfg) == 0;
+}
+
+/**
+ * @brief Estimate the lag from the newest window
+ * @param state: Lag state
+ * @param cfg: Configuration
+ * @return 0 on success, -1 if the configuration exceeds the limits, not
+ *         enough history is stored yet, or no lag correlates by at least
+ *         cfg->min_rho_q15 (flat probe, unrelated signals); the previous
+ *         estimate is then left in place
+ */
+int Lag_Correlate(Lag_State *state, const Lag_Config *cfg)
+{
+    const uint32_t window = cfg->window;
+    const uint32_t max_lag = cfg->max_lag;
+    const uint32_t span = window + 2 * max_lag;
+
+    if (window < 4 || window > LAG_MAX_WINDOW || max_lag > LAG_MAX_LAG || state->count < span) return -1;
+
+    // Newest `span` samples, oldest first; the downstream window is centred
+    // so every lag from -max_lag to +max_lag stays inside the upstream span
+    const int16_t *up = state->up + state->head + LAG_RING - span;
+    const int16_t *down = state->down + state->head + LAG_RING - span + max_lag;
+
+    // Zero-mean downstream window: its correlation with the upstream mean
+    // is then zero, so only the downstream side has to be centred
+    int16_t centred[LAG_MAX_WINDOW];
+    int32_t sum = 0;
+    for (uint32_t i = 0; i < window; i++) sum += down[i];
+    int32_t mean = (sum >= 0 ? sum + (int32_t)window / 2 : sum - (int32_t)window / 2) / (int32_t)window;
+    int64_t energy_down = 0;
+    for (uint32_t i = 0; i < window; i++)
+    {
+        centred[i] = (int16_t)(down[i] - mean);
+        energy_down += (int32_t)centred[i] * centred[i];
+    }
+
+    // Upstream window sums, slid one sample per lag
+    int32_t sum_up = 0;
+    int64_t square_up = 0;
+    for (uint32_t i = 0; i < window; i++)
+    {
+        sum_up += up[i];
+        square_up += (int32_t)up[i] * up[i];
+    }
+
+    // offset 0 is lag +max_lag, offset 2 * max_lag is lag -max_lag
+    float rho[2 * LAG_MAX_LAG + 1];
+    int32_t best = -1;  // No lag with a defined correlation yet
+    for (uint32_t offset = 0; offset <= 2 * max_lag; offset++)
+    {
+        const int16_t *u = up + offset;
+        if (offset > 0)
+        {
+            sum_up += u[window - 1] - u[-1];
+            square_up += (int32_t)u[window - 1] * u[window - 1] - (int32_t)u[-1] * u[-1];
+        }
+
+        int32_t cov = 0;
+        for (uint32_t i = 0; i < window; i++) cov += (int32_t)centred[i] * u[i];
+
+        float energy_up = (float)square_up - (float)sum_up * (float)sum_up / (float)window;
+        float norm = (float)energy_down * energy_up;
+        if (norm > 0.0f)
+        {
+            rho[offset] = (float)cov / sqrtf(norm);
+            if (best < 0 || rho[offset] > rho[best]) best = (int32_t)offset;
+        }
+        else
+        {
+            rho[offset] = 0.0f;  // A flat window correlates with nothing
+        }
+    }
+
+    // Nothing to report rather than a lag made up from offset 0
+    if (best < 0 || rho[best] * 32767.0f < (float)cfg->min_rho_q15) return -1;
+
+    // Parabolic refinement around an interior peak
+    float peak = (float)best;
+    if (best > 0 && best < (int32_t)(2 * max_lag))
+    {
+        float curve = rho[best - 1] - 2.0f * rho[best] + rho[best + 1];
+        if (curve < 0.0f) peak += 0.5f * (rho[best - 1] - rho[best + 1]) / curve;
+    }
+
+    float lag = ((float)max_lag - peak) * (float)cfg->decimation;
+    state->lag_q8 = (int32_t)lrintf(lag * 256.0f);
+    state->rho_q15 = (int16_t)lrintf(fminf(rho[best], 1.0f) * 32767.0f);
+    return 0;
+}
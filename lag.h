@@ -0,0 +1,59 @@
+/**
+ * @file lag.h
+ * @brief Transport lag between an upstream and a downstream probe
+ * @description Sliding-window normalized cross-correlation of two channels
+ *              (e.g. inlet/outlet temperature of an air duct). Readings are
+ *              block-averaged by `decimation`; every `hop` decimated samples
+ *              the last `window` downstream samples are correlated against
+ *              the upstream channel at every lag in -max_lag..+max_lag.
+ *
+ * Direct method, bounded cost: one estimate is window * (2 * max_lag + 1)
+ * 16-bit multiply-accumulates plus 2 * max_lag + 1 square roots, and the
+ * limits below cap it for any configuration. Decimation lowers the cost of
+ * long lags quadratically (fewer samples per window and fewer lags).
+ *
+ * The peak is refined by parabolic interpolation, so the lag has sub-sample
+ * resolution. Positive lag: the downstream probe follows the upstream one.
+ * A window whose best correlation stays below `min_rho_q15` (a flat probe,
+ * unrelated signals) yields no estimate at all.
+ */
+
+#ifndef LAG_H
+#define LAG_H
+
+#include <stdint.h>
+
+#define LAG_MAX_WINDOW         128  // Decimated samples per window
+#define LAG_MAX_LAG            32   // Largest |lag| searched (decimated samples)
+#define LAG_RING               (LAG_MAX_WINDOW + 2 * LAG_MAX_LAG)
+
+typedef struct {
+    uint16_t window;        // Correlation window (decimated samples)
+    uint16_t max_lag;       // Lags searched: -max_lag..+max_lag (decimated samples)
+    uint16_t decimation;    // Readings averaged per decimated sample
+    uint16_t hop;           // Decimated samples between estimates
+    uint16_t min_rho_q15;   // Weakest peak correlation reported (Q15)
+} Lag_Config;
+
+typedef struct {
+    int16_t up[2 * LAG_RING];     // Upstream history, centred, stored twice (contiguous view)
+    int16_t down[2 * LAG_RING];   // Downstream history, same layout
+    uint16_t head;          // Next write slot (0..LAG_RING-1)
+    uint16_t count;         // Decimated samples stored (saturates at LAG_RING)
+    uint16_t since;         // Decimated samples since the last estimate
+    uint16_t pending;       // Readings in the decimation accumulators
+    int32_t accum_up;
+    int32_t accum_down;
+    int32_t lag_q8;         // Latest lag estimate, readings in Q8
+    int16_t rho_q15;        // Correlation coefficient at the peak (Q15)
+} Lag_State;
+
+// 100 ms main loop: 6.4 s window, lags up to +-1.6 s, one estimate per second,
+// reported from a correlation of 0.5 up
+#define LAG_CONFIG_DEFAULT     { 64, 16, 1, 10, 16384 }
+
+void Lag_Init(Lag_State *state);
+int Lag_Update(Lag_State *state, const Lag_Config *cfg, uint16_t upstream, uint16_t downstream);
+int Lag_Correlate(Lag_State *state, const Lag_Config *cfg);
+
+#endif /* LAG_H */
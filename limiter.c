@@ -0,0 +1,66 @@
+/**
+ * @file limiter.c
+ * @brief Block-rate gain computer for the mix-bus soft limiter
+ */
+
+#include "limiter.h"
+
+/**
+ * @brief Reset to unity gain
+ * @param state: Limiter state
+ */
+void Limiter_Init(Limiter_State *state)
+{
+    state->gain = LIMITER_UNITY;
+    state->step = 0;
+    state->peak = 0;
+    state->count = LIMITER_BLOCK;
+    state->hold = 0;
+}
+
+/**
+ * @brief Compute the gain for the next block from the peak of the last one
+ * @param state: Limiter state
+ * @param cfg: Limiter configuration
+ * @description Called by Limiter_Process() every LIMITER_BLOCK samples;
+ *              two divides and a few compares, about two cycles per sample.
+ */
+void Limiter_Block(Limiter_State *state, const Limiter_Config *cfg)
+{
+    int32_t peak = state->peak;
+    int32_t target = LIMITER_UNITY;
+
+    if (peak > cfg->threshold)
+    {
+        // Soft knee: T + K * x / (x + K), x = overshoot, K = ceiling - T
+        int32_t knee = cfg->ceiling - cfg->threshold;
+        int32_t over = peak - cfg->threshold;
+        int32_t out = cfg->threshold + (over * knee) / (over + knee);
+
+        target = (int32_t)(((uint32_t)out << 15) / (uint32_t)peak);
+    }
+
+    // Attack within one block; hold, then release by a fraction of the gap
+    if (target <= state->gain)
+    {
+        state->hold = cfg->hold;
+    }
+    else if (state->hold > 0)
+    {
+        state->hold--;
+        target = state->gain;
+    }
+    else if (target - state->gain < (int32_t)LIMITER_BLOCK)
+    {
+        state->gain = target;   // Last fraction of a step: land exactly on unity
+    }
+    else
+    {
+        int32_t rise = ((target - state->gain) * cfg->release) >> 15;
+        target = state->gain + (rise > (int32_t)LIMITER_BLOCK ? rise : (int32_t)LIMITER_BLOCK);
+    }
+
+    state->step = (target - state->gain) >> LIMITER_BLOCK_BITS;
+    state->peak = 0;
+    state->count = LIMITER_BLOCK;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file limiter.h
+ * @brief Soft limiter for the audio mix bus
+ * @description Sits between the summed voices and the 12-bit DAC write.
+ *              Fixed point, no look-ahead, constant per-sample work.
+ *
+ * A gain computer runs once per LIMITER_BLOCK samples on the peak of the
+ * block just played: peaks up to `threshold` pass at unity gain, larger
+ * peaks are bent onto a soft knee that approaches `ceiling` but never
+ * reaches it. The gain then ramps linearly to the new target over the next
+ * block (one add per sample), so gain changes never step. Gain falls within
+ * one block (attack); once no block has needed less gain for `hold` blocks
+ * it recovers by `release` of the remaining gap per block, so the gain does
+ * not pump on the beat envelope of two close voices. The output is finally
+ * saturated to the DAC range, which only acts while a sudden transient is
+ * being caught (at most two blocks, 2 ms).
+ *
+ * Input is the signed mix in DAC counts (mid-scale 0) and must stay below
+ * 65536 in magnitude (32 full-scale voices).
+ */
+
+#ifndef LIMITER_H
+#define LIMITER_H
+
+#include <stdint.h>
+
+#define LIMITER_BLOCK_BITS     5
+#define LIMITER_BLOCK          (1UL << LIMITER_BLOCK_BITS)  // 1 ms at 32 kHz
+#define LIMITER_UNITY          32768         // Gain 1.0 (Q15)
+#define LIMITER_OUT_MIN        (-2048)       // 12-bit DAC around mid-scale
+#define LIMITER_OUT_MAX        2047
+
+typedef struct {
+    int32_t threshold;      // Largest peak passed unchanged (counts)
+    int32_t ceiling;        // Asymptote of the knee (counts)
+    uint32_t hold;          // Blocks at the reduced gain before release starts
+    int32_t release;        // Gain recovery per block (Q15 fraction of the gap)
+} Limiter_Config;
+
+typedef struct {
+    int32_t gain;           // Current gain (Q15)
+    int32_t step;           // Per-sample gain change (Q15)
+    int32_t peak;           // Largest input magnitude in the current block
+    uint32_t count;         // Samples left in the current block
+    uint32_t hold;          // Blocks left before release
+} Limiter_State;
+
+// Knee from -2.5 dBFS, 20 ms hold, ~50 ms release at 32 kHz
+#define LIMITER_CONFIG_DEFAULT { 1536, 2047, 20, LIMITER_UNITY / 50 }
+
+void Limiter_Init(Limiter_State *state);
+void Limiter_Block(Limiter_State *state, const Limiter_Config *cfg);
+
+/**
+ * @brief Limit one mix-bus sample
+ * @param mix: Sum of the voices (DAC counts around mid-scale)
+ * @return Output sample, LIMITER_OUT_MIN..LIMITER_OUT_MAX
+ */
+static inline int32_t Limiter_Process(Limiter_State *state, const Limiter_Config *cfg, int32_t mix)
+{
+    int32_t magnitude = mix < 0 ? -mix : mix;
+    int32_t out = (mix * state->gain) >> 15;
+
+    if (magnitude > state->peak) state->peak = magnitude;
+    state->gain += state->step;
+    if (--state->count == 0) Limiter_Block(state, cfg);
+
+    if (out > LIMITER_OUT_MAX) out = LIMITER_OUT_MAX;
+    if (out < LIMITER_OUT_MIN) out = LIMITER_OUT_MIN;
+    return out;
+}
+
+#endif /* LIMITER_H */
@@ -7,66 +7,502 @@
  * - ADC1 Channel 0 (PA0): Temperature sensor input (simulated)
  * - DAC1 Channel 1 (PA5): Audio output
  * - TIM2: Timer for tone generation
+ * - TIM1 CH1/CH1N (PA8/PA7): Bridge-tied piezo drive (OUTPUT_PIEZO_BRIDGE)
+ * - TIM2 update interrupt: DAC1 sine samples from a DDS (OUTPUT_DAC_DDS)
  * 
  * NOTE: A mock header file (stm32f4xx.h) is provided for code validation.
  * For actual STM32 development, use the official STM32 HAL libraries.
  * The code compiles successfully with the mock header for syntax checking.
  * 
+ * Host simulation: build with -DHOST_SIMULATION together with sim/sim.c and a
+ * driver that calls App_Init() / App_Poll() (see sim/sim.h).
+ * 
  * For web simulation, use index.html instead.
  * For Arduino-compatible code, use main.ino instead.
  */
 
 #include "stm32f4xx.h"
+#include "config.h"
+#include "pipeline.h"
+#if FEATURE_ANOMALY
+#include "anomaly.h"
+#endif
+#if FEATURE_POLICY
+#include "policy.h"
+#endif
+#if FEATURE_CAPTURE
+#include "capture.h"
+#include "uart.h"
+#endif
+#if FEATURE_LAG
+#include "lag.h"
+#include "uart.h"
+#endif
+#if ACQUISITION_BACKEND == ACQUISITION_DUAL
+#include "adc_multi.h"
+#endif
+#if FEATURE_BENCH
+#include "bench.h"
+#endif
+#if FEATURE_PROFILER
+#include "profiler.h"
+#include "uart.h"
+#endif
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+#include "dds.h"
+#endif
+#if FEATURE_MULTIRATE
+#include "multirate.h"
+#endif
+#if FEATURE_AUTORANGE
+#include "autorange.h"
+#endif
+#if FEATURE_LIMITER
+#include "limiter.h"
+#endif
+#if FEATURE_BEAT
+#include "uart.h"
+#endif
 #include <math.h>
-#include <stdlib.h>  // For abs() function
+
+#ifdef HOST_SIMULATION
+#include "sim/sim.h"
+#endif
 
 // Function prototypes
+void App_Init(void);
+void App_Poll(void);
 void SystemClock_Config(void);
 void GPIO_Init(void);
 void ADC1_Init(void);
 void DAC1_Init(void);
 void TIM2_Init(uint32_t frequency);
+#if OUTPUT_BACKEND == OUTPUT_PIEZO_BRIDGE
+void TIM1_Bridge_Init(uint32_t frequency);
+void TIM1_Bridge_Set(uint32_t frequency);
+#endif
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+void TIM2_Sample_Init(void);
+void TIM2_IRQHandler(void);
+void Tone_Table_Update(void);
+#endif
+#if FEATURE_BEAT
+void Beat_Set_Setpoint(uint16_t adc_value);
+void Beat_Command_Poll(void);
+#endif
 uint16_t ADC_Read_Temperature(void);
+#if FEATURE_MULTIRATE
+uint16_t ADC_Acquire_Tick(void);
+void TIM7_Acquire_Init(void);
+void TIM7_IRQHandler(void);
+#endif
 uint32_t Temperature_To_Frequency(uint16_t adc_value);
 void Delay_ms(uint32_t ms);
+#if FEATURE_ANOMALY
+uint32_t Alert_Next_Tone(void);
+#endif
+void Output_Set(uint32_t frequency, uint8_t amplitude);
+#if FEATURE_GATED_CADENCE
+void Output_Gate(uint16_t period_ticks);
+void TIM3_Gate_Init(uint16_t period_ticks);
+#endif
 
 // Global variables
-volatile uint32_t current_frequency = 440; // Default frequency (A4 note)
+SIM_RAM volatile uint32_t current_frequency = 440; // Default frequency (A4 note)
+SIM_RAM Pipeline_State pipeline_state;
+
+// Control pipeline configuration (range, dead-band, filter, glide)
+SIM_RAM Pipeline_Config pipeline_config = PIPELINE_CONFIG_DEFAULT;
+#if FEATURE_FILTER
+// 10 Hz control steps (same as `render --cutoff 0.5 --glide 200`)
+#define CONTROL_FILTER_ALPHA   17668 // Pipeline_Alpha_From_Cutoff(0.5f, 10.0f): 0.5 Hz low-pass
+#define CONTROL_GLIDE_ALPHA    25786 // Pipeline_Alpha_From_Time(200.0f, 100.0f): 200 ms glide
+#endif
+
+#if FEATURE_MULTIRATE
+// Oversampled acquisition: ADC1 read every 1 ms from TIM7, anti-alias filtered and
+// decimated 1 kHz -> 100 Hz -> 10 Hz, one reading per main loop tick
+#define ACQUIRE_RATE_HZ        1000 // TIM7 reading rate
+#define ACQUIRE_PER_TICK       100  // 1 kHz readings per 100 ms tick
+#define ACQUIRE_PRIME_TICKS    9    // Batches that fill the 80-tap 100 Hz filter
+static const Multirate_Stage acquire_stages[] = {
+    { "acquire", ACQUIRE_RATE_HZ, 0, 0 },
+    { "filter",  100,             0, 0 },
+    { "control", 10,              0, 0 },
+};
+SIM_RAM Multirate_Chain acquire_chain;
+SIM_RAM uint8_t acquire_oversampled = 0;     // 0: chain unusable, poll once per tick
+SIM_RAM volatile uint16_t acquire_value = 0; // Newest decimated reading (TIM7_IRQHandler)
+#endif
+
+#if FEATURE_AUTORANGE
+// Mapped ADC span follows the recent temperature range
+SIM_RAM Autorange_State autorange_state;
+const Autorange_Config autorange_config = AUTORANGE_CONFIG_DEFAULT;
+#endif
+
+#if ACQUISITION_BACKEND == ACQUISITION_DUAL
+// Latest time-aligned sensor pair (ADC1 = temperature, ADC2 = paired probe)
+static const uint8_t paired_channels[2] = { 0, 1 };
+SIM_RAM ADC_Multi_Record paired_record;
+#endif
+
+#if FEATURE_LAG
+// Transport lag from the ADC1 (upstream) to the ADC2 (downstream) probe
+#define LAG_READING_MS         100  // Main loop tick
+SIM_RAM Lag_State lag_state;
+const Lag_Config lag_config = LAG_CONFIG_DEFAULT;
+#endif
+
+#if FEATURE_ANOMALY
+// Drift/jump detector on the temperature channel
+SIM_RAM Anomaly_State anomaly_state;
+const Anomaly_Config anomaly_config = ANOMALY_CONFIG_DEFAULT;
+
+// Alert patterns: one tone per main loop tick, 0 = silent, indexed by event
+#define ALERT_TICKS            30  // 3 s alert
+#define ALERT_PATTERN_LEN      4
+static const uint16_t alert_patterns[][ALERT_PATTERN_LEN] = {
+    {    0,    0,    0,    0 },  // ANOMALY_NONE
+    { 1000, 1400, 1800,    0 },  // ANOMALY_DRIFT_UP: rising arpeggio
+    { 1800, 1400, 1000,    0 },  // ANOMALY_DRIFT_DOWN: falling arpeggio
+    { 2000,  300, 2000,  300 },  // ANOMALY_SPIKE: two-tone warble
+};
+SIM_RAM uint32_t alert_ticks = 0;
+SIM_RAM uint8_t alert_event = ANOMALY_NONE;
+#define ALERT_AMPLITUDE        11
+#endif
+
+#if FEATURE_CAPTURE
+// Raw readings around anomaly events, streamed over USART2
+SIM_RAM Capture_State capture_state;
+#endif
+
+#if FEATURE_POLICY
+// Alarm policy: zones by filtered ADC value (0-4095 ~ 0-100 C)
+#define POLICY_HYSTERESIS      40    // ~1 C
+#define POLICY_COOL_HIGH       1023  // 25 C
+#define POLICY_WARM_HIGH       2866  // 70 C
+#define POLICY_HOT_HIGH        3685  // 90 C
+static const Policy_Zone policy_zones[] = {
+    // adc_high          action          amplitude  period  tone_hz
+    {  POLICY_COOL_HIGH, POLICY_SILENT,  0,         0,      0    },  // Below 25 C: silent
+    {  POLICY_WARM_HIGH, POLICY_TONE,    7,         0,      0    },  // 25-70 C: soft temperature tone
+    {  POLICY_HOT_HIGH,  POLICY_PULSE,   11,        10,     0    },  // 70-90 C: 1 s pulsed tone
+    {  4095,             POLICY_SIREN,   11,        4,      1800 },  // Above 90 C: siren
+};
+// The checks of Policy_Compile(), at build time: the table is fixed, so
+// App_Init() never sees it rejected
+_Static_assert(POLICY_WARM_HIGH > POLICY_COOL_HIGH + 2 * POLICY_HYSTERESIS &&
+               POLICY_HOT_HIGH > POLICY_WARM_HIGH + 2 * POLICY_HYSTERESIS &&
+               4095 > POLICY_HOT_HIGH + 2 * POLICY_HYSTERESIS,
+               "policy zones must be wider than the hysteresis band");
+SIM_RAM Policy_Table policy_table;
+SIM_RAM uint8_t policy_zone = 0;
+#endif
+
+// Output state (what TIM2/DAC are currently programmed to)
+#define TONE_AMPLITUDE         11
+SIM_RAM uint32_t tick_count = 0;
+SIM_RAM uint32_t output_frequency = 440;
+SIM_RAM uint8_t output_amplitude = 0;
 
+// Timer that produces the tone (gated by TIM3 in pulsed zones)
+#if OUTPUT_BACKEND == OUTPUT_PIEZO_BRIDGE
+#define TONE_TIM               TIM1
+#define BRIDGE_TIMER_HZ        10500000UL  // 84 MHz / (PSC + 1), 16-bit ARR covers >= 161 Hz
+#define BRIDGE_DEAD_TIME       8           // DTG: 8 / 84 MHz ~ 95 ns
+#else
+#define TONE_TIM               TIM2
+#endif
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+// DDS voice: the TIM2 update interrupt writes one DAC sample per period
+SIM_RAM volatile DDS_Osc tone_osc;
+SIM_RAM volatile int32_t tone_level = 0;     // Sine peak in DAC counts
+// Phase increment per filtered ADC count, for the range it was built from
+SIM_RAM uint32_t tone_increments[PIPELINE_TABLE_SIZE];
+SIM_RAM uint32_t tone_table_min = 0;
+SIM_RAM uint32_t tone_table_max = 0;
+SIM_RAM uint16_t tone_table_adc_low = 0;
+SIM_RAM uint16_t tone_table_adc_high = 0;
+SIM_RAM uint32_t tone_increment = 0;         // Increment of current_frequency
+#endif
+#if FEATURE_BEAT
+// Reference voice at the pitch of the setpoint: beats against the
+// temperature tone at the rate of the error (~0.44 Hz per ADC count)
+#define BEAT_SETPOINT          2048  // Setpoint at boot (~50 C)
+SIM_RAM volatile DDS_Osc beat_osc;
+SIM_RAM volatile int32_t beat_level = 0;     // Silent unless the temperature tone plays
+SIM_RAM uint16_t beat_setpoint = BEAT_SETPOINT;
+// "S<count>\n" on USART2 moves the setpoint
+SIM_RAM uint16_t beat_command_value = 0;
+SIM_RAM uint8_t beat_command_digits = 0;     // 0: no command being received
+#endif
+#if FEATURE_LIMITER
+// Soft limiter between the summed voices and the DAC
+SIM_RAM Limiter_State mix_limiter;
+const Limiter_Config limiter_config = LIMITER_CONFIG_DEFAULT;
+#endif
+#if FEATURE_GATED_CADENCE
+// Cadence gate: TIM3 counts at 10 kHz, one half period per ARR cycle
+#define GATE_CLOCK_HZ          10000UL
+#define GATE_COUNTS_PER_TICK   (GATE_CLOCK_HZ / 10)  // 100 ms main loop tick
+#define GATE_MAX_TICKS         (2 * 65536UL / GATE_COUNTS_PER_TICK)  // 16-bit ARR: 131 ticks
+SIM_RAM uint16_t output_gate_ticks = 0;
+#endif
+
+#ifndef HOST_SIMULATION
 /**
  * @brief Main function
  */
 int main(void)
+{
+    App_Init();
+    
+#if FEATURE_BENCH
+    // PA6 strapped high at boot: report kernel cycle counts over USART2 first
+    if (Bench_Requested())
+    {
+        Bench_Run();
+    }
+#endif
+    
+    // Main loop
+    while (1)
+    {
+        App_Poll();
+    }
+}
+#endif
+
+/**
+ * @brief Application initialization (clocks, peripherals, interrupts)
+ */
+void App_Init(void)
 {
     // System initialization
     SystemClock_Config();
     GPIO_Init();
+#if FEATURE_CAPTURE || FEATURE_LAG || FEATURE_BEAT || FEATURE_PROFILER
+    UART_Init(); // Report/command UART, shared by everything below
+#endif
+#if ACQUISITION_BACKEND == ACQUISITION_DUAL
+    ADC_Multi_Init(paired_channels, 2);
+#else
     ADC1_Init();
+#endif
+#if FEATURE_MULTIRATE
+    if (Multirate_Init(&acquire_chain, acquire_stages, 3, ACQUIRE_PER_TICK) == 0)
+    {
+        // Settle the filters on the first reading instead of ramping up from 0
+        int16_t first = (int16_t)ADC_Read_Temperature();
+        for (uint32_t i = 0; i < ACQUIRE_PRIME_TICKS * ACQUIRE_PER_TICK; i++)
+        {
+            Multirate_Push(&acquire_chain, &first, 1);
+        }
+        acquire_value = (uint16_t)first;
+        acquire_oversampled = 1;
+        TIM7_Acquire_Init();
+    }
+#endif
+#if OUTPUT_BACKEND == OUTPUT_DAC_TRIANGLE || OUTPUT_BACKEND == OUTPUT_DAC_DDS
     DAC1_Init();
+#endif
+#if OUTPUT_BACKEND == OUTPUT_PIEZO_BRIDGE
+    TIM1_Bridge_Init(440); // Start with 440 Hz (A4 note)
+#elif OUTPUT_BACKEND == OUTPUT_DAC_DDS
+    DDS_Init();
+#if FEATURE_LIMITER
+    Limiter_Init(&mix_limiter);
+#endif
+#if FEATURE_BEAT
+    pipeline_config.deadband_hz = 0; // Every pitch step is a beat-rate step
+#endif
+    Tone_Table_Update();
+    tone_increment = DDS_Increment(current_frequency, DDS_SAMPLE_RATE);
+    tone_osc.increment = tone_increment;
+    output_frequency = current_frequency;
+    TIM2_Sample_Init();
+#else
     TIM2_Init(440); // Start with 440 Hz (A4 note)
+#endif
+#if FEATURE_FILTER
+    pipeline_config.filter_alpha = CONTROL_FILTER_ALPHA;
+    pipeline_config.glide_alpha = CONTROL_GLIDE_ALPHA;
+#endif
+    Pipeline_Init(&pipeline_state, &pipeline_config, current_frequency);
+#if FEATURE_AUTORANGE
+    Autorange_Init(&autorange_state);
+#endif
+#if FEATURE_ANOMALY
+    Anomaly_Init(&anomaly_state);
+#endif
+#if FEATURE_CAPTURE
+    Capture_Init(&capture_state);
+#endif
+#if FEATURE_LAG
+    Lag_Init(&lag_state);
+#endif
+#if FEATURE_POLICY
+    // Cannot fail: the zone table is checked at build time above
+    (void)Policy_Compile(&policy_table, policy_zones,
+                         sizeof(policy_zones) / sizeof(policy_zones[0]), POLICY_HYSTERESIS);
+#endif
+#if FEATURE_PROFILER
+    Profiler_Start();
+#endif
+#if FEATURE_BEAT
+    // Setpoint commands; after every other UART user is set up
+    UART_Rx_Init();
+#endif
     
     // Enable interrupts
     __enable_irq();
+}
+
+/**
+ * @brief One iteration of the main loop (read, convert, update, wait)
+ */
+void App_Poll(void)
+{
+    // Read temperature from ADC
+#if FEATURE_MULTIRATE
+    uint16_t adc_value = ADC_Acquire_Tick();
+#else
+    uint16_t adc_value = ADC_Read_Temperature();
+#endif
     
-    // Main loop
-    while (1)
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+    Tone_Table_Update();
+#endif
+    
+    // Filter, convert to frequency and apply dead-band (avoid constant updates)
+    if (Pipeline_Step(&pipeline_state, &pipeline_config, adc_value))
     {
-        // Read temperature from ADC
-        uint16_t adc_value = ADC_Read_Temperature();
-        
-        // Convert temperature to frequency
-        uint32_t new_frequency = Temperature_To_Frequency(adc_value);
-        
-        // Update frequency if changed significantly (avoid constant updates)
-        if (abs((int32_t)new_frequency - (int32_t)current_frequency) > 5)
+        current_frequency = pipeline_state.frequency;
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+        // Without glide the pitch is the map of the filtered count: one table
+        // load instead of a map and a divide
+        if (!FEATURE_FILTER || pipeline_config.glide_alpha == PIPELINE_Q16_ONE)
+        {
+            tone_increment = tone_increments[(pipeline_state.filtered_q16 + 0x8000) >> 16];
+        }
+        else
         {
-            current_frequency = new_frequency;
-            TIM2_Init(current_frequency); // Update timer frequency
+            tone_increment = DDS_Increment(current_frequency, DDS_SAMPLE_RATE);
         }
-        
-        // Small delay to prevent excessive updates
-        Delay_ms(100);
+#endif
+    }
+    
+#if FEATURE_BEAT
+    // Both voices from the same table, every tick: the beat stays the count
+    // error under glide and after a table rebuild
+    Beat_Command_Poll();
+    tone_increment = tone_increments[(pipeline_state.filtered_q16 + 0x8000) >> 16];
+    if (output_frequency == current_frequency) tone_osc.increment = tone_increment;
+#endif
+    
+#if FEATURE_AUTORANGE
+    // Rescale the map to the recent range (rate-limited; the DDS table is
+    // rebuilt by Tone_Table_Update() on the next tick)
+    if (Autorange_Update(&autorange_state, &autorange_config,
+                         (uint16_t)((pipeline_state.filtered_q16 + 0x8000) >> 16)))
+    {
+        pipeline_config.adc_low = autorange_state.adc_low;
+        pipeline_config.adc_high = autorange_state.adc_high;
+    }
+#endif
+    
+#if FEATURE_ANOMALY
+    // Slow drifts and jumps trigger an alert pattern
+    int event = Anomaly_Update(&anomaly_state, &anomaly_config, adc_value);
+    if (event != ANOMALY_NONE)
+    {
+        alert_event = (uint8_t)event;
+        alert_ticks = ALERT_TICKS;
     }
+#endif
+    
+#if FEATURE_CAPTURE
+    // The reading after a trigger is the event reading; frozen windows go
+    // out a few rows per tick
+    if (event != ANOMALY_NONE)
+    {
+        Capture_Trigger(&capture_state, (uint8_t)event, tick_count);
+    }
+#if ACQUISITION_BACKEND == ACQUISITION_DUAL
+    Capture_Record(&capture_state, paired_record.value);
+#else
+    Capture_Record(&capture_state, &adc_value);
+#endif
+    Capture_Poll(&capture_state);
+#endif
+    
+#if FEATURE_LAG
+    // One line per estimate (every lag_config.hop readings)
+    if (Lag_Update(&lag_state, &lag_config, paired_record.value[0], paired_record.value[1]))
+    {
+        UART_Puts("# lag tick=");
+        UART_Put_Uint(tick_count);
+        UART_Puts(" lag_ms=");
+        UART_Put_Int(lag_state.lag_q8 * LAG_READING_MS / 256);
+        UART_Puts(" rho_permille=");
+        UART_Put_Int(lag_state.rho_q15 * 1000 / 32767);
+        UART_Putc('\n');
+    }
+#endif
+    
+#if FEATURE_POLICY
+    // Zone of the filtered temperature (single table lookup)
+    uint16_t filtered = (uint16_t)((pipeline_state.filtered_q16 + 0x8000) >> 16);
+    policy_zone = Policy_Evaluate(&policy_table, policy_zone, filtered);
+#endif
+    
+#if FEATURE_GATED_CADENCE
+    uint16_t gate_ticks = 0; // Hardware on/off cadence, 0 = continuous
+#endif
+#if FEATURE_ANOMALY
+    // Alerts take precedence over the zone pattern
+    if (alert_ticks > 0)
+    {
+        Output_Set(Alert_Next_Tone(), ALERT_AMPLITUDE);
+    }
+    else
+#endif
+    {
+#if FEATURE_POLICY
+        const Policy_Zone *zone = &policy_zones[policy_zone];
+#if FEATURE_GATED_CADENCE
+        if (zone->action == POLICY_PULSE)
+        {
+            // TIM3 switches the tone on and off; only the pitch is set here
+            gate_ticks = zone->period_ticks;
+            Output_Set(zone->tone_hz != 0 ? zone->tone_hz : current_frequency, zone->amplitude);
+        }
+        else
+#endif
+        {
+            Output_Set(Policy_Tone(zone, tick_count, current_frequency), zone->amplitude);
+        }
+#else
+        Output_Set(current_frequency, TONE_AMPLITUDE);
+#endif
+    }
+#if FEATURE_GATED_CADENCE
+    Output_Gate(gate_ticks);
+#endif
+    tick_count++;
+    
+#if FEATURE_PROFILER
+    // Periodic PC histogram over USART2 (decode with tools/pcprof)
+    if (tick_count % PROFILER_REPORT_TICKS == 0)
+    {
+        Profiler_Report();
+    }
+#endif
+    
+    // Small delay to prevent excessive updates
+    Delay_ms(100);
 }
 
 /**
@@ -109,8 +545,20 @@ void GPIO_Init(void)
     // PA0: ADC1_IN0 (Analog mode for temperature sensor)
     GPIOA->MODER |= GPIO_MODER_MODER0; // Analog mode
     
+#if OUTPUT_BACKEND == OUTPUT_BUZZER
+    // PA5: TIM2_CH1 (Alternate function AF1 for the buzzer)
+    GPIOA->MODER = (GPIOA->MODER & ~GPIO_MODER_MODER5) | GPIO_MODER_MODER5_1;
+    GPIOA->AFR[0] = (GPIOA->AFR[0] & ~(0xFUL << 20)) | (1UL << 20);
+#elif OUTPUT_BACKEND == OUTPUT_PIEZO_BRIDGE
+    // PA8: TIM1_CH1, PA7: TIM1_CH1N (AF1); piezo connected between them
+    GPIOA->MODER = (GPIOA->MODER & ~(GPIO_MODER_MODER7 | GPIO_MODER_MODER8)) |
+                   GPIO_MODER_MODER7_1 | GPIO_MODER_MODER8_1;
+    GPIOA->AFR[0] = (GPIOA->AFR[0] & ~(0xFUL << 28)) | (1UL << 28);
+    GPIOA->AFR[1] = (GPIOA->AFR[1] & ~(0xFUL << 0)) | (1UL << 0);
+#else
     // PA5: DAC1_OUT1 (Analog mode for audio output)
     GPIOA->MODER |= GPIO_MODER_MODER5; // Analog mode
+#endif
 }
 
 /**
@@ -127,7 +575,7 @@ void ADC1_Init(void)
     // Set resolution to 12-bit
     ADC1->CR1 &= ~ADC_CR1_RES;
     
-    // Set sample time for channel 0 (144 cycles)
+    // Set sample time for channel 0 (SMP0 = 0b111: 480 cycles)
     ADC1->SMPR2 |= ADC_SMPR2_SMP0_2 | ADC_SMPR2_SMP0_1 | ADC_SMPR2_SMP0_0;
     
     // Set channel 0 as first in sequence
@@ -146,33 +594,221 @@ void ADC1_Init(void)
  */
 uint16_t ADC_Read_Temperature(void)
 {
+#if ACQUISITION_BACKEND == ACQUISITION_DUAL
+    // Temperature is the ADC1 half of the newest simultaneous pair
+    ADC_Multi_Latest(&paired_record);
+    return paired_record.value[0];
+#else
     // Wait for conversion complete
     while (!(ADC1->SR & ADC_SR_EOC));
     
     // Read ADC value
     return ADC1->DR;
+#endif
+}
+
+#if FEATURE_MULTIRATE
+/**
+ * @brief Temperature reading for one main loop tick
+ * @return Newest decimated reading (0-4095), or a direct ADC reading if the
+ *         chain could not be built
+ */
+uint16_t ADC_Acquire_Tick(void)
+{
+    if (!acquire_oversampled) return ADC_Read_Temperature();
+    
+    return acquire_value;
+}
+
+/**
+ * @brief TIM7 paces the 1 kHz acquisition stage
+ * @note 84 MHz timer clock / 84 = 1 MHz, / 1000 = 1 kHz. Below the DDS sample
+ *       interrupt in priority, so the chain (about 5k cycles every 100 ms)
+ *       never delays a DAC sample.
+ */
+void TIM7_Acquire_Init(void)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_TIM7EN;
+    
+    TIM7->CR1 = 0;
+    TIM7->PSC = 84 - 1;
+    TIM7->ARR = 1000000UL / ACQUIRE_RATE_HZ - 1;
+    TIM7->EGR = TIM_EGR_UG;
+    TIM7->SR = 0;
+    TIM7->DIER = TIM_DIER_UIE;
+    
+    NVIC->IP[TIM7_IRQn] = 0x20;
+    NVIC->ISER[TIM7_IRQn >> 5] = 1UL << (TIM7_IRQn & 31);
+    
+    TIM7->CR1 = TIM_CR1_CEN;
 }
 
+/**
+ * @brief One 1 kHz reading into the chain; every ACQUIRE_PER_TICK readings
+ *        the chain runs and the decimated reading is latched
+ */
+void TIM7_IRQHandler(void)
+{
+    TIM7->SR = (uint32_t)~TIM_SR_UIF;
+    
+    int16_t reading = (int16_t)ADC1->DR; // Continuous conversion: newest result
+    
+    if (Multirate_Push(&acquire_chain, &reading, 1) == 0) return;
+    
+    // Filter overshoot on steps can leave the ADC range
+    uint16_t count;
+    const int16_t *out = Multirate_Output(&acquire_chain, &count);
+    int16_t value = out[count - 1];
+    acquire_value = value < 0 ? 0 : (value > PIPELINE_ADC_MAX ? PIPELINE_ADC_MAX : (uint16_t)value);
+}
+#endif
+
 /**
  * @brief Convert ADC value to frequency (Hz)
  * @param adc_value: ADC reading (0-4095)
  * @return Frequency in Hz (200-2000 Hz range)
  * 
- * Mapping: ADC 0-4095 -> Frequency 200-2000 Hz
+ * Mapping: ADC 0-4095 -> Frequency 200-2000 Hz (pipeline_config range)
  * This simulates temperature range affecting sound pitch
  */
 uint32_t Temperature_To_Frequency(uint16_t adc_value)
 {
-    // Map ADC value (0-4095) to frequency range (200-2000 Hz)
-    // Linear mapping: freq = 200 + (adc_value * 1800 / 4095)
-    uint32_t frequency = 200 + ((uint32_t)adc_value * 1800) / 4095;
+    // Map ADC value (0-4095) to frequency range (200-2000 Hz by default)
+    // Linear mapping: freq = min + (adc_value * (max - min) / 4095)
+    return Pipeline_Map(&pipeline_config, adc_value);
+}
+
+#if FEATURE_ANOMALY
+/**
+ * @brief Next tone of the active alert pattern
+ * @return Frequency in Hz, 0 = silent
+ */
+uint32_t Alert_Next_Tone(void)
+{
+    uint32_t step = (ALERT_TICKS - alert_ticks) % ALERT_PATTERN_LEN;
+    
+    alert_ticks--;
+    return alert_patterns[alert_event][step];
+}
+#endif
+
+/**
+ * @brief Program the tone output (only touches hardware on change)
+ * @param frequency: Tone in Hz, 0 = silent
+ * @param amplitude: DAC triangle amplitude (MAMP1 field, 0-11)
+ */
+void Output_Set(uint32_t frequency, uint8_t amplitude)
+{
+#if OUTPUT_BACKEND == OUTPUT_DAC_TRIANGLE
+    if (amplitude != output_amplitude)
+    {
+        DAC->CR = (DAC->CR & ~DAC_CR_MAMP1) | ((uint32_t)amplitude << DAC_CR_MAMP1_Pos);
+        output_amplitude = amplitude;
+    }
+#elif OUTPUT_BACKEND == OUTPUT_DAC_DDS
+    if (amplitude != output_amplitude)
+    {
+        tone_level = ((1L << (amplitude + 1)) - 1) >> 1; // Same swing as MAMP1 = amplitude
+        output_amplitude = amplitude;
+    }
+#if FEATURE_BEAT
+    // The reference only sounds under the temperature tone, not under alerts
+    // or sirens
+    beat_level = (frequency != 0 && frequency == current_frequency) ? tone_level : 0;
+#endif
+#else
+    (void)amplitude; // Buzzer/bridge output has a fixed level
+#endif
+    
+    if (frequency == output_frequency) return;
+    
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+    // A single store, picked up by the next sample interrupt without a phase
+    // jump. The temperature pitch comes from the table; increment 0 (silence)
+    // holds the output at its last level.
+    tone_osc.increment = (frequency == current_frequency) ? tone_increment
+                                                          : DDS_Increment(frequency, DDS_SAMPLE_RATE);
+#else
+    if (frequency == 0)
+    {
+#if OUTPUT_BACKEND == OUTPUT_PIEZO_BRIDGE
+        TIM1->BDTR &= ~TIM_BDTR_MOE; // Silence: both bridge legs to idle (low)
+#else
+        TIM2->CR1 &= ~TIM_CR1_CEN; // Silence: output holds its last level
+#endif
+    }
+    else
+    {
+#if OUTPUT_BACKEND == OUTPUT_PIEZO_BRIDGE
+        TIM1_Bridge_Set(frequency); // Preloaded, takes effect at the next period
+#else
+        TIM2_Init(frequency); // Update timer frequency
+#endif
+    }
+#endif
+    output_frequency = frequency;
+}
+
+#if FEATURE_GATED_CADENCE
+/**
+ * @brief Hardware on/off cadence for the tone (TIM3 gates the tone timer)
+ * @param period_ticks: Cadence period in main loop ticks, tone on for the
+ *                      first half; 0 = continuous tone; clamped to
+ *                      GATE_MAX_TICKS (13.1 s)
+ * @note While gated, a cadence change is a single (preloaded) TIM3->ARR
+ *       write and a pitch change only touches the tone timer, so neither needs the CPU
+ *       to time the beeps.
+ */
+void Output_Gate(uint16_t period_ticks)
+{
+    // Longer cadences would wrap TIM3->ARR to a fast flutter
+    if (period_ticks > GATE_MAX_TICKS) period_ticks = GATE_MAX_TICKS;
+    if (period_ticks == output_gate_ticks) return;
+    
+    if (period_ticks == 0)
+    {
+        TONE_TIM->SMCR &= ~TIM_SMCR_SMS; // Tone timer free-running again
+        TIM3->CR1 &= ~TIM_CR1_CEN;
+    }
+    else if (output_gate_ticks == 0)
+    {
+        TIM3_Gate_Init(period_ticks);
+        // The tone timer counts only while TIM3 TRGO (OC1REF) is high
+        // (ITR2 is TIM3 TRGO for both TIM1 and TIM2)
+        TONE_TIM->SMCR = (TONE_TIM->SMCR & ~(TIM_SMCR_TS | TIM_SMCR_SMS)) | TIM_SMCR_TS_ITR2 | TIM_SMCR_SMS_GATED;
+    }
+    else
+    {
+        TIM3->ARR = (uint32_t)period_ticks * GATE_COUNTS_PER_TICK / 2 - 1;
+    }
+    output_gate_ticks = period_ticks;
+}
+
+/**
+ * @brief TIM3 as cadence master: OC1REF square wave on TRGO
+ * @param period_ticks: Cadence period in main loop ticks (1-GATE_MAX_TICKS)
+ */
+void TIM3_Gate_Init(uint16_t period_ticks)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+    TIM3->CR1 = 0;
+    
+    // 10 kHz count, ARR = half the cadence period (16-bit timer)
+    TIM3->PSC = 84000000UL / GATE_CLOCK_HZ - 1;
+    TIM3->ARR = (uint32_t)period_ticks * GATE_COUNTS_PER_TICK / 2 - 1;
     
-    // Ensure frequency is within valid range
-    if (frequency < 200) frequency = 200;
-    if (frequency > 2000) frequency = 2000;
+    // OC1REF toggles at every wrap (match at 0). Forced low and the counter
+    // parked at ARR, so the first wrap switches the tone on immediately.
+    TIM3->CCR1 = 0;
+    TIM3->CCMR1 = (TIM3->CCMR1 & ~TIM_CCMR1_OC1M) | TIM_CCMR1_OC1M_FORCE_LOW;
+    TIM3->CCMR1 = (TIM3->CCMR1 & ~TIM_CCMR1_OC1M) | TIM_CCMR1_OC1M_TOGGLE;
+    TIM3->CR2 = (TIM3->CR2 & ~TIM_CR2_MMS) | TIM_CR2_MMS_OC1REF;
+    TIM3->CNT = TIM3->ARR;
     
-    return frequency;
+    // ARR preload: cadence changes take effect at the next half period
+    TIM3->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
 }
+#endif
 
 /**
  * @brief DAC1 Initialization (Channel 1 - PA5)
@@ -185,6 +821,10 @@ void DAC1_Init(void)
     // Enable DAC channel 1
     DAC->CR |= DAC_CR_EN1;
     
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+    // No trigger: DHR12R1 writes from TIM2_IRQHandler reach the pin directly
+    DAC->DHR12R1 = 2048;
+#else
     // Enable trigger for DAC channel 1 (TIM2 TRGO)
     DAC->CR |= DAC_CR_TEN1;
     
@@ -194,6 +834,7 @@ void DAC1_Init(void)
     // Set wave generation mode: Triangle wave
     DAC->CR |= DAC_CR_WAVE1_1; // Triangle wave generation
     DAC->CR |= (0 << DAC_CR_MAMP1_Pos); // Amplitude = 1 LSB
+#endif
 }
 
 /**
@@ -219,6 +860,13 @@ void TIM2_Init(uint32_t frequency)
     // Configure auto-reload register
     TIM2->ARR = period;
     
+#if OUTPUT_BACKEND == OUTPUT_BUZZER
+    // CH1 PWM mode 1 at 50% duty: square wave at the tone frequency
+    TIM2->CCMR1 = (TIM2->CCMR1 & ~TIM_CCMR1_OC1M) | TIM_CCMR1_OC1M_PWM1 | TIM_CCMR1_OC1PE;
+    TIM2->CCR1 = (period + 1) / 2;
+    TIM2->CCER |= TIM_CCER_CC1E;
+#endif
+    
     // Enable update event
     TIM2->EGR |= TIM_EGR_UG;
     
@@ -229,14 +877,178 @@ void TIM2_Init(uint32_t frequency)
     TIM2->CR1 |= TIM_CR1_CEN;
 }
 
+#if OUTPUT_BACKEND == OUTPUT_DAC_DDS
+/**
+ * @brief TIM2 as the DDS sample clock (update interrupt at DDS_SAMPLE_RATE)
+ */
+void TIM2_Sample_Init(void)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+    TIM2->CR1 = 0;
+    
+    TIM2->PSC = 0;
+    TIM2->ARR = 84000000UL / DDS_SAMPLE_RATE - 1;
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->SR = 0;
+    TIM2->DIER |= TIM_DIER_UIE;
+    
+    NVIC->IP[TIM2_IRQn] = 0x10;
+    NVIC->ISER[TIM2_IRQn >> 5] = 1UL << (TIM2_IRQn & 31);
+    TIM2->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief One DDS sample to the DAC
+ */
+void TIM2_IRQHandler(void)
+{
+    TIM2->SR = (uint32_t)~TIM_SR_UIF;
+    
+    uint32_t phase = tone_osc.phase;
+    int32_t mix = (DDS_Sine(phase) * tone_level) >> 15;
+#if FEATURE_BEAT
+    uint32_t reference = beat_osc.phase;
+    mix += (DDS_Sine(reference) * beat_level) >> 15;
+    beat_osc.phase = reference + beat_osc.increment;
+#endif
+#if FEATURE_LIMITER
+    mix = Limiter_Process(&mix_limiter, &limiter_config, mix);
+#endif
+    DAC->DHR12R1 = (uint32_t)(2048 + mix);
+    tone_osc.phase = phase + tone_osc.increment;
+}
+
+/**
+ * @brief Rebuild the count-to-increment table if the pitch range or the
+ *        mapped ADC span changed
+ * @note Builds take two divides and one pass over the table; between
+ *       configuration changes this is four compares per tick.
+ */
+void Tone_Table_Update(void)
+{
+    if (pipeline_config.min_freq == tone_table_min && pipeline_config.max_freq == tone_table_max &&
+        pipeline_config.adc_low == tone_table_adc_low && pipeline_config.adc_high == tone_table_adc_high) return;
+    
+    Pipeline_Build_Increment_Table(&pipeline_config, DDS_SAMPLE_RATE, tone_increments);
+    tone_table_min = pipeline_config.min_freq;
+    tone_table_max = pipeline_config.max_freq;
+    tone_table_adc_low = pipeline_config.adc_low;
+    tone_table_adc_high = pipeline_config.adc_high;
+#if FEATURE_BEAT
+    beat_osc.increment = tone_increments[beat_setpoint];
+#endif
+}
+
+#if FEATURE_BEAT
+/**
+ * @brief Move the setpoint (pitch of the reference voice)
+ * @param adc_value: Setpoint as a filtered ADC count (0-4095)
+ * @note A single store of the reference increment: the oscillator keeps its
+ *       phase, so the change is free of clicks and the beat rate follows on
+ *       the next sample.
+ */
+void Beat_Set_Setpoint(uint16_t adc_value)
+{
+    if (adc_value > PIPELINE_ADC_MAX) adc_value = PIPELINE_ADC_MAX;
+    beat_setpoint = adc_value;
+    beat_osc.increment = tone_increments[adc_value];
+}
+
+/**
+ * @brief Apply setpoint commands received on USART2
+ * @note "S<count>" ending in CR or LF, e.g. "S2300\n"; anything else is
+ *       dropped up to the next line end. Each accepted command is echoed as
+ *       "# setpoint=<count>".
+ */
+void Beat_Command_Poll(void)
+{
+    int c;
+    
+    while ((c = UART_Getc()) >= 0)
+    {
+        if (c == 'S' || c == 's')
+        {
+            beat_command_value = 0;
+            beat_command_digits = 1;
+        }
+        else if (c >= '0' && c <= '9' && beat_command_digits > 0 && beat_command_digits <= 4)
+        {
+            beat_command_value = (uint16_t)(beat_command_value * 10 + (c - '0'));
+            beat_command_digits++;
+        }
+        else if ((c == '\n' || c == '\r') && beat_command_digits > 1)
+        {
+            Beat_Set_Setpoint(beat_command_value);
+            UART_Puts("# setpoint=");
+            UART_Put_Uint(beat_setpoint);
+            UART_Putc('\n');
+            beat_command_digits = 0;
+        }
+        else
+        {
+            beat_command_digits = 0;
+        }
+    }
+}
+#endif
+#endif
+
+#if OUTPUT_BACKEND == OUTPUT_PIEZO_BRIDGE
+/**
+ * @brief TIM1 bridge drive: CH1 and CH1N in anti-phase across the piezo
+ * @param frequency: Initial tone in Hz
+ * @note Each leg swings 0-3.3 V in opposite phase, so the piezo sees 6.6 V
+ *       peak-to-peak. The dead-time keeps both legs from switching at the
+ *       same instant (needed when the pins drive an external bridge).
+ */
+void TIM1_Bridge_Init(uint32_t frequency)
+{
+    RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
+    TIM1->CR1 = 0;
+    
+    TIM1->PSC = 84000000UL / BRIDGE_TIMER_HZ - 1;
+    
+    // CH1 PWM mode 1, preloaded; CH1N is its complement
+    TIM1->CCMR1 = (TIM1->CCMR1 & ~TIM_CCMR1_OC1M) | TIM_CCMR1_OC1M_PWM1 | TIM_CCMR1_OC1PE;
+    TIM1->CCER |= TIM_CCER_CC1E | TIM_CCER_CC1NE;
+    TIM1->BDTR = (BRIDGE_DEAD_TIME << TIM_BDTR_DTG_Pos) | TIM_BDTR_OSSR | TIM_BDTR_OSSI;
+    
+    TIM1_Bridge_Set(frequency);
+    TIM1->EGR = TIM_EGR_UG;           // Load the preloaded ARR/CCR1 now
+    TIM1->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+}
+
+/**
+ * @brief Retune the bridge (no stop/restart, no glitch)
+ * @param frequency: Tone in Hz
+ * @note ARR and CCR1 are preloaded: both take effect together at the next
+ *       update event, so the running period always completes.
+ */
+void TIM1_Bridge_Set(uint32_t frequency)
+{
+    uint32_t period = BRIDGE_TIMER_HZ / frequency;
+    if (period > 0x10000UL) period = 0x10000UL;
+    if (period < 2) period = 2;
+    
+    TIM1->ARR = period - 1;
+    TIM1->CCR1 = period / 2;          // 50% duty
+    TIM1->BDTR |= TIM_BDTR_MOE;       // Outputs on (cleared for silence)
+}
+#endif
+
 /**
  * @brief Simple delay function
  * @param ms: Delay in milliseconds
  */
 void Delay_ms(uint32_t ms)
 {
+#ifdef HOST_SIMULATION
+    // Advance the virtual clock instead of spinning
+    Sim_Advance_Ms(ms);
+#else
     // Approximate delay (84 MHz system clock)
     for (volatile uint32_t i = 0; i < ms * 8400; i++);
+#endif
 }
 
 /**
@@ -0,0 +1,230 @@
+/**
+ * @file multirate.c
+ * @brief Multi-rate stage chain with polyphase decimators and interpolators
+ */
+
+#include "multirate.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief Round a Q15 accumulator and saturate to int16_t
+ */
+static inline int16_t Multirate_Q15(int32_t acc)
+{
+    acc = (acc + 0x4000) >> 15;
+    if (acc > 32767) return 32767;
+    if (acc < -32768) return -32768;
+    return (int16_t)acc;
+}
+
+/**
+ * @brief Design the link filter (windowed-sinc low-pass, Blackman window)
+ *
+ * Cut-off at 90% of the lower rate's Nyquist frequency. Decimator taps sum
+ * to one; interpolator taps are stored per polyphase branch, each branch
+ * summing to one, so a constant input gives a constant output.
+ */
+static void Multirate_Design(Multirate_Link *link)
+{
+    float h[MULTIRATE_MAX_TAPS];
+    const uint32_t n = link->taps;
+    const float fc = 0.45f / (float)link->factor;   // Cycles per high-rate sample
+    const float centre = 0.5f * (float)(n - 1);
+
+    for (uint32_t k = 0; k < n; k++)
+    {
+        float x = (float)k - centre;
+        float sinc = (x == 0.0f) ? 2.0f * fc : sinf(6.28318531f * fc * x) / (3.14159265f * x);
+        float w = (float)k / (float)(n - 1);
+        h[k] = sinc * (0.42f - 0.5f * cosf(6.28318531f * w) + 0.08f * cosf(12.5663706f * w));
+    }
+
+    // Number of branches and taps per branch (one branch when decimating)
+    const uint32_t branches = link->interpolate ? link->factor : 1;
+    const uint32_t per_branch = n / branches;
+    for (uint32_t p = 0; p < branches; p++)
+    {
+        float sum = 0.0f;
+        for (uint32_t q = 0; q < per_branch; q++) sum += h[p + q * branches];
+        for (uint32_t q = 0; q < per_branch; q++)
+        {
+            float c = h[p + q * branches] / sum * 32768.0f;
+            c = (c > 32767.0f) ? 32767.0f : ((c < -32768.0f) ? -32768.0f : c);
+            link->coeffs[p * per_branch + q] = (int16_t)lrintf(c);
+        }
+    }
+}
+
+/**
+ * @brief Resample one batch through a link
+ * @param link: Rate conversion between two stages
+ * @param in: Batch at the upstream rate
+ * @param count: Upstream samples (a multiple of the factor when decimating)
+ * @param out: Batch at the downstream rate
+ */
+static void Multirate_Convert(Multirate_Link *link, const int16_t *in, uint32_t count, int16_t *out)
+{
+    if (link->factor == 1)
+    {
+        memcpy(out, in, count * sizeof(int16_t));
+        return;
+    }
+
+    int16_t *work = link->work;
+    const uint32_t history = link->history;
+    const uint32_t factor = link->factor;
+    memcpy(work + history, in, count * sizeof(int16_t));
+
+    if (link->interpolate)
+    {
+        // Output phase p of input j only sees branch p: taps p, p + L, ...
+        for (uint32_t j = 0; j < count; j++)
+        {
+            const int16_t *x = work + history + j;
+            const int16_t *c = link->coeffs;
+            for (uint32_t p = 0; p < factor; p++)
+            {
+                int32_t acc = 0;
+                for (uint32_t q = 0; q < MULTIRATE_PHASE_TAPS; q++) acc += (int32_t)c[q] * x[-(int32_t)q];
+                *out++ = Multirate_Q15(acc);
+                c += MULTIRATE_PHASE_TAPS;
+            }
+        }
+    }
+    else
+    {
+        // Only every factor-th output is computed
+        const uint32_t taps = link->taps;
+        for (uint32_t o = 0; o < count / factor; o++)
+        {
+            const int16_t *x = work + history + o * factor + factor - 1;
+            int32_t acc = 0;
+            for (uint32_t k = 0; k < taps; k++) acc += (int32_t)link->coeffs[k] * x[-(int32_t)k];
+            *out++ = Multirate_Q15(acc);
+        }
+    }
+
+    // Keep the newest input samples for the next batch
+    memmove(work, work + count, history * sizeof(int16_t));
+}
+
+/**
+ * @brief Build a chain and its rate-conversion links
+ * @param chain: Chain to initialize
+ * @param stages: Stages in processing order (copied)
+ * @param count: Number of stages (1-MULTIRATE_MAX_STAGES)
+ * @param input_batch: Samples per batch at the first stage
+ * @return 0 on success, -1 if a rate ratio is not an integer up to
+ *         MULTIRATE_MAX_FACTOR or a batch does not divide evenly or fit
+ */
+int Multirate_Init(Multirate_Chain *chain, const Multirate_Stage *stages, uint8_t count, uint16_t input_batch)
+{
+    if (count == 0 || count > MULTIRATE_MAX_STAGES || input_batch == 0 || input_batch > MULTIRATE_MAX_BATCH) return -1;
+
+    memset(chain, 0, sizeof(*chain));
+    chain->stage_count = count;
+    chain->batch[0] = input_batch;
+
+    for (uint8_t s = 0; s < count; s++)
+    {
+        if (stages[s].rate_hz == 0) return -1;
+        chain->stage[s] = stages[s];
+    }
+
+    for (uint8_t s = 0; s + 1 < count; s++)
+    {
+        Multirate_Link *link = &chain->link[s];
+        uint32_t from = stages[s].rate_hz;
+        uint32_t to = stages[s + 1].rate_hz;
+        uint32_t batch;
+
+        if (from >= to)
+        {
+            if (from % to != 0) return -1;
+            link->factor = (uint16_t)(from / to);
+            if (chain->batch[s] % link->factor != 0) return -1;
+            batch = chain->batch[s] / link->factor;
+        }
+        else
+        {
+            if (to % from != 0) return -1;
+            link->factor = (uint16_t)(to / from);
+            link->interpolate = 1;
+            batch = (uint32_t)chain->batch[s] * link->factor;
+        }
+        if (link->factor > MULTIRATE_MAX_FACTOR || batch > MULTIRATE_MAX_BATCH) return -1;
+        chain->batch[s + 1] = (uint16_t)batch;
+
+        if (link->factor > 1)
+        {
+            link->taps = (uint16_t)(link->factor * MULTIRATE_PHASE_TAPS);
+            link->history = (uint16_t)(link->interpolate ? MULTIRATE_PHASE_TAPS - 1 : link->taps - 1);
+            Multirate_Design(link);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Run every stage once on a full input batch
+ * @param chain: Chain with batch[0] samples in buffer[0]
+ * @note Callers that fill buffer[0] themselves (e.g. from a DMA half
+ *       transfer) call this directly instead of Multirate_Push().
+ */
+void Multirate_Run_Batch(Multirate_Chain *chain)
+{
+    for (uint8_t s = 0; s < chain->stage_count; s++)
+    {
+        const Multirate_Stage *stage = &chain->stage[s];
+
+        if (stage->process != NULL) stage->process(stage->ctx, chain->buffer[s], chain->batch[s]);
+        if (s + 1 < chain->stage_count)
+        {
+            Multirate_Convert(&chain->link[s], chain->buffer[s], chain->batch[s], chain->buffer[s + 1]);
+        }
+    }
+    chain->fill = 0;
+}
+
+/**
+ * @brief Feed input samples; each completed batch runs the whole chain
+ * @param chain: Chain
+ * @param samples: Samples at the first stage's rate
+ * @param count: Number of samples (any, partial batches are kept)
+ * @return Number of batches run (new output is ready when nonzero)
+ */
+uint32_t Multirate_Push(Multirate_Chain *chain, const int16_t *samples, uint32_t count)
+{
+    uint32_t batches = 0;
+
+    while (count > 0)
+    {
+        uint32_t n = chain->batch[0] - chain->fill;
+        if (n > count) n = count;
+
+        memcpy(chain->buffer[0] + chain->fill, samples, n * sizeof(int16_t));
+        chain->fill = (uint16_t)(chain->fill + n);
+        samples += n;
+        count -= n;
+
+        if (chain->fill == chain->batch[0])
+        {
+            Multirate_Run_Batch(chain);
+            batches++;
+        }
+    }
+    return batches;
+}
+
+/**
+ * @brief Output of the last batch at the last stage
+ * @param chain: Chain
+ * @param count: Receives the number of samples (the last stage's batch)
+ * @return Samples in time order, the newest last
+ */
+const int16_t *Multirate_Output(const Multirate_Chain *chain, uint16_t *count)
+{
+    *count = chain->batch[chain->stage_count - 1];
+    return chain->buffer[chain->stage_count - 1];
+}
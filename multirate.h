@@ -0,0 +1,68 @@
+/**
+ * @file multirate.h
+ * @brief Multi-rate stage chain with polyphase decimators and interpolators
+ * @description Each stage declares the sample rate it runs at. Between two
+ *              stages with different rates the chain inserts a polyphase FIR
+ *              link: a decimator (anti-alias filter, only the kept outputs
+ *              are computed) or an interpolator (anti-image filter, one
+ *              polyphase branch per output phase, no multiplies by the
+ *              stuffed zeros).
+ *
+ * Samples are int16_t (ADC counts or Q15 audio). Input is collected into
+ * batches; every stage then runs once per batch on all of its samples (batch
+ * size scales with the stage rate), so the per-call overhead is paid once
+ * per batch instead of once per sample:
+ *
+ *   1 kHz acquisition --(/10)--> 100 Hz control --(/10)--> 10 Hz display
+ *   batch 100 samples            batch 10 samples         batch 1 sample
+ *
+ * Rate ratios between neighbouring stages must be integers up to
+ * MULTIRATE_MAX_FACTOR; larger ratios are split over several stages.
+ */
+
+#ifndef MULTIRATE_H
+#define MULTIRATE_H
+
+#include <stdint.h>
+
+#define MULTIRATE_MAX_STAGES   4
+#define MULTIRATE_MAX_BATCH    256  // Samples per stage per batch
+#define MULTIRATE_MAX_FACTOR   16   // Largest rate ratio between neighbouring stages
+#define MULTIRATE_PHASE_TAPS   8    // FIR taps per polyphase branch (filter = factor * 8 taps)
+#define MULTIRATE_MAX_TAPS     (MULTIRATE_MAX_FACTOR * MULTIRATE_PHASE_TAPS)
+
+// Stage body: processes one batch in place (NULL = pass-through)
+typedef void (*Multirate_Process)(void *ctx, int16_t *samples, uint32_t count);
+
+typedef struct {
+    const char *name;
+    uint32_t rate_hz;           // Sample rate the stage runs at
+    Multirate_Process process;
+    void *ctx;                  // Passed to process()
+} Multirate_Stage;
+
+// Rate conversion between stage k and stage k + 1
+typedef struct {
+    uint16_t factor;            // Rate ratio, 1 = same rate (copy)
+    uint8_t interpolate;        // 1: up by factor, 0: down by factor
+    uint16_t taps;              // FIR length (factor * MULTIRATE_PHASE_TAPS)
+    uint16_t history;           // Input samples kept between batches
+    int16_t coeffs[MULTIRATE_MAX_TAPS];                     // Q15 (polyphase order when interpolating)
+    int16_t work[MULTIRATE_MAX_TAPS + MULTIRATE_MAX_BATCH]; // History followed by the batch
+} Multirate_Link;
+
+typedef struct {
+    Multirate_Stage stage[MULTIRATE_MAX_STAGES];
+    Multirate_Link link[MULTIRATE_MAX_STAGES - 1];
+    uint8_t stage_count;
+    uint16_t batch[MULTIRATE_MAX_STAGES];   // Samples per batch at each stage
+    uint16_t fill;                          // Input samples waiting for the next batch
+    int16_t buffer[MULTIRATE_MAX_STAGES][MULTIRATE_MAX_BATCH];
+} Multirate_Chain;
+
+int Multirate_Init(Multirate_Chain *chain, const Multirate_Stage *stages, uint8_t count, uint16_t input_batch);
+uint32_t Multirate_Push(Multirate_Chain *chain, const int16_t *samples, uint32_t count);
+void Multirate_Run_Batch(Multirate_Chain *chain);
+const int16_t *Multirate_Output(const Multirate_Chain *chain, uint16_t *count);
+
+#endif /* MULTIRATE_H */
@@ -0,0 +1,129 @@
+/**
+ * @file packed12.c
+ * @brief Bit-packed 12-bit sample buffers (two samples per 3 bytes)
+ */
+
+#include "packed12.h"
+#include <string.h>
+
+/**
+ * @brief Attach storage to a packed buffer and clear it
+ * @param buffer: Buffer descriptor
+ * @param storage: At least PACKED12_BYTES(capacity) bytes
+ * @param capacity: Number of samples
+ */
+void Packed12_Init(Packed12_Buffer *buffer, uint8_t *storage, uint32_t capacity)
+{
+    buffer->data = storage;
+    buffer->capacity = capacity;
+    memset(storage, 0, PACKED12_BYTES(capacity));
+}
+
+/**
+ * @brief Pack a block of samples
+ * @param dst: Packed storage
+ * @param dst_index: Sample index of the first packed sample
+ * @param src: 16-bit samples (low 12 bits used)
+ * @param count: Number of samples
+ *
+ * Whole groups are written four at a time (8 samples -> 12 bytes) without
+ * read-modify-write; only an unaligned head or tail sample touches a
+ * shared byte.
+ */
+void Packed12_Pack(uint8_t *dst, uint32_t dst_index, const uint16_t *src, uint32_t count)
+{
+    Packed12_Buffer view = { dst, dst_index + count };
+
+    // Align to a group boundary
+    if ((dst_index & 1) && count > 0)
+    {
+        Packed12_Set(&view, dst_index++, *src++);
+        count--;
+    }
+
+    uint8_t *p = dst + (dst_index >> 1) * 3;
+
+    // 8 samples per iteration
+    while (count >= 8)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            uint16_t a = src[2 * k] & 0x0FFF;
+            uint16_t b = src[2 * k + 1] & 0x0FFF;
+            p[3 * k + 0] = (uint8_t)a;
+            p[3 * k + 1] = (uint8_t)((a >> 8) | (b << 4));
+            p[3 * k + 2] = (uint8_t)(b >> 4);
+        }
+        p += 12;
+        src += 8;
+        dst_index += 8;
+        count -= 8;
+    }
+
+    while (count >= 2)
+    {
+        uint16_t a = src[0] & 0x0FFF;
+        uint16_t b = src[1] & 0x0FFF;
+        p[0] = (uint8_t)a;
+        p[1] = (uint8_t)((a >> 8) | (b << 4));
+        p[2] = (uint8_t)(b >> 4);
+        p += 3;
+        src += 2;
+        dst_index += 2;
+        count -= 2;
+    }
+
+    if (count > 0)
+    {
+        Packed12_Set(&view, dst_index, *src);
+    }
+}
+
+/**
+ * @brief Unpack a block of samples
+ * @param dst: 16-bit output samples
+ * @param src: Packed storage
+ * @param src_index: Sample index of the first sample to unpack
+ * @param count: Number of samples
+ */
+void Packed12_Unpack(uint16_t *dst, const uint8_t *src, uint32_t src_index, uint32_t count)
+{
+    Packed12_Buffer view = { (uint8_t *)src, src_index + count };
+
+    if ((src_index & 1) && count > 0)
+    {
+        *dst++ = Packed12_Get(&view, src_index++);
+        count--;
+    }
+
+    const uint8_t *p = src + (src_index >> 1) * 3;
+
+    // 8 samples per iteration
+    while (count >= 8)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            dst[2 * k] = (uint16_t)(p[3 * k] | ((p[3 * k + 1] & 0x0F) << 8));
+            dst[2 * k + 1] = (uint16_t)((p[3 * k + 1] >> 4) | (p[3 * k + 2] << 4));
+        }
+        p += 12;
+        dst += 8;
+        src_index += 8;
+        count -= 8;
+    }
+
+    while (count >= 2)
+    {
+        dst[0] = (uint16_t)(p[0] | ((p[1] & 0x0F) << 8));
+        dst[1] = (uint16_t)((p[1] >> 4) | (p[2] << 4));
+        p += 3;
+        dst += 2;
+        src_index += 2;
+        count -= 2;
+    }
+
+    if (count > 0)
+    {
+        *dst = Packed12_Get(&view, src_index);
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * @file packed12.h
+ * @brief Bit-packed 12-bit sample buffers (two samples per 3 bytes)
+ * @description ADC readings only use 12 of the 16 bits of a uint16_t; packing
+ *              them saves 25% of RAM, so history and logging buffers hold a
+ *              third more samples in the same memory.
+ *
+ * Layout of samples a (even index) and b (odd index) in one 3-byte group:
+ *   byte 0 = a[7:0]
+ *   byte 1 = b[3:0] << 4 | a[11:8]
+ *   byte 2 = b[11:4]
+ */
+
+#ifndef PACKED12_H
+#define PACKED12_H
+
+#include <stdint.h>
+
+// Bytes needed to store n samples
+#define PACKED12_BYTES(n)      ((((uint32_t)(n) + 1) / 2) * 3)
+
+typedef struct {
+    uint8_t *data;          // PACKED12_BYTES(capacity) bytes of storage
+    uint32_t capacity;      // Number of samples
+} Packed12_Buffer;
+
+// Sequential reader over a packed buffer
+typedef struct {
+    const uint8_t *group;   // Current 3-byte group
+    uint32_t odd;           // 1 when the next sample is the odd one of the group
+} Packed12_Iter;
+
+void Packed12_Init(Packed12_Buffer *buffer, uint8_t *storage, uint32_t capacity);
+void Packed12_Pack(uint8_t *dst, uint32_t dst_index, const uint16_t *src, uint32_t count);
+void Packed12_Unpack(uint16_t *dst, const uint8_t *src, uint32_t src_index, uint32_t count);
+
+/**
+ * @brief Read one sample
+ * @param buffer: Packed buffer
+ * @param index: Sample index (< capacity)
+ * @return 12-bit sample
+ */
+static inline uint16_t Packed12_Get(const Packed12_Buffer *buffer, uint32_t index)
+{
+    const uint8_t *p = buffer->data + (index >> 1) * 3;
+
+    if (index & 1) return (uint16_t)((p[1] >> 4) | ((uint16_t)p[2] << 4));
+    return (uint16_t)(p[0] | ((uint16_t)(p[1] & 0x0F) << 8));
+}
+
+/**
+ * @brief Write one sample
+ * @param buffer: Packed buffer
+ * @param index: Sample index (< capacity)
+ * @param value: Sample (only the low 12 bits are stored)
+ */
+static inline void Packed12_Set(Packed12_Buffer *buffer, uint32_t index, uint16_t value)
+{
+    uint8_t *p = buffer->data + (index >> 1) * 3;
+
+    if (index & 1)
+    {
+        p[1] = (uint8_t)((p[1] & 0x0F) | ((value & 0x0F) << 4));
+        p[2] = (uint8_t)(value >> 4);
+    }
+    else
+    {
+        p[0] = (uint8_t)value;
+        p[1] = (uint8_t)((p[1] & 0xF0) | ((value >> 8) & 0x0F));
+    }
+}
+
+/**
+ * @brief Start reading at a sample index
+ */
+static inline Packed12_Iter Packed12_Iter_Begin(const Packed12_Buffer *buffer, uint32_t index)
+{
+    Packed12_Iter it;
+    it.group = buffer->data + (index >> 1) * 3;
+    it.odd = index & 1;
+    return it;
+}
+
+/**
+ * @brief Read the next sample and advance
+ */
+static inline uint16_t Packed12_Iter_Next(Packed12_Iter *it)
+{
+    const uint8_t *p = it->group;
+
+    if (it->odd)
+    {
+        it->group += 3;
+        it->odd = 0;
+        return (uint16_t)((p[1] >> 4) | ((uint16_t)p[2] << 4));
+    }
+    it->odd = 1;
+    return (uint16_t)(p[0] | ((uint16_t)(p[1] & 0x0F) << 8));
+}
+
+#endif /* PACKED12_H */
@@ -0,0 +1,143 @@
+/**
+ * @file pipeline.c
+ * @brief ADC-to-frequency control pipeline (filter, mapping, glide, dead-band)
+ */
+
+#include "config.h"
+#include "pipeline.h"
+#include <math.h>
+#include <stdlib.h>
+
+#if FEATURE_FILTER
+/**
+ * @brief Low-pass coefficient for a given cut-off frequency
+ * @param cutoff_hz: -3 dB cut-off (0 or >= Nyquist disables the filter)
+ * @param step_rate_hz: Rate at which Pipeline_Step() is called
+ * @return One-pole coefficient in Q16
+ */
+uint32_t Pipeline_Alpha_From_Cutoff(float cutoff_hz, float step_rate_hz)
+{
+    if (cutoff_hz <= 0.0f || cutoff_hz >= step_rate_hz * 0.5f) return PIPELINE_Q16_ONE;
+
+    float alpha = 1.0f - expf(-2.0f * 3.14159265f * cutoff_hz / step_rate_hz);
+    uint32_t q16 = (uint32_t)(alpha * (float)PIPELINE_Q16_ONE + 0.5f);
+    return (q16 == 0) ? 1 : q16;
+}
+
+/**
+ * @brief Glide coefficient for a given time constant
+ * @param time_ms: Glide time constant (0 = instant)
+ * @param step_ms: Interval between Pipeline_Step() calls
+ * @return One-pole coefficient in Q16
+ */
+uint32_t Pipeline_Alpha_From_Time(float time_ms, float step_ms)
+{
+    if (time_ms <= 0.0f) return PIPELINE_Q16_ONE;
+
+    float alpha = 1.0f - expf(-step_ms / time_ms);
+    uint32_t q16 = (uint32_t)(alpha * (float)PIPELINE_Q16_ONE + 0.5f);
+    return (q16 == 0) ? 1 : q16;
+}
+#endif
+
+/**
+ * @brief Map an ADC value to a frequency
+ * @param cfg: Pipeline configuration
+ * @param adc_value: ADC reading (0-4095)
+ * @return Frequency in Hz (min_freq..max_freq)
+ */
+uint32_t Pipeline_Map(const Pipeline_Config *cfg, uint16_t adc_value)
+{
+    if (adc_value <= cfg->adc_low) return cfg->min_freq;
+    if (adc_value >= cfg->adc_high) return cfg->max_freq;
+    return cfg->min_freq + ((uint32_t)(adc_value - cfg->adc_low) * (cfg->max_freq - cfg->min_freq)) /
+                           (uint32_t)(cfg->adc_high - cfg->adc_low);
+}
+
+/**
+ * @brief Tabulate the map as DDS phase increments, one entry per ADC count
+ * @param cfg: Pipeline configuration (min_freq/max_freq below 32768 Hz)
+ * @param sample_rate: Output samples per second
+ * @param table: PIPELINE_TABLE_SIZE entries, table[adc] = phase advance per
+ *               sample (2^32 = one turn) of the mapped pitch
+ *
+ * Rebuild only when the ranges or the sample rate change; a retune is then
+ * table[adc] instead of a map and a 64-bit divide. Entries are the exact
+ * (unrounded) linear map, accumulated in Q16 from two divides.
+ */
+void Pipeline_Build_Increment_Table(const Pipeline_Config *cfg, uint32_t sample_rate, uint32_t *table)
+{
+    uint64_t increment_q16 = ((uint64_t)cfg->min_freq << 48) / sample_rate;
+    int64_t step_q16 = (int64_t)((((int64_t)cfg->max_freq - (int64_t)cfg->min_freq) * ((int64_t)1 << 48)) /
+                                 (int64_t)(cfg->adc_high - cfg->adc_low)) / (int64_t)sample_rate;
+
+    // Flat below adc_low and above adc_high, like Pipeline_Map()
+    for (uint32_t adc = 0; adc < PIPELINE_TABLE_SIZE; adc++)
+    {
+        table[adc] = (uint32_t)((increment_q16 + 0x8000) >> 16);
+        if (adc >= cfg->adc_low && adc < cfg->adc_high) increment_q16 += (uint64_t)step_q16;
+    }
+}
+
+/**
+ * @brief Initialize pipeline state
+ * @param state: State to initialize
+ * @param cfg: Pipeline configuration
+ * @param frequency: Frequency currently programmed into the output
+ *
+ * The input filter is primed with the first sample passed to Pipeline_Step().
+ */
+void Pipeline_Init(Pipeline_State *state, const Pipeline_Config *cfg, uint32_t frequency)
+{
+    (void)cfg;
+    state->filtered_q16 = -1;
+    state->glide_q8 = (int32_t)(frequency << 8);
+    state->frequency = frequency;
+}
+
+/**
+ * @brief Process one control step
+ * @param state: Pipeline state
+ * @param cfg: Pipeline configuration
+ * @param adc_value: New ADC reading (0-4095)
+ * @return 1 if state->frequency changed and the output must be retuned, else 0
+ */
+int Pipeline_Step(Pipeline_State *state, const Pipeline_Config *cfg, uint16_t adc_value)
+{
+    int32_t input_q16 = (int32_t)adc_value << 16;
+
+#if FEATURE_FILTER
+    // One-pole low-pass on the raw ADC value
+    if (state->filtered_q16 < 0)
+    {
+        state->filtered_q16 = input_q16;
+    }
+    else
+    {
+        int64_t delta = (int64_t)(input_q16 - state->filtered_q16) * cfg->filter_alpha;
+        state->filtered_q16 += (int32_t)(delta >> 16);
+    }
+
+    // Map filtered value to the target pitch
+    uint32_t target = Pipeline_Map(cfg, (uint16_t)((state->filtered_q16 + 0x8000) >> 16));
+
+    // Exponential glide towards the target pitch
+    int64_t delta = ((int64_t)(target << 8) - state->glide_q8) * cfg->glide_alpha;
+    state->glide_q8 += (int32_t)(delta >> 16);
+    uint32_t glided = (uint32_t)((state->glide_q8 + 0x80) >> 8);
+#else
+    // Filter and glide compiled out: map the raw reading directly
+    state->filtered_q16 = input_q16;
+    uint32_t glided = Pipeline_Map(cfg, adc_value);
+    state->glide_q8 = (int32_t)(glided << 8);
+#endif
+
+    // Update frequency if changed significantly (avoid constant updates)
+    if ((uint32_t)abs((int32_t)glided - (int32_t)state->frequency) > cfg->deadband_hz)
+    {
+        state->frequency = glided;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file pipeline.h
+ * @brief ADC-to-frequency control pipeline (filter, mapping, glide, dead-band)
+ * @description Reentrant version of the main loop processing so the same code
+ *              runs on the target, in the host simulation and in host tools.
+ *
+ * Per control step:
+ *   ADC count -> low-pass filter -> linear map (adc_low..adc_high onto
+ *   min..max Hz, clamped outside) -> pitch glide
+ *   -> retune only if the glided pitch moved more than the dead-band
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+
+#define PIPELINE_ADC_MAX       4095
+#define PIPELINE_Q16_ONE       65536UL  // Coefficient meaning "pass through"
+#define PIPELINE_TABLE_SIZE    (PIPELINE_ADC_MAX + 1)
+
+typedef struct {
+    uint32_t min_freq;      // Frequency at adc_low and below (Hz)
+    uint32_t max_freq;      // Frequency at adc_high and above (Hz)
+    uint32_t deadband_hz;   // Retune only when the pitch moved more than this
+    uint32_t filter_alpha;  // Input low-pass coefficient, Q16 (65536 = off)
+    uint32_t glide_alpha;   // Pitch glide coefficient, Q16 (65536 = instant)
+    uint16_t adc_low;       // ADC span mapped onto min..max (adc_low < adc_high)
+    uint16_t adc_high;
+} Pipeline_Config;
+
+typedef struct {
+    int32_t filtered_q16;   // Filtered ADC value, Q16
+    int32_t glide_q8;       // Gliding frequency, Q8 Hz
+    uint32_t frequency;     // Frequency currently programmed (Hz)
+} Pipeline_State;
+
+// Default configuration: full ADC span to 200-2000 Hz, 5 Hz dead-band, no filter, no glide
+#define PIPELINE_CONFIG_DEFAULT { 200, 2000, 5, PIPELINE_Q16_ONE, PIPELINE_Q16_ONE, 0, PIPELINE_ADC_MAX }
+
+uint32_t Pipeline_Alpha_From_Cutoff(float cutoff_hz, float step_rate_hz);
+uint32_t Pipeline_Alpha_From_Time(float time_ms, float step_ms);
+
+uint32_t Pipeline_Map(const Pipeline_Config *cfg, uint16_t adc_value);
+void Pipeline_Init(Pipeline_State *state, const Pipeline_Config *cfg, uint32_t frequency);
+int Pipeline_Step(Pipeline_State *state, const Pipeline_Config *cfg, uint16_t adc_value);
+void Pipeline_Build_Increment_Table(const Pipeline_Config *cfg, uint32_t sample_rate, uint32_t *table);
+
+#endif /* PIPELINE_H */
@@ -0,0 +1,76 @@
+/**
+ * @file policy.c
+ * @brief Table-driven multi-zone alarm policy
+ */
+
+#include "policy.h"
+
+/**
+ * @brief Zone containing an ADC count (table order, clamped to 0-4095)
+ */
+static uint8_t Policy_Zone_Of(const Policy_Zone *zones, uint8_t zone_count, int32_t adc_value)
+{
+    if (adc_value < 0) adc_value = 0;
+    if (adc_value >= POLICY_LUT_SIZE) adc_value = POLICY_LUT_SIZE - 1;
+
+    uint8_t zone = 0;
+    while (zone < zone_count - 1 && adc_value > zones[zone].adc_high) zone++;
+    return zone;
+}
+
+/**
+ * @brief Compile a zone table into the ADC lookup
+ * @param table: Destination
+ * @param zones: Zone descriptions, ascending by adc_high, last ends at 4095
+ * @param zone_count: Number of zones (1-16)
+ * @param hysteresis: Counts a reading must pass a boundary by to change zone
+ * @return 0 on success, -1 if the zone table is invalid
+ */
+int Policy_Compile(Policy_Table *table, const Policy_Zone *zones, uint8_t zone_count, uint16_t hysteresis)
+{
+    if (zone_count == 0 || zone_count > POLICY_MAX_ZONES) return -1;
+    if (zones[zone_count - 1].adc_high != POLICY_LUT_SIZE - 1) return -1;
+    for (uint8_t i = 1; i < zone_count; i++)
+    {
+        // Zones must be wider than the hysteresis band on both sides
+        if (zones[i].adc_high <= zones[i - 1].adc_high + 2 * hysteresis) return -1;
+    }
+
+    for (int32_t adc = 0; adc < POLICY_LUT_SIZE; adc++)
+    {
+        uint8_t rising = Policy_Zone_Of(zones, zone_count, adc - hysteresis);
+        uint8_t falling = Policy_Zone_Of(zones, zone_count, adc + hysteresis);
+        table->lut[adc] = (uint8_t)(rising | (falling << 4));
+    }
+
+    table->zones = zones;
+    table->zone_count = zone_count;
+    return 0;
+}
+
+/**
+ * @brief Tone a zone's output pattern plays on a given tick
+ * @param zone: Zone description
+ * @param tick: Main loop tick counter
+ * @param temperature_hz: Current temperature tone
+ * @return Frequency in Hz, 0 = silent
+ */
+uint32_t Policy_Tone(const Policy_Zone *zone, uint32_t tick, uint32_t temperature_hz)
+{
+    uint32_t tone = (zone->tone_hz != 0) ? zone->tone_hz : temperature_hz;
+    uint32_t first_half = (zone->period_ticks == 0) ||
+                          ((tick % zone->period_ticks) < (uint32_t)(zone->period_ticks / 2));
+
+    switch (zone->action)
+    {
+        case POLICY_TONE:
+            return tone;
+        case POLICY_PULSE:
+            return first_half ? tone : 0;
+        case POLICY_SIREN:
+            return first_half ? tone : (tone * 3) / 4;
+        case POLICY_SILENT:
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * @file policy.h
+ * @brief Table-driven multi-zone alarm policy
+ * @description Temperature zones, their hysteresis and their output patterns
+ *              are described by a small table that Policy_Compile() turns
+ *              into a direct ADC count -> zone lookup.
+ *
+ * Zones are listed in ascending order by their upper ADC bound; the last
+ * zone must end at 4095. Each LUT byte holds two zone indices:
+ *   low nibble  - zone reached when rising to this count (count - hysteresis)
+ *   high nibble - zone reached when falling to this count (count + hysteresis)
+ * A zone change therefore needs the reading to cross a boundary by more than
+ * the hysteresis, and evaluation is one load plus two compares.
+ */
+
+#ifndef POLICY_H
+#define POLICY_H
+
+#include <stdint.h>
+
+#define POLICY_MAX_ZONES       16
+#define POLICY_LUT_SIZE        4096
+
+// Output actions
+#define POLICY_SILENT          0  // No output
+#define POLICY_TONE            1  // Continuous temperature tone
+#define POLICY_PULSE           2  // Tone switched on/off every half period
+#define POLICY_SIREN           3  // Alternates tone_hz and 3/4 tone_hz every half period
+
+typedef struct {
+    uint16_t adc_high;      // Upper bound of the zone (inclusive)
+    uint8_t action;         // POLICY_* output action
+    uint8_t amplitude;      // DAC triangle amplitude (MAMP1 field, 0-11)
+    uint16_t period_ticks;  // Pattern period in main loop ticks (pulse/siren)
+    uint16_t tone_hz;       // Fixed tone, 0 = follow temperature
+} Policy_Zone;
+
+typedef struct {
+    const Policy_Zone *zones;
+    uint8_t zone_count;
+    uint8_t lut[POLICY_LUT_SIZE];
+} Policy_Table;
+
+int Policy_Compile(Policy_Table *table, const Policy_Zone *zones, uint8_t zone_count, uint16_t hysteresis);
+uint32_t Policy_Tone(const Policy_Zone *zone, uint32_t tick, uint32_t temperature_hz);
+
+/**
+ * @brief Evaluate the policy for one reading
+ * @param table: Compiled policy
+ * @param zone: Current zone index
+ * @param adc_value: ADC reading (0-4095)
+ * @return New zone index
+ */
+static inline uint8_t Policy_Evaluate(const Policy_Table *table, uint8_t zone, uint16_t adc_value)
+{
+    uint8_t entry = table->lut[adc_value & (POLICY_LUT_SIZE - 1)];
+    uint8_t rising = entry & 0x0F;
+    uint8_t falling = entry >> 4;
+
+    if (zone < rising) return rising;
+    if (zone > falling) return falling;
+    return zone;
+}
+
+#endif /* POLICY_H */
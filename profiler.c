@@ -0,0 +1,219 @@
+/**
+ * @file profiler.c
+ * @brief Statistical PC-sampling profiler
+ */
+
+#ifdef HOST_SIMULATION
+#define _GNU_SOURCE  // REG_RIP / REG_EIP in <ucontext.h>
+#endif
+
+#include "stm32f4xx.h"
+#include "config.h"
+#include "profiler.h"
+#include "uart.h"
+
+#ifdef HOST_SIMULATION
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#endif
+
+#define PROFILER_TIMER_HZ      84000000UL  // TIM5 kernel clock (2 x APB1)
+
+// Histogram of the current window; written only by the sampling interrupt
+static volatile Profiler_Bin profiler_bins[PROFILER_BINS];
+static volatile uint32_t profiler_samples;
+static volatile uint32_t profiler_dropped;
+
+/**
+ * @brief Count one sample
+ * @param pc: Interrupted program counter
+ */
+void Profiler_Record(uintptr_t pc)
+{
+    pc &= ~(uintptr_t)1;  // Thumb bit
+    uint32_t slot = ((uint32_t)(pc >> 1) * 2654435761UL) & (PROFILER_BINS - 1);
+
+    profiler_samples++;
+    for (uint32_t probe = 0; probe < PROFILER_PROBES; probe++)
+    {
+        volatile Profiler_Bin *bin = &profiler_bins[(slot + probe) & (PROFILER_BINS - 1)];
+        if (bin->pc == pc)
+        {
+            bin->count++;
+            return;
+        }
+        if (bin->pc == 0)
+        {
+            bin->pc = pc;
+            bin->count = 1;
+            return;
+        }
+    }
+    profiler_dropped++;
+}
+
+#if defined(HOST_SIMULATION)
+/**
+ * @brief SIGPROF handler: sample the interrupted host PC
+ */
+static void Profiler_Signal(int sig, siginfo_t *info, void *context)
+{
+    const ucontext_t *uc = (const ucontext_t *)context;
+    (void)sig;
+    (void)info;
+#if defined(__x86_64__)
+    Profiler_Record((uintptr_t)uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__i386__)
+    Profiler_Record((uintptr_t)uc->uc_mcontext.gregs[REG_EIP]);
+#elif defined(__aarch64__)
+    Profiler_Record((uintptr_t)uc->uc_mcontext.pc);
+#else
+    (void)uc;
+    profiler_dropped++;
+#endif
+}
+#elif FEATURE_PROFILER && defined(STM32_TARGET_COMPILATION) && defined(__GNUC__) && \
+      (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+void Profiler_Tick(uint32_t pc);
+
+/**
+ * @brief TIM5 update interrupt (only linked when the profiler is enabled, so
+ *        the vector table does not pull the histogram into other builds)
+ * @note Picks the stack the exception frame was pushed to (EXC_RETURN bit 2)
+ *       and loads the stacked PC (frame offset 24), then tail-calls
+ *       Profiler_Tick() with LR still holding EXC_RETURN.
+ */
+__attribute__((naked)) void TIM5_IRQHandler(void)
+{
+    __asm__ volatile(
+        "tst   lr, #4        \n"
+        "ite   eq            \n"
+        "mrseq r0, msp       \n"
+        "mrsne r0, psp       \n"
+        "ldr   r0, [r0, #24] \n"
+        "b     Profiler_Tick \n");
+}
+
+void Profiler_Tick(uint32_t pc)
+{
+    TIM5->SR = ~TIM_SR_UIF;
+    Profiler_Record(pc);
+}
+#endif
+
+/**
+ * @brief Start sampling at PROFILER_HZ
+ */
+void Profiler_Start(void)
+{
+#ifdef HOST_SIMULATION
+    struct sigaction action;
+    struct itimerval timer;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = Profiler_Signal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, NULL);
+
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000000 / PROFILER_HZ;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, NULL);
+#else
+    RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
+
+    TIM5->CR1 = 0;
+    TIM5->PSC = 0;
+    TIM5->ARR = PROFILER_TIMER_HZ / PROFILER_HZ - 1;
+    TIM5->EGR = TIM_EGR_UG;
+    TIM5->SR = 0;
+    TIM5->DIER = TIM_DIER_UIE;
+
+    // Highest priority so samples land inside other interrupt handlers too
+    NVIC->IP[TIM5_IRQn] = 0;
+    NVIC->ISER[TIM5_IRQn >> 5] = 1UL << (TIM5_IRQn & 31);
+
+    TIM5->CR1 = TIM_CR1_CEN;
+#endif
+}
+
+/**
+ * @brief Stop sampling
+ */
+void Profiler_Stop(void)
+{
+#ifdef HOST_SIMULATION
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, NULL);
+#else
+    TIM5->CR1 &= ~TIM_CR1_CEN;
+    NVIC->ICER[TIM5_IRQn >> 5] = 1UL << (TIM5_IRQn & 31);
+#endif
+}
+
+/**
+ * @brief Hold off samples without restarting the sampling period
+ */
+static void Profiler_Mask(int masked)
+{
+#ifdef HOST_SIMULATION
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPROF);
+    sigprocmask(masked ? SIG_BLOCK : SIG_UNBLOCK, &set, NULL);
+#else
+    if (masked) NVIC->ICER[TIM5_IRQn >> 5] = 1UL << (TIM5_IRQn & 31);
+    else NVIC->ISER[TIM5_IRQn >> 5] = 1UL << (TIM5_IRQn & 31);
+#endif
+}
+
+/**
+ * @brief Send an address (8 hex digits, 16 on a 64-bit host)
+ */
+static void Profiler_Put_Addr(uintptr_t addr)
+{
+#if UINTPTR_MAX > 0xFFFFFFFFUL
+    UART_Put_Hex((uint32_t)((uint64_t)addr >> 32));
+#endif
+    UART_Put_Hex((uint32_t)addr);
+}
+
+/**
+ * @brief Stream the current window over the debug UART and start a new one
+ * @note Samples are held off while the report is sent, so the (blocking)
+ *       UART output does not show up in the profile.
+ */
+void Profiler_Report(void)
+{
+    Profiler_Mask(1);
+
+    UART_Puts("# pcprof version=1 hz=");
+    UART_Put_Uint(PROFILER_HZ);
+    UART_Puts(" samples=");
+    UART_Put_Uint(profiler_samples);
+    UART_Puts(" dropped=");
+    UART_Put_Uint(profiler_dropped);
+    UART_Puts(" anchor=");
+    Profiler_Put_Addr((uintptr_t)&Profiler_Start);
+    UART_Puts("\npc,count\n");
+
+    for (uint32_t i = 0; i < PROFILER_BINS; i++)
+    {
+        if (profiler_bins[i].pc == 0) continue;
+        Profiler_Put_Addr(profiler_bins[i].pc);
+        UART_Putc(',');
+        UART_Put_Uint(profiler_bins[i].count);
+        UART_Putc('\n');
+        profiler_bins[i].pc = 0;
+        profiler_bins[i].count = 0;
+    }
+    UART_Puts("# end\n");
+
+    profiler_samples = 0;
+    profiler_dropped = 0;
+    Profiler_Mask(0);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file profiler.h
+ * @brief Statistical PC-sampling profiler
+ * @description TIM5 interrupts the firmware at PROFILER_HZ with the highest
+ *              priority; the handler reads the interrupted program counter
+ *              from the exception stack frame and counts it in a small hash
+ *              histogram. Profiler_Report() streams the histogram over the
+ *              debug UART and starts a new window:
+ *
+ *   # pcprof version=1 hz=997 samples=9970 dropped=0 anchor=08000411
+ *   pc,count
+ *   08000a3c,812
+ *   ...
+ *   # end
+ *
+ * tools/pcprof resolves the addresses against the firmware ELF and prints a
+ * per-function profile. "anchor" is the run-time address of Profiler_Start,
+ * which lets the tool undo the load offset of a position-independent host
+ * build. In the host simulation the samples come from SIGPROF (ITIMER_PROF,
+ * process CPU time) and the PC is taken from the signal context, so the same
+ * report and tool work on the host.
+ *
+ * Enable with -DFEATURE_PROFILER=1 (off in every profile by default).
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+#define PROFILER_HZ            997   // Prime, so sampling does not lock onto periodic work
+#define PROFILER_BINS          256   // Distinct PCs per window (power of two)
+#define PROFILER_PROBES        8     // Linear probe limit before a sample is dropped
+#define PROFILER_REPORT_TICKS  100   // Main loop ticks per report window (10 s)
+
+typedef struct {
+    uintptr_t pc;           // Sampled address (Thumb bit cleared), 0 = empty
+    uint32_t count;         // Samples at this address
+} Profiler_Bin;
+
+void Profiler_Start(void);
+void Profiler_Stop(void);
+void Profiler_Record(uintptr_t pc);
+void Profiler_Report(void);
+
+#endif /* PROFILER_H */
@@ -0,0 +1,36 @@
+#!/usr/bin/env python3
+"""Local server for the web simulation (index.html).
+
+Serves the repository directory with the cross-origin isolation headers
+(COOP/COEP) that browsers require before SharedArrayBuffer is available, so
+the page can use its shared-memory AudioWorklet path. Without them the page
+falls back to a plain OscillatorNode.
+
+Usage: python3 serve.py [port]   (default 8000), then open http://localhost:8000
+"""
+
+import functools
+import http.server
+import os
+import sys
+
+
+class IsolatedHandler(http.server.SimpleHTTPRequestHandler):
+    def end_headers(self):
+        self.send_header("Cross-Origin-Opener-Policy", "same-origin")
+        self.send_header("Cross-Origin-Embedder-Policy", "require-corp")
+        self.send_header("Cache-Control", "no-cache")
+        super().end_headers()
+
+
+def main():
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 8000
+    root = os.path.dirname(os.path.abspath(__file__))
+    handler = functools.partial(IsolatedHandler, directory=root)
+    with http.server.ThreadingHTTPServer(("localhost", port), handler) as server:
+        print(f"Serving {root} at http://localhost:{port} (cross-origin isolated)")
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
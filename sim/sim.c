@@ -0,0 +1,221 @@
+/**
+ * @file sim.c
+ * @brief Host simulation of the STM32 device used by main.c
+ * @description RAM-backed register blocks, virtual clock and device snapshots
+ */
+
+#include "../stm32f4xx.h"
+#include "sim.h"
+#include <string.h>
+
+#ifndef HOST_SIMULATION
+#error "sim.c must be compiled with -DHOST_SIMULATION"
+#endif
+
+// Peripheral register blocks (referenced by the stm32f4xx.h instance macros)
+SIM_Peripherals sim_periph;
+
+// Virtual clock in core cycles
+static uint64_t sim_cycles;
+
+// Bounds of the firmware sim_ram section (provided by the GNU linker)
+extern uint8_t __start_sim_ram[] __attribute__((weak));
+extern uint8_t __stop_sim_ram[] __attribute__((weak));
+
+/**
+ * @brief Size of the sim_ram section
+ */
+static size_t Sim_Ram_Size(void)
+{
+    if (__start_sim_ram == NULL || __stop_sim_ram == NULL) return 0;
+    return (size_t)(__stop_sim_ram - __start_sim_ram);
+}
+
+/**
+ * @brief Reset all simulated peripherals to their power-on state
+ *
+ * Status flags that real hardware sets on its own (oscillator ready, clock
+ * switch status, ADC end of conversion, UART transmitter empty) are preset
+ * so the firmware's busy-wait loops complete immediately.
+ */
+void Sim_Reset(void)
+{
+    memset(&sim_periph, 0, sizeof(sim_periph));
+    sim_cycles = 0;
+
+    RCC->CR = RCC_CR_HSERDY | RCC_CR_PLLRDY;
+    RCC->CFGR = RCC_CFGR_SWS_PLL;
+    ADC1->SR = ADC_SR_EOC;
+    USART2->SR = USART_SR_TXE | USART_SR_TC;
+}
+
+/**
+ * @brief Drive the simulated temperature sensor
+ * @param adc_value: Conversion result returned by the next ADC read (0-4095)
+ */
+void Sim_Set_Adc_Input(uint16_t adc_value)
+{
+    ADC1->DR = adc_value & 0x0FFF;
+    ADC1->SR |= ADC_SR_EOC;
+}
+
+/**
+ * @brief Complete one simultaneous conversion on ADC1..ADCn
+ * @param values: Conversion result per ADC (values[0] = ADC1)
+ * @param count: Number of ADCs converting (2 or 3)
+ *
+ * Emulates the common data register and, when DMA2 Stream0 is enabled,
+ * the DMA transfer(s) into memory including circular NDTR reload.
+ */
+void Sim_Adc_Multi_Convert(const uint16_t *values, uint8_t count)
+{
+    ADC_TypeDef *adcs[3] = { ADC1, ADC2, ADC3 };
+    DMA_Stream_TypeDef *stream = DMA2_Stream0;
+
+    if (count > 3) count = 3;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        adcs[i]->DR = values[i] & 0x0FFF;
+        adcs[i]->SR |= ADC_SR_EOC;
+    }
+    ADC123_COMMON->CDR = (ADC1->DR & 0xFFFF) | (ADC2->DR << 16);
+
+    if (!(stream->CR & DMA_SxCR_EN) || stream->M0AR == 0) return;
+
+    uint32_t msize = (stream->CR >> DMA_SxCR_MSIZE_Pos) & 3UL;
+    uint32_t transfers = (msize == DMA_SxCR_SIZE_32) ? 1 : count;
+    uint32_t *reload = &sim_periph.dma2_stream0_reload;
+
+    // NDTR reloads with its programmed value in circular mode
+    if (stream->NDTR > *reload) *reload = stream->NDTR;
+
+    for (uint32_t i = 0; i < transfers && stream->NDTR > 0; i++)
+    {
+        uint32_t index = *reload - stream->NDTR;
+        if (msize == DMA_SxCR_SIZE_32)
+        {
+            ((uint32_t *)stream->M0AR)[index] = ADC123_COMMON->CDR;
+        }
+        else
+        {
+            ((uint16_t *)stream->M0AR)[index] = (uint16_t)(adcs[i]->DR & 0xFFFF);
+        }
+
+        if (--stream->NDTR == 0 && (stream->CR & DMA_SxCR_CIRC)) stream->NDTR = *reload;
+    }
+}
+
+/**
+ * @brief Deliver one byte to the USART2 receiver
+ * @param byte: Received byte
+ *
+ * Sets RXNE like the hardware does; as with the sample timer, the test
+ * driver then calls USART2_IRQHandler() itself. With the receiver off
+ * (CR1 RE clear) the byte is lost, as on the device.
+ */
+void Sim_Uart_Receive(uint8_t byte)
+{
+    if (!(USART2->CR1 & USART_CR1_RE)) return;
+    USART2->DR = byte;
+    USART2->SR |= USART_SR_RXNE;
+}
+
+/**
+ * @brief Advance the virtual clock
+ * @param cycles: Number of core clock cycles
+ */
+void Sim_Advance_Cycles(uint64_t cycles)
+{
+    sim_cycles += cycles;
+    TIM2->CNT = (uint32_t)(sim_cycles % ((uint64_t)TIM2->ARR + 1));
+}
+
+/**
+ * @brief Advance the virtual clock
+ * @param ms: Number of milliseconds
+ */
+void Sim_Advance_Ms(uint32_t ms)
+{
+    Sim_Advance_Cycles((uint64_t)ms * (SIM_CORE_CLOCK_HZ / 1000));
+}
+
+/**
+ * @brief Current virtual clock
+ * @return Core clock cycles since Sim_Reset()
+ */
+uint64_t Sim_Get_Cycles(void)
+{
+    return sim_cycles;
+}
+
+/**
+ * @brief Size of a snapshot blob
+ * @return Bytes needed by Sim_Snapshot_Save()
+ */
+size_t Sim_Snapshot_Size(void)
+{
+    return sizeof(Sim_Snapshot_Header) + sizeof(SIM_Peripherals) + Sim_Ram_Size();
+}
+
+/**
+ * @brief Capture the complete simulated device state
+ * @param buffer: Destination blob
+ * @param capacity: Size of buffer in bytes
+ * @return Bytes written, or 0 if buffer is too small
+ */
+size_t Sim_Snapshot_Save(void *buffer, size_t capacity)
+{
+    size_t ram_size = Sim_Ram_Size();
+    size_t total = Sim_Snapshot_Size();
+    uint8_t *out = (uint8_t *)buffer;
+
+    if (buffer == NULL || capacity < total) return 0;
+
+    Sim_Snapshot_Header header;
+    header.magic = SIM_SNAPSHOT_MAGIC;
+    header.version = SIM_SNAPSHOT_VERSION;
+    header.periph_size = (uint16_t)sizeof(SIM_Peripherals);
+    header.ram_size = (uint32_t)ram_size;
+    header.reserved = 0;
+    header.clock_cycles = sim_cycles;
+
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    memcpy(out, &sim_periph, sizeof(sim_periph));
+    out += sizeof(sim_periph);
+    if (ram_size > 0) memcpy(out, __start_sim_ram, ram_size);
+
+    return total;
+}
+
+/**
+ * @brief Restore a device state captured by Sim_Snapshot_Save()
+ * @param buffer: Snapshot blob
+ * @param size: Size of the blob in bytes
+ * @return 0 on success, -1 if the blob does not match this build
+ */
+int Sim_Snapshot_Restore(const void *buffer, size_t size)
+{
+    size_t ram_size = Sim_Ram_Size();
+    const uint8_t *in = (const uint8_t *)buffer;
+    Sim_Snapshot_Header header;
+
+    if (buffer == NULL || size != Sim_Snapshot_Size()) return -1;
+
+    memcpy(&header, in, sizeof(header));
+    if (header.magic != SIM_SNAPSHOT_MAGIC ||
+        header.version != SIM_SNAPSHOT_VERSION ||
+        header.periph_size != sizeof(SIM_Peripherals) ||
+        header.ram_size != ram_size)
+    {
+        return -1;
+    }
+    in += sizeof(header);
+
+    memcpy(&sim_periph, in, sizeof(sim_periph));
+    in += sizeof(sim_periph);
+    if (ram_size > 0) memcpy(__start_sim_ram, in, ram_size);
+    sim_cycles = header.clock_cycles;
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file sim.h
+ * @brief Host simulation of the STM32 device used by main.c
+ * @description Provides RAM-backed peripheral registers, a virtual clock and
+ *              snapshot/restore of the complete simulated device state.
+ *
+ * Build with -DHOST_SIMULATION so that stm32f4xx.h maps RCC, ADC1, DAC, TIM2,
+ * ... onto sim_periph instead of fixed addresses. Firmware RAM that belongs to
+ * the device state is tagged with SIM_RAM and is captured automatically.
+ *
+ * Typical fan-out from a checkpoint:
+ *   Sim_Reset(); App_Init(); ...warm-up App_Poll() calls...
+ *   size_t n = Sim_Snapshot_Save(blob, sizeof(blob));
+ *   for each variant: Sim_Snapshot_Restore(blob, n); ...run variant...
+ *
+ * Restoring is a couple of memcpy() calls, and because all state is plain
+ * process memory, fork() right after a restore is also a valid fan-out.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Simulated core clock (matches SystemClock_Config)
+#define SIM_CORE_CLOCK_HZ      84000000UL
+
+// Snapshot blob header
+#define SIM_SNAPSHOT_MAGIC     0x534D4953UL  // "SIMS"
+#define SIM_SNAPSHOT_VERSION   1
+
+typedef struct {
+    uint32_t magic;         // SIM_SNAPSHOT_MAGIC
+    uint16_t version;       // SIM_SNAPSHOT_VERSION
+    uint16_t periph_size;   // sizeof(SIM_Peripherals)
+    uint32_t ram_size;      // Size of the sim_ram section
+    uint32_t reserved;
+    uint64_t clock_cycles;  // Virtual clock at capture time
+} Sim_Snapshot_Header;
+
+// Device control
+void Sim_Reset(void);
+void Sim_Set_Adc_Input(uint16_t adc_value);
+void Sim_Adc_Multi_Convert(const uint16_t *values, uint8_t count);
+void Sim_Uart_Receive(uint8_t byte);
+
+// Virtual clock
+void Sim_Advance_Cycles(uint64_t cycles);
+void Sim_Advance_Ms(uint32_t ms);
+uint64_t Sim_Get_Cycles(void);
+
+// Snapshot / restore
+size_t Sim_Snapshot_Size(void);
+size_t Sim_Snapshot_Save(void *buffer, size_t capacity);
+int Sim_Snapshot_Restore(const void *buffer, size_t size);
+
+#endif /* SIM_H */
@@ -6,6 +6,9 @@
  * For actual STM32 development, use the official STM32 HAL libraries.
  * This file provides basic definitions to allow the code to compile
  * without the full STM32 development environment.
+ * 
+ * When HOST_SIMULATION is defined, the peripheral instances are redirected to
+ * RAM register blocks provided by sim/sim.c so the firmware can run on a PC.
  */
 
 #ifndef STM32F4XX_H
@@ -16,6 +19,14 @@
 // Type definitions
 typedef uint32_t volatile * const reg32_t;
 
+// Registers that hold a memory address (DMA). In the host simulation they
+// must be wide enough for a host pointer.
+#ifdef HOST_SIMULATION
+typedef uintptr_t addr_reg_t;
+#else
+typedef uint32_t addr_reg_t;
+#endif
+
 // RCC (Reset and Clock Control) Register Structure
 typedef struct {
     uint32_t CR;        // Clock control register
@@ -57,6 +68,13 @@ typedef struct {
     uint32_t DR;        // ADC regular data register
 } ADC_TypeDef;
 
+// ADC Common Register Structure (multi-ADC mode)
+typedef struct {
+    uint32_t CSR;       // ADC common status register
+    uint32_t CCR;       // ADC common control register
+    uint32_t CDR;       // ADC common regular data register (dual/triple modes)
+} ADC_Common_TypeDef;
+
 // DAC Register Structure
 typedef struct {
     uint32_t CR;        // DAC control register
@@ -99,6 +117,70 @@ typedef struct {
     uint32_t DMAR;      // TIM DMA address for full transfer register
 } TIM_TypeDef;
 
+// DMA Stream Register Structure
+typedef struct {
+    uint32_t CR;        // DMA stream configuration register
+    uint32_t NDTR;      // DMA stream number of data register
+    addr_reg_t PAR;     // DMA stream peripheral address register
+    addr_reg_t M0AR;    // DMA stream memory 0 address register
+    addr_reg_t M1AR;    // DMA stream memory 1 address register
+    uint32_t FCR;       // DMA stream FIFO control register
+} DMA_Stream_TypeDef;
+
+// DMA Controller Register Structure
+typedef struct {
+    uint32_t LISR;      // DMA low interrupt status register
+    uint32_t HISR;      // DMA high interrupt status register
+    uint32_t LIFCR;     // DMA low interrupt flag clear register
+    uint32_t HIFCR;     // DMA high interrupt flag clear register
+} DMA_TypeDef;
+
+// USART Register Structure
+typedef struct {
+    uint32_t SR;        // USART status register
+    uint32_t DR;        // USART data register
+    uint32_t BRR;       // USART baud rate register
+    uint32_t CR1;       // USART control register 1
+    uint32_t CR2;       // USART control register 2
+    uint32_t CR3;       // USART control register 3
+    uint32_t GTPR;      // USART guard time and prescaler register
+} USART_TypeDef;
+
+// Core Debug Register Structure (Cortex-M4)
+typedef struct {
+    uint32_t DHCSR;     // Debug halting control and status register
+    uint32_t DCRSR;     // Debug core register selector register
+    uint32_t DCRDR;     // Debug core register data register
+    uint32_t DEMCR;     // Debug exception and monitor control register
+} CoreDebug_Type;
+
+// Data Watchpoint and Trace Register Structure (Cortex-M4)
+typedef struct {
+    uint32_t CTRL;      // DWT control register
+    uint32_t CYCCNT;    // DWT cycle count register
+    uint32_t CPICNT;    // DWT CPI count register
+    uint32_t EXCCNT;    // DWT exception overhead count register
+    uint32_t SLEEPCNT;  // DWT sleep count register
+    uint32_t LSUCNT;    // DWT LSU count register
+    uint32_t FOLDCNT;   // DWT folded-instruction count register
+    uint32_t PCSR;      // DWT program counter sample register
+} DWT_Type;
+
+// Nested Vectored Interrupt Controller Structure (Cortex-M4)
+typedef struct {
+    uint32_t ISER[8];   // Interrupt set-enable registers
+    uint32_t RESERVED0[24];
+    uint32_t ICER[8];   // Interrupt clear-enable registers
+    uint32_t RESERVED1[24];
+    uint32_t ISPR[8];   // Interrupt set-pending registers
+    uint32_t RESERVED2[24];
+    uint32_t ICPR[8];   // Interrupt clear-pending registers
+    uint32_t RESERVED3[24];
+    uint32_t IABR[8];   // Interrupt active bit registers
+    uint32_t RESERVED4[56];
+    uint8_t  IP[240];   // Interrupt priority registers (upper 4 bits used)
+} NVIC_Type;
+
 // Flash Register Structure
 typedef struct {
     uint32_t ACR;       // Flash access control register
@@ -116,29 +198,103 @@ typedef struct {
 #define APB2PERIPH_BASE       (PERIPH_BASE + 0x00010000UL)
 #define AHB1PERIPH_BASE       (PERIPH_BASE + 0x00020000UL)
 
-// RCC Base Address
+// Peripheral Instance Base Addresses
 #define RCC_BASE              (AHB1PERIPH_BASE + 0x3800UL)
-#define RCC                    ((RCC_TypeDef *)RCC_BASE)
-
-// GPIO Base Addresses
 #define GPIOA_BASE             (AHB1PERIPH_BASE + 0x0000UL)
-#define GPIOA                   ((GPIO_TypeDef *)GPIOA_BASE)
-
-// ADC Base Addresses
 #define ADC1_BASE              (APB2PERIPH_BASE + 0x2400UL)
-#define ADC1                   ((ADC_TypeDef *)ADC1_BASE)
-
-// DAC Base Address
+#define ADC2_BASE              (ADC1_BASE + 0x0100UL)
+#define ADC3_BASE              (ADC1_BASE + 0x0200UL)
+#define ADC123_COMMON_BASE     (ADC1_BASE + 0x0300UL)
 #define DAC_BASE               (APB1PERIPH_BASE + 0x7400UL)
-#define DAC                    ((DAC_TypeDef *)DAC_BASE)
-
-// Timer Base Addresses
+#define TIM1_BASE              (APB2PERIPH_BASE + 0x0000UL)
 #define TIM2_BASE              (APB1PERIPH_BASE + 0x0000UL)
-#define TIM2                    ((TIM_TypeDef *)TIM2_BASE)
-
-// Flash Base Address
+#define TIM3_BASE              (APB1PERIPH_BASE + 0x0400UL)
+#define TIM5_BASE              (APB1PERIPH_BASE + 0x0C00UL)
+#define TIM7_BASE              (APB1PERIPH_BASE + 0x1400UL)
+#define DMA2_BASE              (AHB1PERIPH_BASE + 0x6400UL)
+#define DMA2_Stream0_BASE      (DMA2_BASE + 0x0010UL)
+#define USART2_BASE            (APB1PERIPH_BASE + 0x4400UL)
 #define FLASH_BASE             0x40023C00UL
-#define FLASH                   ((FLASH_TypeDef *)FLASH_BASE)
+
+// Cortex-M Core Peripheral Base Addresses
+#define DWT_BASE               0xE0001000UL
+#define CoreDebug_BASE         0xE000EDF0UL
+#define NVIC_BASE              0xE000E100UL
+
+#ifdef HOST_SIMULATION
+// Host simulation: every register block lives in one RAM structure owned by
+// sim/sim.c, so the whole peripheral state can be snapshotted with a memcpy.
+typedef struct {
+    RCC_TypeDef   rcc;
+    GPIO_TypeDef  gpioa;
+    ADC_TypeDef   adc1;
+    ADC_TypeDef   adc2;
+    ADC_TypeDef   adc3;
+    ADC_Common_TypeDef adc_common;
+    DMA_TypeDef   dma2;
+    DMA_Stream_TypeDef dma2_stream0;
+    DAC_TypeDef   dac;
+    TIM_TypeDef   tim1;
+    TIM_TypeDef   tim2;
+    TIM_TypeDef   tim3;
+    TIM_TypeDef   tim5;
+    TIM_TypeDef   tim7;
+    FLASH_TypeDef flash;
+    USART_TypeDef usart2;
+    DWT_Type      dwt;
+    CoreDebug_Type core_debug;
+    NVIC_Type     nvic;
+    uint32_t      dma2_stream0_reload;  // Programmed NDTR (hardware shadow register)
+} SIM_Peripherals;
+
+extern SIM_Peripherals sim_periph;
+
+#define RCC                    (&sim_periph.rcc)
+#define GPIOA                  (&sim_periph.gpioa)
+#define ADC1                   (&sim_periph.adc1)
+#define ADC2                   (&sim_periph.adc2)
+#define ADC3                   (&sim_periph.adc3)
+#define ADC123_COMMON          (&sim_periph.adc_common)
+#define DMA2                   (&sim_periph.dma2)
+#define DMA2_Stream0           (&sim_periph.dma2_stream0)
+#define DAC                    (&sim_periph.dac)
+#define TIM1                   (&sim_periph.tim1)
+#define TIM2                   (&sim_periph.tim2)
+#define TIM3                   (&sim_periph.tim3)
+#define TIM5                   (&sim_periph.tim5)
+#define TIM7                   (&sim_periph.tim7)
+#define FLASH                  (&sim_periph.flash)
+#define USART2                 (&sim_periph.usart2)
+#define DWT                    (&sim_periph.dwt)
+#define CoreDebug              (&sim_periph.core_debug)
+#define NVIC                   (&sim_periph.nvic)
+
+// Firmware state that must be captured by sim snapshots (RAM globals and
+// function-local statics) is placed in the "sim_ram" section.
+#define SIM_RAM                __attribute__((section("sim_ram")))
+#else
+#define RCC                    ((RCC_TypeDef *)RCC_BASE)
+#define GPIOA                  ((GPIO_TypeDef *)GPIOA_BASE)
+#define ADC1                   ((ADC_TypeDef *)ADC1_BASE)
+#define ADC2                   ((ADC_TypeDef *)ADC2_BASE)
+#define ADC3                   ((ADC_TypeDef *)ADC3_BASE)
+#define ADC123_COMMON          ((ADC_Common_TypeDef *)ADC123_COMMON_BASE)
+#define DMA2                   ((DMA_TypeDef *)DMA2_BASE)
+#define DMA2_Stream0           ((DMA_Stream_TypeDef *)DMA2_Stream0_BASE)
+#define DAC                    ((DAC_TypeDef *)DAC_BASE)
+#define TIM1                   ((TIM_TypeDef *)TIM1_BASE)
+#define TIM2                   ((TIM_TypeDef *)TIM2_BASE)
+#define TIM3                   ((TIM_TypeDef *)TIM3_BASE)
+#define TIM5                   ((TIM_TypeDef *)TIM5_BASE)
+#define TIM7                   ((TIM_TypeDef *)TIM7_BASE)
+#define FLASH                  ((FLASH_TypeDef *)FLASH_BASE)
+#define USART2                 ((USART_TypeDef *)USART2_BASE)
+#define DWT                    ((DWT_Type *)DWT_BASE)
+#define CoreDebug              ((CoreDebug_Type *)CoreDebug_BASE)
+#define NVIC                   ((NVIC_Type *)NVIC_BASE)
+
+#define SIM_RAM
+#endif
 
 // RCC Register Bits
 #define RCC_CR_HSEON           (1UL << 16)
@@ -155,13 +311,33 @@ typedef struct {
 #define RCC_CFGR_PPRE2_DIV1    (0UL << 13)
 
 #define RCC_AHB1ENR_GPIOAEN    (1UL << 0)
+#define RCC_AHB1ENR_DMA2EN     (1UL << 22)
 #define RCC_APB1ENR_DACEN      (1UL << 29)
 #define RCC_APB1ENR_TIM2EN     (1UL << 0)
+#define RCC_APB1ENR_TIM3EN     (1UL << 1)
+#define RCC_APB1ENR_TIM5EN     (1UL << 3)
+#define RCC_APB1ENR_TIM7EN     (1UL << 5)
+#define RCC_APB1ENR_USART2EN   (1UL << 17)
+#define RCC_APB2ENR_TIM1EN     (1UL << 0)
 #define RCC_APB2ENR_ADC1EN      (1UL << 8)
+#define RCC_APB2ENR_ADC2EN     (1UL << 9)
+#define RCC_APB2ENR_ADC3EN     (1UL << 10)
 
 // GPIO Register Bits
 #define GPIO_MODER_MODER0      (3UL << 0)
+#define GPIO_MODER_MODER1      (3UL << 2)
+#define GPIO_MODER_MODER2      (3UL << 4)
+#define GPIO_MODER_MODER3      (3UL << 6)
 #define GPIO_MODER_MODER5      (3UL << 10)
+#define GPIO_MODER_MODER5_1    (2UL << 10)  // Alternate function mode
+#define GPIO_MODER_MODER6      (3UL << 12)
+#define GPIO_MODER_MODER7      (3UL << 14)
+#define GPIO_MODER_MODER7_1    (2UL << 14)  // Alternate function mode
+#define GPIO_MODER_MODER8      (3UL << 16)
+#define GPIO_MODER_MODER8_1    (2UL << 16)  // Alternate function mode
+#define GPIO_PUPDR_PUPDR6      (3UL << 12)
+#define GPIO_PUPDR_PUPDR6_1    (2UL << 12)  // Pull-down
+#define GPIO_IDR_IDR6          (1UL << 6)
 
 // ADC Register Bits
 #define ADC_SR_EOC             (1UL << 1)
@@ -172,6 +348,29 @@ typedef struct {
 #define ADC_SMPR2_SMP0_0       (1UL << 0)
 #define ADC_SMPR2_SMP0_1       (1UL << 1)
 #define ADC_SMPR2_SMP0_2       (1UL << 2)
+#define ADC_CR2_DMA            (1UL << 8)
+#define ADC_CR2_DDS            (1UL << 9)
+
+// ADC Common Register Bits
+#define ADC_CCR_MULTI_Pos      0
+#define ADC_CCR_MULTI          (0x1FUL << ADC_CCR_MULTI_Pos)
+#define ADC_CCR_MULTI_DUAL_REGSIMULT   (0x06UL << ADC_CCR_MULTI_Pos)
+#define ADC_CCR_MULTI_TRIPLE_REGSIMULT (0x16UL << ADC_CCR_MULTI_Pos)
+#define ADC_CCR_DDS            (1UL << 13)
+#define ADC_CCR_DMA_Pos        14
+#define ADC_CCR_DMA            (3UL << ADC_CCR_DMA_Pos)
+#define ADC_CCR_DMA_MODE1      (1UL << ADC_CCR_DMA_Pos)  // One half-word per transfer
+#define ADC_CCR_DMA_MODE2      (2UL << ADC_CCR_DMA_Pos)  // Two half-words packed per transfer
+
+// DMA Register Bits
+#define DMA_SxCR_EN            (1UL << 0)
+#define DMA_SxCR_CIRC          (1UL << 8)
+#define DMA_SxCR_MINC          (1UL << 10)
+#define DMA_SxCR_PSIZE_Pos     11
+#define DMA_SxCR_MSIZE_Pos     13
+#define DMA_SxCR_SIZE_16       1UL
+#define DMA_SxCR_SIZE_32       2UL
+#define DMA_SxCR_CHSEL_Pos     25
 
 // DAC Register Bits
 #define DAC_CR_EN1             (1UL << 0)
@@ -179,13 +378,55 @@ typedef struct {
 #define DAC_CR_TSEL1_Pos       3
 #define DAC_CR_WAVE1_1         (1UL << 6)
 #define DAC_CR_MAMP1_Pos       8
+#define DAC_CR_MAMP1           (0xFUL << DAC_CR_MAMP1_Pos)
 
 // Timer Register Bits
 #define TIM_CR1_CEN            (1UL << 0)
+#define TIM_CR1_ARPE           (1UL << 7)
+#define TIM_CR2_MMS            (7UL << 4)
 #define TIM_CR2_MMS_1          (2UL << 4)
+#define TIM_CR2_MMS_OC1REF     (4UL << 4)  // OC1REF as TRGO
+#define TIM_SMCR_SMS           (7UL << 0)
+#define TIM_SMCR_SMS_GATED     (5UL << 0)  // Counter runs while TRGI is high
+#define TIM_SMCR_TS            (7UL << 4)
+#define TIM_SMCR_TS_ITR2       (2UL << 4)  // TIM2: ITR2 = TIM3 TRGO
 #define TIM_EGR_UG             (1UL << 0)
+#define TIM_DIER_UIE           (1UL << 0)
+#define TIM_SR_UIF             (1UL << 0)
+#define TIM_CCMR1_OC1PE        (1UL << 3)
+#define TIM_CCMR1_OC1M         (7UL << 4)
+#define TIM_CCMR1_OC1M_PWM1    (6UL << 4)
+#define TIM_CCMR1_OC1M_TOGGLE  (3UL << 4)
+#define TIM_CCMR1_OC1M_FORCE_LOW (4UL << 4)
+#define TIM_CCER_CC1E          (1UL << 0)
+#define TIM_CCER_CC1NE         (1UL << 2)
+#define TIM_BDTR_DTG_Pos       0
+#define TIM_BDTR_DTG           (0xFFUL << TIM_BDTR_DTG_Pos)
+#define TIM_BDTR_OSSI          (1UL << 10)
+#define TIM_BDTR_OSSR          (1UL << 11)
+#define TIM_BDTR_MOE           (1UL << 15)
+
+// USART Register Bits
+#define USART_SR_RXNE          (1UL << 5)
+#define USART_SR_TC            (1UL << 6)
+#define USART_SR_TXE           (1UL << 7)
+#define USART_CR1_RE           (1UL << 2)
+#define USART_CR1_TE           (1UL << 3)
+#define USART_CR1_RXNEIE       (1UL << 5)
+#define USART_CR1_UE           (1UL << 13)
+
+// Core Debug / DWT Register Bits
+#define CoreDebug_DEMCR_TRCENA (1UL << 24)
+#define DWT_CTRL_CYCCNTENA     (1UL << 0)
+
+// Interrupt Numbers
+#define TIM2_IRQn              28
+#define USART2_IRQn            38
+#define TIM5_IRQn              50
+#define TIM7_IRQn              55
 
 // Flash Register Bits
+#define FLASH_ACR_LATENCY      (0xFUL << 0)
 #define FLASH_ACR_LATENCY_2WS  (2UL << 0)
 
 // Intrinsic Functions
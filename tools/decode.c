@@ -0,0 +1,538 @@
+/**
+ * @file decode.c
+ * @brief Recover temperature readings from a recording of the tone output
+ * @description Tracks the pitch of a WAV recording (e.g. a phone recording
+ *              of the alarm tone, or the output of render) and inverts the
+ *              pipeline map (Temperature_To_Frequency()) to get back one ADC
+ *              reading, and a temperature, per reading interval.
+ *
+ * Build:
+ *   gcc -O3 -march=native -I. tools/decode.c tools/wav.c tools/trace.c pipeline.c fft.c -lm -o decode
+ *
+ * Usage:
+ *   decode -i in.wav [-o out.csv] [-t trace.txt] [-r readings_per_s]
+ *          [--min 200] [--max 2000] [--adc-low 0] [--adc-high 4095]
+ *          [--clarity 0.8] [--adc-per-c 40.95] [--adc-offset 0]
+ *
+ * -r is readings per second of audio: 10 for a live recording of the
+ * firmware (one retune per 100 ms loop), sample_rate / samples_per_reading
+ * for render output (100 with render's defaults). --min/--max and
+ * --adc-low/--adc-high must match the pipeline configuration that produced
+ * the tone, --adc-per-c/--adc-offset the sensor scaling (defaults: the
+ * thermal model, 0-100 C over the range). Tones at min/max decode as
+ * adc-low/adc-high: readings beyond the span are not recoverable.
+ *
+ * Firmware built with FEATURE_AUTORANGE moves the span every few seconds
+ * and does not report it, so its recordings cannot be decoded (only a
+ * stretch recorded under one known span can, with that span given here).
+ *
+ * Processing:
+ *   1. The audio is mixed to mono and decimated by an integer factor to at
+ *      least 8x the highest tone (windowed-sinc FIR, only the kept outputs
+ *      are computed, four taps at a time on SIMD hosts).
+ *   2. Pitch: McLeod normalized square difference function (NSDF) over
+ *      frames covering two periods of the lowest tone, eight frames per
+ *      reading. The autocorrelation comes from the shared real FFT: the
+ *      power spectrum of the zero-padded frame is real and even, so a second
+ *      forward transform of it is the (scaled) autocorrelation. The first
+ *      NSDF peak within 90% of the highest is the period, refined by
+ *      parabolic interpolation; its height (clarity) rejects noise and
+ *      silence.
+ *   3. Each reading is the median of its voiced frames, mapped back through
+ *      the monotonic Pipeline_Map() by binary search: the ADC value is the
+ *      middle of the run of counts that produce the nearest tone.
+ *
+ * Output CSV: time_s,frequency_hz,adc,temperature_c,clarity; unvoiced
+ * readings (silence, noise) have empty fields. The trace (-t) holds the last
+ * voiced value through gaps so it loads at a fixed rate in sweep/render.
+ *
+ * Resolution is bounded by the firmware itself: the dead-band (5 Hz by
+ * default) leaves the tone up to that far from the mapped reading, about
+ * +-11 counts (+-0.3 C) with the default range. Alert patterns are decoded
+ * as readings too.
+ */
+
+#include "../fft.h"
+#include "../pipeline.h"
+#include "trace.h"
+#include "wav.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DECODE_OVERSAMPLE      8       // Decimated rate vs highest tone
+#define DECODE_TAPS_PER_PHASE  16      // Anti-alias FIR taps per decimation step
+#define DECODE_FRAMES          8       // Pitch frames per reading
+#define DECODE_PEAK_RATIO      0.9f    // Accept the first NSDF peak this close to the highest
+#define DECODE_SILENCE_RMS     1e-3f   // Frames quieter than -60 dBFS are unvoiced
+#define DECODE_BLOCK           65536   // Input frames per read
+
+#if FFT_SIMD
+typedef float Decode_V4 __attribute__((vector_size(16)));
+#endif
+
+typedef struct {
+    Pipeline_Config cfg;
+    uint16_t map[PIPELINE_TABLE_SIZE]; // Pipeline_Map() per ADC count
+    float readings_per_s;
+    float clarity;              // Voicing threshold on the NSDF peak
+    float adc_per_c;
+    float adc_offset;
+
+    uint32_t factor;            // Decimation factor
+    float rate;                 // Decimated sample rate
+    float *taps;                // Anti-alias FIR, padded to a multiple of 4
+    uint32_t tap_count;
+    uint32_t frame;             // Pitch frame (decimated samples)
+    uint32_t hop;               // Decimated samples between frames
+    uint32_t tau_min, tau_max;  // Period search range (decimated samples)
+
+    Fft_Plan plan;
+    float *buf, *spec_re, *spec_im, *corr_im;
+} Decode_Context;
+
+typedef struct {
+    FILE *csv;
+    Trace trace;
+    size_t capacity;
+    float *voiced;              // Frequencies of the current reading's voiced frames
+    float *clarity;
+    uint32_t voiced_count;
+    uint64_t reading;           // Index of the reading being collected
+    uint64_t unvoiced;          // Readings without a voiced frame
+    uint16_t last_adc;
+} Decode_Output;
+
+static double Decode_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Blackman-windowed sinc low-pass with unity DC gain
+ */
+static int Decode_Build_Filter(Decode_Context *ctx)
+{
+    uint32_t taps = ctx->factor * DECODE_TAPS_PER_PHASE;
+    ctx->tap_count = (taps + 3) & ~3u;
+    ctx->taps = (float *)calloc(ctx->tap_count, sizeof(float));
+    if (ctx->taps == NULL) return -1;
+
+    // Cutoff at a third of the decimated rate: the tones stay flat and the
+    // transition band ends at the decimated Nyquist frequency
+    double cutoff = 1.0 / (3.0 * ctx->factor), sum = 0.0;
+    for (uint32_t i = 0; i < taps; i++)
+    {
+        double x = (double)i - (taps - 1) / 2.0;
+        double sinc = (x == 0.0) ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+        double w = 0.42 - 0.5 * cos(2.0 * M_PI * (i + 0.5) / taps) + 0.08 * cos(4.0 * M_PI * (i + 0.5) / taps);
+        ctx->taps[i] = (float)(sinc * w);
+        sum += sinc * w;
+    }
+    for (uint32_t i = 0; i < taps; i++) ctx->taps[i] = (float)(ctx->taps[i] / sum);
+    return 0;
+}
+
+/**
+ * @brief One decimated output: dot product of the taps with `x`
+ */
+static inline float Decode_Dot(const float *taps, const float *x, uint32_t count)
+{
+#if FFT_SIMD
+    Decode_V4 acc = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        Decode_V4 h, v;
+        memcpy(&h, taps + i, sizeof(h));
+        memcpy(&v, x + i, sizeof(v));
+        acc += h * v;
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#else
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < count; i++) acc += taps[i] * x[i];
+    return acc;
+#endif
+}
+
+/**
+ * @brief Pitch of one frame by the NSDF
+ * @param x: ctx->frame decimated samples
+ * @param clarity: NSDF value at the chosen peak (0 when none)
+ * @return Frequency in Hz, 0 if the frame is unvoiced
+ */
+static float Decode_Pitch(Decode_Context *ctx, const float *x, float *clarity)
+{
+    const uint32_t n = ctx->plan.n, frame = ctx->frame;
+    float *buf = ctx->buf;
+    float mean = 0.0f, energy = 0.0f;
+
+    *clarity = 0.0f;
+    for (uint32_t i = 0; i < frame; i++) mean += x[i];
+    mean /= (float)frame;
+    for (uint32_t i = 0; i < frame; i++)
+    {
+        buf[i] = x[i] - mean;
+        energy += buf[i] * buf[i];
+    }
+    if (energy < DECODE_SILENCE_RMS * DECODE_SILENCE_RMS * (float)frame) return 0.0f;
+    memset(buf + frame, 0, (n - frame) * sizeof(float));
+
+    // Autocorrelation: forward transform of the even-extended power spectrum
+    // (n >= frame + tau_max, so lags up to tau_max do not wrap)
+    Fft_Real(&ctx->plan, buf, ctx->spec_re, ctx->spec_im);
+    for (uint32_t k = 0; k <= n / 2; k++)
+    {
+        float power = ctx->spec_re[k] * ctx->spec_re[k] + ctx->spec_im[k] * ctx->spec_im[k];
+        ctx->buf[k] = power;
+        if (k > 0 && k < n / 2) ctx->buf[n - k] = power;
+    }
+    float *corr = ctx->spec_re;     // corr[tau] = n * r(tau)
+    Fft_Real(&ctx->plan, ctx->buf, corr, ctx->corr_im);
+
+    // NSDF(tau) = 2 r(tau) / m(tau), m(tau) = sum over the overlap of
+    // x[j]^2 + x[j + tau]^2; m is updated per lag from the frame edges
+    float nsdf[ctx->tau_max + 2];
+    double m = 2.0 * energy;
+    for (uint32_t tau = 0; tau <= ctx->tau_max + 1; tau++)
+    {
+        if (tau > 0)
+        {
+            float head = x[tau - 1] - mean, tail = x[frame - tau] - mean;
+            m -= (double)head * head + (double)tail * tail;
+        }
+        nsdf[tau] = (m > 0.0) ? (float)(2.0 * corr[tau] / ((double)n * m)) : 0.0f;
+    }
+
+    // Key maxima: the highest point of each positive lobe after the first
+    // negative-going zero crossing
+    uint32_t keys[ctx->tau_max + 2], key_count = 0, tau = 1;
+    float highest = 0.0f;
+    while (tau <= ctx->tau_max && nsdf[tau] > 0.0f) tau++;
+    while (tau <= ctx->tau_max)
+    {
+        while (tau <= ctx->tau_max && nsdf[tau] <= 0.0f) tau++;
+        uint32_t best = tau;
+        while (tau <= ctx->tau_max && nsdf[tau] > 0.0f)
+        {
+            if (nsdf[tau] > nsdf[best]) best = tau;
+            tau++;
+        }
+        if (best <= ctx->tau_max && best >= ctx->tau_min)
+        {
+            keys[key_count++] = best;
+            if (nsdf[best] > highest) highest = nsdf[best];
+        }
+    }
+
+    for (uint32_t i = 0; i < key_count; i++)
+    {
+        uint32_t k = keys[i];
+        if (nsdf[k] < DECODE_PEAK_RATIO * highest) continue;
+        if (nsdf[k] < ctx->clarity) return 0.0f;
+
+        float period = (float)k;
+        float curve = nsdf[k - 1] - 2.0f * nsdf[k] + nsdf[k + 1];
+        if (curve < 0.0f) period += 0.5f * (nsdf[k - 1] - nsdf[k + 1]) / curve;
+        *clarity = nsdf[k];
+        return ctx->rate / period;
+    }
+    return 0.0f;
+}
+
+/**
+ * @brief Invert the pipeline map
+ * @return ADC value (middle of the run of counts mapping to the nearest tone)
+ */
+static float Decode_Invert(const Decode_Context *ctx, float frequency)
+{
+    // First count whose tone is >= frequency
+    uint32_t lo = 0, hi = PIPELINE_TABLE_SIZE;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if ((float)ctx->map[mid] < frequency) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == PIPELINE_TABLE_SIZE) lo = PIPELINE_ADC_MAX;
+    if (lo > 0 && frequency - ctx->map[lo - 1] < ctx->map[lo] - frequency) lo--;
+
+    uint16_t tone = ctx->map[lo];
+    uint32_t first = lo, last = lo;
+    while (first > 0 && ctx->map[first - 1] == tone) first--;
+    while (last < PIPELINE_ADC_MAX && ctx->map[last + 1] == tone) last++;
+
+    // The flat ends outside the span only say "at or beyond the edge"
+    if (first < ctx->cfg.adc_low) first = ctx->cfg.adc_low;
+    if (last > ctx->cfg.adc_high) last = ctx->cfg.adc_high;
+    if (first > last) first = last;
+    return 0.5f * (float)(first + last);
+}
+
+/**
+ * @brief Close the current reading: median of its voiced frames
+ */
+static int Decode_Emit(Decode_Context *ctx, Decode_Output *out)
+{
+    double time_s = (double)out->reading / ctx->readings_per_s;
+
+    if (out->voiced_count == 0)
+    {
+        out->unvoiced++;
+        if (out->csv != NULL) fprintf(out->csv, "%.3f,,,,\n", time_s);
+    }
+    else
+    {
+        // Insertion sort; a reading has at most a few dozen frames
+        for (uint32_t i = 1; i < out->voiced_count; i++)
+        {
+            float f = out->voiced[i], c = out->clarity[i];
+            uint32_t j = i;
+            for (; j > 0 && out->voiced[j - 1] > f; j--)
+            {
+                out->voiced[j] = out->voiced[j - 1];
+                out->clarity[j] = out->clarity[j - 1];
+            }
+            out->voiced[j] = f;
+            out->clarity[j] = c;
+        }
+        uint32_t middle = out->voiced_count / 2;
+        float frequency = out->voiced[middle];
+        float adc = Decode_Invert(ctx, frequency);
+
+        out->last_adc = (uint16_t)lrintf(adc);
+        if (out->csv != NULL)
+        {
+            fprintf(out->csv, "%.3f,%.2f,%.1f,%.2f,%.3f\n", time_s, frequency, adc,
+                    (adc - ctx->adc_offset) / ctx->adc_per_c, out->clarity[middle]);
+        }
+    }
+
+    if (out->trace.count == out->capacity)
+    {
+        size_t capacity = out->capacity ? out->capacity * 2 : 4096;
+        uint16_t *samples = (uint16_t *)realloc(out->trace.samples, capacity * sizeof(uint16_t));
+        if (samples == NULL) return -1;
+        out->trace.samples = samples;
+        out->capacity = capacity;
+    }
+    out->trace.samples[out->trace.count++] = out->last_adc;
+
+    out->voiced_count = 0;
+    out->reading++;
+    return 0;
+}
+
+static void Decode_Usage(void)
+{
+    fprintf(stderr,
+            "usage: decode -i in.wav [-o out.csv] [-t trace] [-r readings_per_s]\n"
+            "              [--min hz] [--max hz] [--adc-low counts] [--adc-high counts]\n"
+            "              [--clarity 0-1]\n"
+            "              [--adc-per-c counts] [--adc-offset counts]\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *in_path = NULL, *out_path = NULL, *trace_path = NULL;
+    Decode_Context ctx;
+    Decode_Output out;
+
+    memset(&ctx, 0, sizeof(ctx));
+    memset(&out, 0, sizeof(out));
+    ctx.cfg = (Pipeline_Config)PIPELINE_CONFIG_DEFAULT;
+    ctx.readings_per_s = 10.0f;    // One retune per 100 ms main loop
+    ctx.clarity = 0.8f;
+    ctx.adc_per_c = 40.95f;
+    ctx.adc_offset = 0.0f;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int bad = (val == NULL);
+
+        if (!bad && strcmp(opt, "-i") == 0) in_path = val;
+        else if (!bad && strcmp(opt, "-o") == 0) out_path = val;
+        else if (!bad && strcmp(opt, "-t") == 0) trace_path = val;
+        else if (!bad && strcmp(opt, "-r") == 0) ctx.readings_per_s = strtof(val, NULL);
+        else if (!bad && strcmp(opt, "--min") == 0) ctx.cfg.min_freq = (uint32_t)atoi(val);
+        else if (!bad && strcmp(opt, "--max") == 0) ctx.cfg.max_freq = (uint32_t)atoi(val);
+        else if (!bad && strcmp(opt, "--adc-low") == 0) ctx.cfg.adc_low = (uint16_t)atoi(val);
+        else if (!bad && strcmp(opt, "--adc-high") == 0) ctx.cfg.adc_high = (uint16_t)atoi(val);
+        else if (!bad && strcmp(opt, "--clarity") == 0) ctx.clarity = strtof(val, NULL);
+        else if (!bad && strcmp(opt, "--adc-per-c") == 0) ctx.adc_per_c = strtof(val, NULL);
+        else if (!bad && strcmp(opt, "--adc-offset") == 0) ctx.adc_offset = strtof(val, NULL);
+        else bad = 1;
+
+        if (bad)
+        {
+            Decode_Usage();
+            return 2;
+        }
+        i++;
+    }
+
+    if (in_path == NULL || ctx.readings_per_s <= 0.0f || ctx.cfg.min_freq == 0 ||
+        ctx.cfg.max_freq <= ctx.cfg.min_freq || ctx.cfg.max_freq > 65535 || ctx.adc_per_c == 0.0f ||
+        ctx.cfg.adc_high <= ctx.cfg.adc_low || ctx.cfg.adc_high > PIPELINE_ADC_MAX)
+    {
+        Decode_Usage();
+        return 2;
+    }
+
+    Wav_Reader wav;
+    if (Wav_Read_Open(&wav, in_path) != 0)
+    {
+        fprintf(stderr, "decode: cannot read %s (PCM 8-32 bit or float WAV expected)\n", in_path);
+        return 1;
+    }
+    if (wav.sample_rate < 3 * ctx.cfg.max_freq)
+    {
+        fprintf(stderr, "decode: %u Hz audio cannot hold tones up to %u Hz\n", wav.sample_rate, ctx.cfg.max_freq);
+        return 1;
+    }
+
+    for (uint32_t adc = 0; adc < PIPELINE_TABLE_SIZE; adc++) ctx.map[adc] = (uint16_t)Pipeline_Map(&ctx.cfg, (uint16_t)adc);
+
+    // Analysis geometry, with 10% margin around the tone range
+    ctx.factor = wav.sample_rate / (DECODE_OVERSAMPLE * ctx.cfg.max_freq);
+    if (ctx.factor == 0) ctx.factor = 1;
+    ctx.rate = (float)wav.sample_rate / (float)ctx.factor;
+    ctx.tau_min = (uint32_t)floorf(ctx.rate / (1.1f * (float)ctx.cfg.max_freq));
+    if (ctx.tau_min < 2) ctx.tau_min = 2;
+    ctx.tau_max = (uint32_t)ceilf(ctx.rate / (0.9f * (float)ctx.cfg.min_freq));
+    ctx.frame = 2 * ctx.tau_max;
+    ctx.hop = (uint32_t)(ctx.rate / (ctx.readings_per_s * DECODE_FRAMES));
+    if (ctx.hop == 0) ctx.hop = 1;
+
+    uint32_t n = 16;
+    while (n < ctx.frame + ctx.tau_max + 2) n *= 2;
+    uint32_t frames_per_reading = (uint32_t)ceilf(ctx.rate / (ctx.readings_per_s * (float)ctx.hop)) + 2;
+
+    size_t in_size = DECODE_BLOCK + ctx.factor * DECODE_TAPS_PER_PHASE + 4;
+    size_t dec_size = DECODE_BLOCK / ctx.factor + ctx.frame + 2;
+    float *in = (float *)malloc(in_size * sizeof(float));
+    float *dec = (float *)malloc(dec_size * sizeof(float));
+    ctx.buf = (float *)malloc(n * sizeof(float));
+    ctx.spec_re = (float *)malloc((n / 2 + 1) * sizeof(float));
+    ctx.spec_im = (float *)malloc((n / 2 + 1) * sizeof(float));
+    ctx.corr_im = (float *)malloc((n / 2 + 1) * sizeof(float));
+    out.voiced = (float *)malloc(frames_per_reading * sizeof(float));
+    out.clarity = (float *)malloc(frames_per_reading * sizeof(float));
+    if (!in || !dec || !ctx.buf || !ctx.spec_re || !ctx.spec_im || !ctx.corr_im || !out.voiced || !out.clarity ||
+        Fft_Init(&ctx.plan, n) != 0 || (ctx.factor > 1 && Decode_Build_Filter(&ctx) != 0))
+    {
+        fprintf(stderr, "decode: out of memory\n");
+        return 1;
+    }
+
+    out.csv = stdout;
+    if (out_path != NULL && (out.csv = fopen(out_path, "w")) == NULL)
+    {
+        fprintf(stderr, "decode: cannot write %s\n", out_path);
+        return 1;
+    }
+    fprintf(out.csv, "time_s,frequency_hz,adc,temperature_c,clarity\n");
+
+    // Time of decimated sample 0: the FIR delays by half its length
+    double delay_s = ctx.factor > 1 ? (ctx.factor * DECODE_TAPS_PER_PHASE - 1) / 2.0 / wav.sample_rate : 0.0;
+    size_t in_len = 0, in_pos = 0, dec_len = 0, dec_pos = 0;
+    uint64_t dec_base = 0;      // Decimated index of dec[0]
+    double start = Decode_Now();
+
+    for (;;)
+    {
+        size_t got = Wav_Read(&wav, in + in_len, DECODE_BLOCK);
+        in_len += got;
+
+        // Decimate whatever is complete
+        if (ctx.factor == 1)
+        {
+            memcpy(dec + dec_len, in, in_len * sizeof(float));
+            dec_len += in_len;
+            in_len = 0;
+        }
+        else
+        {
+            while (in_pos + ctx.tap_count <= in_len)
+            {
+                dec[dec_len++] = Decode_Dot(ctx.taps, in + in_pos, ctx.tap_count);
+                in_pos += ctx.factor;
+            }
+            memmove(in, in + in_pos, (in_len - in_pos) * sizeof(float));
+            in_len -= in_pos;
+            in_pos = 0;
+        }
+
+        // Pitch frames, each credited to the reading containing its centre
+        while (dec_pos + ctx.frame <= dec_len)
+        {
+            double centre_s = (double)(dec_base + dec_pos + ctx.frame / 2) / ctx.rate + delay_s;
+            uint64_t reading = (uint64_t)(centre_s * ctx.readings_per_s);
+            float clarity;
+            float frequency = Decode_Pitch(&ctx, dec + dec_pos, &clarity);
+
+            while (out.reading < reading)
+            {
+                if (Decode_Emit(&ctx, &out) != 0)
+                {
+                    fprintf(stderr, "decode: out of memory\n");
+                    return 1;
+                }
+            }
+            if (frequency > 0.0f && out.voiced_count < frames_per_reading)
+            {
+                out.voiced[out.voiced_count] = frequency;
+                out.clarity[out.voiced_count++] = clarity;
+            }
+            dec_pos += ctx.hop;
+        }
+        size_t keep = dec_pos < dec_len ? dec_len - dec_pos : 0;
+        memmove(dec, dec + dec_len - keep, keep * sizeof(float));
+        dec_base += dec_len - keep;
+        dec_pos -= dec_len - keep;
+        dec_len = keep;
+
+        if (got == 0) break;
+    }
+    // Readings up to the end of the audio, including a silent tail
+    uint64_t readings = (uint64_t)ceil((double)wav.frames * ctx.readings_per_s / wav.sample_rate);
+    while (out.reading < readings || out.voiced_count > 0)
+    {
+        if (Decode_Emit(&ctx, &out) != 0)
+        {
+            fprintf(stderr, "decode: out of memory\n");
+            return 1;
+        }
+    }
+    double elapsed = Decode_Now() - start;
+
+    int status = 0;
+    if (out.csv != stdout && fclose(out.csv) != 0) status = 1;
+    out.trace.rate_hz = ctx.readings_per_s;
+    if (trace_path != NULL && Trace_Save(&out.trace, trace_path) != 0) status = 1;
+    if (status != 0) fprintf(stderr, "decode: write error\n");
+
+    fprintf(stderr, "decode: %.1f s of audio at %u Hz (decimated by %u, %u-point FFT), %llu readings, "
+            "%llu unvoiced, %.2f s\n", (double)wav.frames / wav.sample_rate, wav.sample_rate, ctx.factor, n,
+            (unsigned long long)out.reading, (unsigned long long)out.unvoiced, elapsed);
+
+    Wav_Read_Close(&wav);
+    Fft_Free(&ctx.plan);
+    Trace_Free(&out.trace);
+    free(ctx.taps);
+    free(ctx.buf);
+    free(ctx.spec_re);
+    free(ctx.spec_im);
+    free(ctx.corr_im);
+    free(out.voiced);
+    free(out.clarity);
+    free(in);
+    free(dec);
+    return status;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file elf.c
+ * @brief Minimal ELF reader for the host tools
+ */
+
+#include "elf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ELF_PT_LOAD            1
+#define ELF_SHT_SYMTAB         2
+#define ELF_STT_FUNC           2
+#define ELF_EM_ARM             40
+
+static uint16_t Elf_U16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t Elf_U32(const uint8_t *p) { return (uint32_t)Elf_U16(p) | ((uint32_t)Elf_U16(p + 2) << 16); }
+static uint64_t Elf_U64(const uint8_t *p) { return (uint64_t)Elf_U32(p) | ((uint64_t)Elf_U32(p + 4) << 32); }
+
+/**
+ * @brief Read a class-sized word (address/offset/size field)
+ */
+static uint64_t Elf_Word(const Elf_File *elf, const uint8_t *p)
+{
+    return elf->is64 ? Elf_U64(p) : Elf_U32(p);
+}
+
+static int Elf_Symbol_Compare(const void *a, const void *b)
+{
+    const Elf_Symbol *sa = (const Elf_Symbol *)a;
+    const Elf_Symbol *sb = (const Elf_Symbol *)b;
+    return (sa->addr > sb->addr) - (sa->addr < sb->addr);
+}
+
+/**
+ * @brief Collect the function symbols of one SHT_SYMTAB section
+ */
+static int Elf_Read_Symtab(Elf_File *elf, const uint8_t *sh, const uint8_t *sections, size_t shentsize)
+{
+    uint64_t offset = Elf_Word(elf, sh + (elf->is64 ? 24 : 16));
+    uint64_t size = Elf_Word(elf, sh + (elf->is64 ? 32 : 20));
+    uint32_t link = Elf_U32(sh + (elf->is64 ? 40 : 24));
+    uint64_t entsize = Elf_Word(elf, sh + (elf->is64 ? 56 : 36));
+    const uint8_t *strsh = sections + (size_t)link * shentsize;
+    uint64_t stroff = Elf_Word(elf, strsh + (elf->is64 ? 24 : 16));
+    uint64_t strsize = Elf_Word(elf, strsh + (elf->is64 ? 32 : 20));
+
+    if (entsize == 0 || offset + size > elf->size || stroff + strsize > elf->size) return -1;
+
+    size_t count = (size_t)(size / entsize);
+    Elf_Symbol *grown = (Elf_Symbol *)realloc(elf->symbols, (elf->symbol_count + count) * sizeof(Elf_Symbol));
+    if (grown == NULL) return -1;
+    elf->symbols = grown;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint8_t *sym = elf->data + offset + i * entsize;
+        uint32_t name;
+        uint8_t info;
+        uint64_t value, sym_size;
+
+        if (elf->is64)
+        {
+            name = Elf_U32(sym);
+            info = sym[4];
+            value = Elf_U64(sym + 8);
+            sym_size = Elf_U64(sym + 16);
+        }
+        else
+        {
+            name = Elf_U32(sym);
+            value = Elf_U32(sym + 4);
+            sym_size = Elf_U32(sym + 8);
+            info = sym[12];
+        }
+
+        if ((info & 0xF) != ELF_STT_FUNC || value == 0 || name >= strsize) continue;
+        if (elf->machine == ELF_EM_ARM) value &= ~1ULL;  // Thumb bit
+
+        Elf_Symbol *out = &elf->symbols[elf->symbol_count++];
+        out->name = (const char *)elf->data + stroff + name;
+        out->addr = value;
+        out->size = sym_size;
+    }
+    return 0;
+}
+
+/**
+ * @brief Collect the PT_LOAD program headers
+ */
+static int Elf_Read_Segments(Elf_File *elf)
+{
+    const uint8_t *h = elf->data;
+    uint64_t phoff = Elf_Word(elf, h + (elf->is64 ? 32 : 28));
+    uint16_t phentsize = Elf_U16(h + (elf->is64 ? 54 : 42));
+    uint16_t phnum = Elf_U16(h + (elf->is64 ? 56 : 44));
+
+    if (phoff == 0 || phnum == 0) return 0;
+    if (phoff + (uint64_t)phnum * phentsize > elf->size) return -1;
+
+    elf->segments = (Elf_Segment *)calloc(phnum, sizeof(Elf_Segment));
+    if (elf->segments == NULL) return -1;
+
+    for (uint16_t i = 0; i < phnum; i++)
+    {
+        const uint8_t *ph = elf->data + phoff + (size_t)i * phentsize;
+        if (Elf_U32(ph) != ELF_PT_LOAD) continue;
+
+        Elf_Segment *seg = &elf->segments[elf->segment_count];
+        if (elf->is64)
+        {
+            seg->flags = Elf_U32(ph + 4);
+            seg->offset = Elf_U64(ph + 8);
+            seg->vaddr = Elf_U64(ph + 16);
+            seg->paddr = Elf_U64(ph + 24);
+            seg->filesz = Elf_U64(ph + 32);
+            seg->memsz = Elf_U64(ph + 40);
+        }
+        else
+        {
+            seg->offset = Elf_U32(ph + 4);
+            seg->vaddr = Elf_U32(ph + 8);
+            seg->paddr = Elf_U32(ph + 12);
+            seg->filesz = Elf_U32(ph + 16);
+            seg->memsz = Elf_U32(ph + 20);
+            seg->flags = Elf_U32(ph + 24);
+        }
+        if (seg->offset + seg->filesz > elf->size || seg->filesz > seg->memsz) return -1;
+        elf->segment_count++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Load an ELF file, its function symbols and loadable segments
+ * @param elf: Destination
+ * @param path: ELF file
+ * @return 0 on success, -1 on error
+ */
+int Elf_Load(Elf_File *elf, const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    long length;
+
+    memset(elf, 0, sizeof(*elf));
+    if (f == NULL) return -1;
+
+    if (fseek(f, 0, SEEK_END) != 0 || (length = ftell(f)) < 52 || fseek(f, 0, SEEK_SET) != 0)
+    {
+        fclose(f);
+        return -1;
+    }
+    elf->size = (size_t)length;
+    elf->data = (uint8_t *)malloc(elf->size + 1);
+    if (elf->data == NULL || fread(elf->data, 1, elf->size, f) != elf->size)
+    {
+        fclose(f);
+        Elf_Free(elf);
+        return -1;
+    }
+    fclose(f);
+    elf->data[elf->size] = 0;  // Terminates a string table that runs to EOF
+
+    const uint8_t *h = elf->data;
+    if (memcmp(h, "\177ELF", 4) != 0 || h[5] != 1 || (h[4] != 1 && h[4] != 2))
+    {
+        Elf_Free(elf);
+        return -1;
+    }
+    elf->is64 = (h[4] == 2);
+    elf->machine = Elf_U16(h + 18);
+    elf->entry = Elf_Word(elf, h + 24);
+
+    if (Elf_Read_Segments(elf) != 0)
+    {
+        Elf_Free(elf);
+        return -1;
+    }
+
+    uint64_t shoff = Elf_Word(elf, h + (elf->is64 ? 40 : 32));
+    uint16_t shentsize = Elf_U16(h + (elf->is64 ? 58 : 46));
+    uint16_t shnum = Elf_U16(h + (elf->is64 ? 60 : 48));
+    if (shoff == 0 || shoff + (uint64_t)shnum * shentsize > elf->size)
+    {
+        Elf_Free(elf);
+        return -1;
+    }
+
+    const uint8_t *sections = elf->data + shoff;
+    for (uint16_t i = 0; i < shnum; i++)
+    {
+        const uint8_t *sh = sections + (size_t)i * shentsize;
+        if (Elf_U32(sh + 4) == ELF_SHT_SYMTAB && Elf_Read_Symtab(elf, sh, sections, shentsize) != 0)
+        {
+            Elf_Free(elf);
+            return -1;
+        }
+    }
+
+    qsort(elf->symbols, elf->symbol_count, sizeof(Elf_Symbol), Elf_Symbol_Compare);
+    return 0;
+}
+
+/**
+ * @brief Release a loaded file
+ */
+void Elf_Free(Elf_File *elf)
+{
+    free(elf->symbols);
+    free(elf->segments);
+    free(elf->data);
+    memset(elf, 0, sizeof(*elf));
+}
+
+/**
+ * @brief Find the function containing an address
+ * @return Symbol, or NULL if the address is outside every function
+ */
+const Elf_Symbol *Elf_Find_Symbol(const Elf_File *elf, uint64_t addr)
+{
+    size_t lo = 0, hi = elf->symbol_count;
+
+    // Last symbol starting at or below addr
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (elf->symbols[mid].addr <= addr) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == 0) return NULL;
+
+    // Unsized symbols (assembly) extend to the next symbol, never past the last
+    const Elf_Symbol *sym = &elf->symbols[lo - 1];
+    if (sym->size != 0 ? addr >= sym->addr + sym->size : lo == elf->symbol_count) return NULL;
+    return sym;
+}
+
+/**
+ * @brief Find a function symbol by name
+ */
+const Elf_Symbol *Elf_Lookup(const Elf_File *elf, const char *name)
+{
+    for (size_t i = 0; i < elf->symbol_count; i++)
+    {
+        if (strcmp(elf->symbols[i].name, name) == 0) return &elf->symbols[i];
+    }
+    return NULL;
+}
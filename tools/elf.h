@@ -0,0 +1,48 @@
+/**
+ * @file elf.h
+ * @brief Minimal ELF reader for the host tools
+ * @description Loads a little-endian ELF32 (ARM firmware) or ELF64 (host
+ *              simulation build) file and extracts its function symbols,
+ *              sorted by address, for address-to-function lookups, and its
+ *              loadable segments for tools that place the image in memory.
+ */
+
+#ifndef ELF_H
+#define ELF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    const char *name;       // Points into the loaded file
+    uint64_t addr;          // Start address (Thumb bit cleared)
+    uint64_t size;          // Size in bytes (0 if unknown)
+} Elf_Symbol;
+
+typedef struct {
+    uint64_t vaddr;         // Run address (p_vaddr)
+    uint64_t paddr;         // Load address (p_paddr; flash copy of .data)
+    uint64_t offset;        // File offset of the contents
+    uint64_t filesz;        // Bytes present in the file
+    uint64_t memsz;         // Bytes in memory (the rest is zero, .bss)
+    uint32_t flags;         // PF_X 1, PF_W 2, PF_R 4
+} Elf_Segment;
+
+typedef struct {
+    uint8_t *data;          // Whole file
+    size_t size;
+    int is64;               // ELFCLASS64
+    uint16_t machine;       // e_machine (40 = ARM)
+    uint64_t entry;         // e_entry
+    Elf_Symbol *symbols;    // Function symbols sorted by address
+    size_t symbol_count;
+    Elf_Segment *segments;  // PT_LOAD segments in file order
+    size_t segment_count;
+} Elf_File;
+
+int Elf_Load(Elf_File *elf, const char *path);
+void Elf_Free(Elf_File *elf);
+const Elf_Symbol *Elf_Find_Symbol(const Elf_File *elf, uint64_t addr);
+const Elf_Symbol *Elf_Lookup(const Elf_File *elf, const char *name);
+
+#endif /* ELF_H */
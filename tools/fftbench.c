@@ -0,0 +1,170 @@
+/**
+ * @file fftbench.c
+ * @brief Accuracy and speed of fft.c on the host
+ * @description For every size, transforms a deterministic test signal with
+ *              the float and (up to FFT_Q15_MAX_N) Q15 paths, compares the
+ *              bins against a double-precision DFT and reports the time per
+ *              transform. The DFT check is skipped above 8192 points.
+ *
+ * Build:
+ *   gcc -O3 -march=native -I. tools/fftbench.c fft.c -lm -o fftbench
+ *   (add -DFFT_SIMD=0 to time the scalar float path)
+ *
+ * Usage:
+ *   fftbench [-n max_size]
+ *
+ * Errors are the largest bin error relative to the largest bin magnitude.
+ */
+
+#include "fft.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FFTBENCH_DFT_MAX       8192
+#define FFTBENCH_MIN_NS        50000000.0  // Time each size for at least 50 ms
+#define FFTBENCH_BATCH         8           // Transforms between clock reads
+
+static double FFTBench_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Test signal: two tones, a ramp and hash noise, within +-16000
+ */
+static void FFTBench_Signal(uint32_t n, float *x, int16_t *q)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t h = (i + 1) * 2654435761UL;
+        double v = 7000.0 * sin(0.0123 * i) + 5000.0 * cos(1.7 * i) + 2000.0 * ((double)i / n - 0.5) +
+                   (double)((h >> 20) & 1023) - 512.0;
+        q[i] = (int16_t)lrint(v);
+        x[i] = (float)q[i];
+    }
+}
+
+/**
+ * @brief Largest bin error of (re, im) * scale against a double DFT
+ */
+static double FFTBench_Error(uint32_t n, const double *ref_re, const double *ref_im,
+                             const float *re, const float *im, double scale)
+{
+    double peak = 0.0, error = 0.0;
+
+    for (uint32_t k = 0; k <= n / 2; k++)
+    {
+        peak = fmax(peak, hypot(ref_re[k], ref_im[k]));
+        error = fmax(error, hypot(re[k] * scale - ref_re[k], im[k] * scale - ref_im[k]));
+    }
+    return error / peak;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t max_n = 65536;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (val != NULL && strcmp(argv[i], "-n") == 0)
+        {
+            max_n = (uint32_t)strtoul(val, NULL, 0);
+            i++;
+        }
+        else
+        {
+            fprintf(stderr, "usage: fftbench [-n max_size]\n");
+            return 2;
+        }
+    }
+
+    printf("# fftbench simd=%d\n", FFT_SIMD);
+    printf("n,float_ns,float_error,q15_ns,q15_error\n");
+
+    for (uint32_t n = 16; n <= max_n; n *= 2)
+    {
+        float *x = (float *)malloc(n * sizeof(float));
+        int16_t *q = (int16_t *)malloc(n * sizeof(int16_t));
+        float *re = (float *)malloc((n / 2 + 1) * sizeof(float));
+        float *im = (float *)malloc((n / 2 + 1) * sizeof(float));
+        double *ref_re = (double *)calloc(n / 2 + 1, sizeof(double));
+        double *ref_im = (double *)calloc(n / 2 + 1, sizeof(double));
+        Fft_Plan plan;
+
+        if (!x || !q || !re || !im || !ref_re || !ref_im || Fft_Init(&plan, n) != 0)
+        {
+            fprintf(stderr, "fftbench: out of memory\n");
+            return 1;
+        }
+        FFTBench_Signal(n, x, q);
+
+        int checked = (n <= FFTBENCH_DFT_MAX);
+        if (checked)
+        {
+            for (uint32_t k = 0; k <= n / 2; k++)
+            {
+                for (uint32_t i = 0; i < n; i++)
+                {
+                    double angle = -6.283185307179586 * (double)(((uint64_t)k * i) % n) / n;
+                    ref_re[k] += x[i] * cos(angle);
+                    ref_im[k] += x[i] * sin(angle);
+                }
+            }
+        }
+
+        // Float path
+        uint32_t runs = 0;
+        double start = FFTBench_Now(), elapsed;
+        do
+        {
+            for (int r = 0; r < FFTBENCH_BATCH; r++) Fft_Real(&plan, x, re, im);
+            runs += FFTBENCH_BATCH;
+            elapsed = FFTBench_Now() - start;
+        } while (elapsed < FFTBENCH_MIN_NS);
+        printf("%u,%.1f,", n, elapsed / runs);
+        if (checked) printf("%.2e,", FFTBench_Error(n, ref_re, ref_im, re, im, 1.0));
+        else printf(",");
+
+        // Q15 path (bins are DFT / (n/2))
+        if (n <= FFT_Q15_MAX_N)
+        {
+            static Fft_Q15_Plan q15_plan;
+            int16_t q_re[FFT_Q15_MAX_N / 2 + 1], q_im[FFT_Q15_MAX_N / 2 + 1];
+
+            Fft_Q15_Init(&q15_plan, n);
+            runs = 0;
+            start = FFTBench_Now();
+            do
+            {
+                for (int r = 0; r < FFTBENCH_BATCH; r++) Fft_Q15_Real(&q15_plan, q, q_re, q_im);
+                runs += FFTBENCH_BATCH;
+                elapsed = FFTBench_Now() - start;
+            } while (elapsed < FFTBENCH_MIN_NS);
+            for (uint32_t k = 0; k <= n / 2; k++)
+            {
+                re[k] = q_re[k];
+                im[k] = q_im[k];
+            }
+            printf("%.1f,%.2e\n", elapsed / runs, FFTBench_Error(n, ref_re, ref_im, re, im, n / 2.0));
+        }
+        else
+        {
+            printf(",\n");
+        }
+
+        Fft_Free(&plan);
+        free(x);
+        free(q);
+        free(re);
+        free(im);
+        free(ref_re);
+        free(ref_im);
+    }
+    return 0;
+}
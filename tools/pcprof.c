@@ -0,0 +1,164 @@
+/**
+ * @file pcprof.c
+ * @brief Symbolize PC-sampling profiler reports into a per-function profile
+ * @description Reads the "# pcprof" windows streamed by profiler.c (from a
+ *              captured UART log or the host simulation's stdout; other
+ *              lines are ignored), resolves every sampled address against
+ *              the firmware ELF and prints samples per function, hottest
+ *              first. All windows in the input are summed.
+ *
+ * Build:
+ *   gcc -O2 -I. tools/pcprof.c tools/elf.c -o pcprof
+ *
+ * Usage:
+ *   pcprof firmware.elf [report.log]     (report defaults to stdin)
+ *
+ * Each window carries the run-time address of Profiler_Start ("anchor");
+ * the difference to its ELF address is subtracted from every sample, which
+ * undoes the load offset of a position-independent host build (it is zero
+ * on the target).
+ */
+
+#include "elf.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;       // Function, or NULL for unresolved samples
+    uint64_t samples;
+} Pcprof_Entry;
+
+static Pcprof_Entry *pcprof_entries;
+static size_t pcprof_count;
+static size_t pcprof_capacity;
+
+/**
+ * @brief Add samples to a function's total
+ */
+static int Pcprof_Add(const char *name, uint64_t samples)
+{
+    for (size_t i = 0; i < pcprof_count; i++)
+    {
+        if (pcprof_entries[i].name == name)
+        {
+            pcprof_entries[i].samples += samples;
+            return 0;
+        }
+    }
+    if (pcprof_count == pcprof_capacity)
+    {
+        size_t capacity = pcprof_capacity ? pcprof_capacity * 2 : 64;
+        Pcprof_Entry *grown = (Pcprof_Entry *)realloc(pcprof_entries, capacity * sizeof(Pcprof_Entry));
+        if (grown == NULL) return -1;
+        pcprof_entries = grown;
+        pcprof_capacity = capacity;
+    }
+    pcprof_entries[pcprof_count].name = name;
+    pcprof_entries[pcprof_count].samples = samples;
+    pcprof_count++;
+    return 0;
+}
+
+static int Pcprof_Compare(const void *a, const void *b)
+{
+    const Pcprof_Entry *ea = (const Pcprof_Entry *)a;
+    const Pcprof_Entry *eb = (const Pcprof_Entry *)b;
+    return (ea->samples < eb->samples) - (ea->samples > eb->samples);
+}
+
+/**
+ * @brief Read one "key=value" unsigned field from a header line
+ */
+static uint64_t Pcprof_Field(const char *line, const char *key, int base)
+{
+    const char *p = strstr(line, key);
+    return p ? strtoull(p + strlen(key), NULL, base) : 0;
+}
+
+int main(int argc, char **argv)
+{
+    Elf_File elf;
+    FILE *in = stdin;
+    char line[256];
+    uint64_t total = 0, dropped = 0, hz = 0, windows = 0;
+    uint64_t slide = 0;
+    int in_window = 0;
+
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "usage: pcprof firmware.elf [report.log]\n");
+        return 1;
+    }
+    if (Elf_Load(&elf, argv[1]) != 0)
+    {
+        fprintf(stderr, "pcprof: cannot read ELF %s\n", argv[1]);
+        return 1;
+    }
+    const Elf_Symbol *anchor = Elf_Lookup(&elf, "Profiler_Start");
+    if (anchor == NULL)
+    {
+        fprintf(stderr, "pcprof: %s has no Profiler_Start symbol\n", argv[1]);
+        return 1;
+    }
+    if (argc == 3 && (in = fopen(argv[2], "r")) == NULL)
+    {
+        fprintf(stderr, "pcprof: cannot read %s\n", argv[2]);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        if (strncmp(line, "# pcprof", 8) == 0)
+        {
+            uint64_t anchor_pc = Pcprof_Field(line, "anchor=", 16) & ~1ULL;
+            slide = anchor_pc - anchor->addr;
+            hz = Pcprof_Field(line, "hz=", 10);
+            dropped += Pcprof_Field(line, "dropped=", 10);
+            windows++;
+            in_window = 1;
+        }
+        else if (strncmp(line, "# end", 5) == 0)
+        {
+            in_window = 0;
+        }
+        else if (in_window)
+        {
+            char *end;
+            uint64_t pc = strtoull(line, &end, 16);
+            if (end == line || *end != ',') continue;  // "pc,count" header
+            uint64_t samples = strtoull(end + 1, NULL, 10);
+            const Elf_Symbol *sym = Elf_Find_Symbol(&elf, pc - slide);
+
+            if (Pcprof_Add(sym ? sym->name : NULL, samples) != 0)
+            {
+                fprintf(stderr, "pcprof: out of memory\n");
+                return 1;
+            }
+            total += samples;
+        }
+    }
+    if (in != stdin) fclose(in);
+
+    if (total == 0)
+    {
+        fprintf(stderr, "pcprof: no samples found\n");
+        return 1;
+    }
+
+    qsort(pcprof_entries, pcprof_count, sizeof(Pcprof_Entry), Pcprof_Compare);
+    printf("# %" PRIu64 " samples in %" PRIu64 " windows, %" PRIu64 " dropped", total, windows, dropped);
+    if (hz != 0) printf(", %.1f s at %" PRIu64 " Hz", (double)(total + dropped) / (double)hz, hz);
+    printf("\n%9s %7s  %s\n", "samples", "%", "function");
+    for (size_t i = 0; i < pcprof_count; i++)
+    {
+        printf("%9" PRIu64 " %7.2f  %s\n", pcprof_entries[i].samples,
+               100.0 * (double)pcprof_entries[i].samples / (double)total,
+               pcprof_entries[i].name ? pcprof_entries[i].name : "[unknown]");
+    }
+
+    free(pcprof_entries);
+    Elf_Free(&elf);
+    return 0;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file profile_cost.c
+ * @brief Per-sample cost of one firmware profile in the host simulation
+ * @description Drives App_Poll() over a synthetic temperature ramp and prints
+ *              the host time per main loop iteration. Used by
+ *              tools/profile_report.sh; build with -DHOST_SIMULATION and the
+ *              same -DPROFILE_* as the firmware under test.
+ */
+
+#include "../stm32f4xx.h"
+#include "../config.h"
+#include "../sim/sim.h"
+#include <stdio.h>
+#include <time.h>
+
+#define PROFILE_COST_SAMPLES   2000000UL
+
+void App_Init(void);
+void App_Poll(void);
+
+int main(void)
+{
+    struct timespec start, end;
+
+    Sim_Reset();
+    App_Init();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < PROFILE_COST_SAMPLES; i++)
+    {
+        // Triangle sweep over the full ADC range with a little dither
+        uint32_t phase = (i / 4) % 8190;
+        uint16_t adc_value = (uint16_t)((phase < 4095 ? phase : 8190 - phase) ^ (i & 3));
+        Sim_Set_Adc_Input(adc_value);
+        App_Poll();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double ns = (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec);
+    printf("%s %.1f\n", PROFILE_NAME, ns / (double)PROFILE_COST_SAMPLES);
+    return 0;
+}
@@ -0,0 +1,45 @@
+#!/bin/sh
+# @file profile_report.sh
+# @brief Build every firmware profile and report code size and per-sample cost
+#
+# Flash/RAM sizes come from arm-none-eabi-gcc (Cortex-M4, -Os, section GC)
+# when it is installed, otherwise from the host compiler as a relative
+# indication. Per-sample cost is the host-simulation time of one App_Poll().
+#
+# Usage: tools/profile_report.sh   (from the repository root)
+
+set -e
+
+PROFILES="MINIMAL STANDARD FULL"
+SOURCES="main.c pipeline.c anomaly.c policy.c adc_multi.c packed12.c bench.c uart.c profiler.c dds.c multirate.c capture.c lag.c fft.c limiter.c autorange.c"
+OUT=${TMPDIR:-/tmp}/profile_report.$$
+mkdir -p "$OUT"
+trap 'rm -rf "$OUT"' EXIT
+
+if command -v arm-none-eabi-gcc >/dev/null 2>&1; then
+    CC_TARGET="arm-none-eabi-gcc -mcpu=cortex-m4 -mthumb -mfloat-abi=hard -mfpu=fpv4-sp-d16 -DSTM32_TARGET_COMPILATION --specs=nosys.specs"
+    SIZE=arm-none-eabi-size
+    TARGET="cortex-m4"
+else
+    CC_TARGET="${CC:-cc}"
+    SIZE=size
+    TARGET="host"
+fi
+
+printf "%-10s %10s %8s %8s %14s\n" "profile" "text" "data" "bss" "ns/sample"
+for p in $PROFILES; do
+    # Code size: link with unused sections removed so disabled stages vanish
+    $CC_TARGET -Os -ffunction-sections -fdata-sections -Wl,--gc-sections \
+        -DPROFILE_$p -I. $SOURCES -lm -o "$OUT/fw_$p.elf"
+    set -- $($SIZE "$OUT/fw_$p.elf" | tail -n 1)
+    text=$1 data=$2 bss=$3
+
+    # Per-sample cost in the host simulation
+    ${CC:-cc} -O2 -DHOST_SIMULATION -DPROFILE_$p -I. $SOURCES sim/sim.c \
+        tools/profile_cost.c -lm -o "$OUT/cost_$p"
+    set -- $("$OUT/cost_$p" | tail -n 1)
+    ns=$2
+
+    printf "%-10s %10s %8s %8s %14s\n" "$(echo $p | tr A-Z a-z)" "$text" "$data" "$bss" "$ns"
+done
+echo "(sizes: $TARGET toolchain)"
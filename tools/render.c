@@ -0,0 +1,507 @@
+/**
+ * @file render.c
+ * @brief Render a recorded ADC trace to a WAV file, with an on-disk chunk cache
+ * @description Runs the control pipeline over the trace and drives a DDS sine
+ *              voice with the resulting frequency, each reading lasting a
+ *              fixed number of audio samples (time-compressed playback of
+ *              long logs).
+ *
+ * Build:
+ *   gcc -O2 -I. tools/render.c tools/trace.c tools/wav.c pipeline.c dds.c -lm -o render
+ *
+ * Usage:
+ *   render -t trace.txt -o out.wav [-r 10] [-s 16000] [-p 160]
+ *          [-c cache_dir] [--chunk 3000] [--index trace.idx]
+ *          [--from seconds] [--duration seconds]
+ *          [--min 200] [--max 2000] [--deadband 5] [--cutoff 0] [--glide 0]
+ *
+ * Chunk cache (-c): the trace is split into chunks of --chunk readings. Each
+ * chunk is rendered from oscillator phase 0 as an in-phase/quadrature pair,
+ * I = A sin(theta), Q = A cos(theta), and stored under a key made of the
+ * chunk contents, the rendering configuration and the pipeline state at the
+ * chunk start. Stitching shifts a chunk to the running phase phi exactly,
+ * A sin(theta + phi) = I cos(phi) + Q sin(phi), so cached chunks join
+ * phase-continuously wherever they came from. After a change only chunks
+ * whose key changed are rendered again: an edited stretch of the log (and
+ * the chunks after it until the filter state settles), or everything when a
+ * mapping parameter changes.
+ *
+ * Random access (--from/--duration, in seconds of log time): every chunk
+ * boundary is a checkpoint holding the pipeline state (filter memory, glide,
+ * programmed frequency) and the oscillator phase at that point. Rendering a
+ * window starts at the checkpoint of the chunk containing --from, so the
+ * work is bounded by one chunk plus the window, and the audio is identical
+ * to the same stretch of a full render. Checkpoints come from a fast
+ * pipeline-only pass; --index stores them next to the log and reuses them
+ * while the trace and configuration are unchanged.
+ */
+
+#include "../pipeline.h"
+#include "../dds.h"
+#include "trace.h"
+#include "wav.h"
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define RENDER_AMPLITUDE       16384        // Voice amplitude (Q15, half scale)
+#define RENDER_CACHE_MAGIC     0x4B4E4843UL // "CHNK"
+#define RENDER_CACHE_VERSION   1
+#define RENDER_INDEX_MAGIC     0x54504B43UL // "CKPT"
+#define RENDER_INDEX_VERSION   1
+#define RENDER_FNV_OFFSET      0xCBF29CE484222325ULL
+#define RENDER_FNV_PRIME       0x100000001B3ULL
+
+typedef struct {
+    Pipeline_Config cfg;
+    uint32_t sample_rate;           // Audio samples per second
+    uint32_t samples_per_reading;   // Audio samples per ADC reading
+    uint32_t chunk_readings;        // Readings per cache chunk
+    const char *cache_dir;          // NULL = no cache
+    uint64_t config_hash;
+} Render_Context;
+
+// One rendered chunk: header followed by `samples` I/Q pairs on disk
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t samples;               // Audio samples in the chunk
+    uint32_t phase_advance;         // Oscillator phase gained over the chunk
+    Pipeline_State exit;            // Pipeline state after the last reading
+} Render_Chunk;
+
+// Chunk-boundary checkpoint
+typedef struct {
+    Pipeline_State entry;           // Pipeline state before the chunk's first reading
+    uint32_t phase;                 // Oscillator phase at the chunk start
+} Render_Checkpoint;
+
+// Checkpoint index file: header followed by `count` checkpoints
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t config_hash;
+    uint64_t trace_hash;
+    uint64_t readings;
+    uint32_t chunk_readings;
+    uint32_t count;
+} Render_Index;
+
+/**
+ * @brief FNV-1a over a byte range
+ */
+static uint64_t Render_Hash(uint64_t hash, const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= RENDER_FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t Render_Hash_U32(uint64_t hash, uint32_t value)
+{
+    uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    return Render_Hash(hash, bytes, sizeof(bytes));
+}
+
+/**
+ * @brief Hash of everything that changes the rendered audio of a chunk
+ */
+static uint64_t Render_Config_Hash(const Render_Context *ctx)
+{
+    uint64_t hash = Render_Hash_U32(RENDER_FNV_OFFSET, RENDER_CACHE_VERSION);
+    hash = Render_Hash_U32(hash, ctx->cfg.min_freq);
+    hash = Render_Hash_U32(hash, ctx->cfg.max_freq);
+    hash = Render_Hash_U32(hash, ctx->cfg.deadband_hz);
+    hash = Render_Hash_U32(hash, ctx->cfg.filter_alpha);
+    hash = Render_Hash_U32(hash, ctx->cfg.glide_alpha);
+    hash = Render_Hash_U32(hash, ctx->sample_rate);
+    hash = Render_Hash_U32(hash, ctx->samples_per_reading);
+    return Render_Hash_U32(hash, RENDER_AMPLITUDE);
+}
+
+/**
+ * @brief Cache key: configuration, chunk contents and entry pipeline state
+ */
+static uint64_t Render_Chunk_Key(const Render_Context *ctx, const uint16_t *readings, size_t count,
+                                 const Pipeline_State *entry)
+{
+    uint64_t hash = ctx->config_hash;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint8_t bytes[2] = { (uint8_t)readings[i], (uint8_t)(readings[i] >> 8) };
+        hash = Render_Hash(hash, bytes, sizeof(bytes));
+    }
+    hash = Render_Hash_U32(hash, (uint32_t)entry->filtered_q16);
+    hash = Render_Hash_U32(hash, (uint32_t)entry->glide_q8);
+    return Render_Hash_U32(hash, entry->frequency);
+}
+
+/**
+ * @brief Render one chunk from phase 0 into I/Q pairs
+ * @param iq: Output, 2 * count * samples_per_reading values
+ */
+static void Render_Chunk_Run(const Render_Context *ctx, const uint16_t *readings, size_t count,
+                             const Pipeline_State *entry, int16_t *iq, Render_Chunk *chunk)
+{
+    Pipeline_State state = *entry;
+    uint32_t phase = 0;
+    size_t n = 0;
+
+    for (size_t r = 0; r < count; r++)
+    {
+        Pipeline_Step(&state, &ctx->cfg, readings[r]);
+        uint32_t increment = DDS_Increment(state.frequency, ctx->sample_rate);
+
+        for (uint32_t s = 0; s < ctx->samples_per_reading; s++)
+        {
+            iq[n++] = (int16_t)((RENDER_AMPLITUDE * DDS_Sine(phase)) >> 15);
+            iq[n++] = (int16_t)((RENDER_AMPLITUDE * DDS_Sine(phase + DDS_QUARTER_TURN)) >> 15);
+            phase += increment;
+        }
+    }
+
+    chunk->samples = (uint32_t)(n / 2);
+    chunk->phase_advance = phase;
+    chunk->exit = state;
+}
+
+/**
+ * @brief Hash of the whole trace (validates a stored index)
+ */
+static uint64_t Render_Trace_Hash(const Trace *trace)
+{
+    uint64_t hash = RENDER_FNV_OFFSET;
+    for (size_t i = 0; i < trace->count; i++)
+    {
+        uint8_t bytes[2] = { (uint8_t)trace->samples[i], (uint8_t)(trace->samples[i] >> 8) };
+        hash = Render_Hash(hash, bytes, sizeof(bytes));
+    }
+    return hash;
+}
+
+/**
+ * @brief Checkpoints for every chunk: pipeline-only pass, no audio
+ */
+static void Render_Index_Build(const Render_Context *ctx, const Trace *trace,
+                               Render_Checkpoint *checkpoints, uint32_t count)
+{
+    Pipeline_State state;
+    uint32_t phase = 0;
+
+    Pipeline_Init(&state, &ctx->cfg, Pipeline_Map(&ctx->cfg, trace->samples[0]));
+    for (uint32_t c = 0; c < count; c++)
+    {
+        size_t first = (size_t)c * ctx->chunk_readings;
+        size_t last = first + ctx->chunk_readings < trace->count ? first + ctx->chunk_readings : trace->count;
+
+        checkpoints[c].entry = state;
+        checkpoints[c].phase = phase;
+        for (size_t r = first; r < last; r++)
+        {
+            Pipeline_Step(&state, &ctx->cfg, trace->samples[r]);
+            phase += DDS_Increment(state.frequency, ctx->sample_rate) * ctx->samples_per_reading;
+        }
+    }
+}
+
+/**
+ * @brief Load a stored index if it matches this trace and configuration
+ * @return 0 on success, -1 if missing or stale
+ */
+static int Render_Index_Load(const char *path, const Render_Index *expect, Render_Checkpoint *checkpoints)
+{
+    Render_Index header;
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return -1;
+
+    int ok = fread(&header, sizeof(header), 1, f) == 1 &&
+             memcmp(&header, expect, sizeof(header)) == 0 &&
+             fread(checkpoints, sizeof(Render_Checkpoint), header.count, f) == header.count;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+static int Render_Index_Store(const char *path, const Render_Index *header, const Render_Checkpoint *checkpoints)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return -1;
+
+    int ok = fwrite(header, sizeof(*header), 1, f) == 1 &&
+             fwrite(checkpoints, sizeof(Render_Checkpoint), header->count, f) == header->count;
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+static void Render_Cache_Path(char *path, size_t size, const char *dir, uint64_t key)
+{
+    snprintf(path, size, "%s/%016llx.chunk", dir, (unsigned long long)key);
+}
+
+/**
+ * @brief Load a chunk from the cache
+ * @return 0 on hit, -1 on miss (or a damaged entry)
+ */
+static int Render_Cache_Load(const char *dir, uint64_t key, uint32_t samples,
+                             int16_t *iq, Render_Chunk *chunk)
+{
+    char path[1024];
+    Render_Cache_Path(path, sizeof(path), dir, key);
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return -1;
+
+    int ok = fread(chunk, sizeof(*chunk), 1, f) == 1 &&
+             chunk->magic == RENDER_CACHE_MAGIC && chunk->version == RENDER_CACHE_VERSION &&
+             chunk->key == key && chunk->samples == samples &&
+             fread(iq, 2 * sizeof(int16_t), samples, f) == samples;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief Store a chunk (written to a temporary file, then renamed into place)
+ */
+static void Render_Cache_Store(const char *dir, uint64_t key, const int16_t *iq, const Render_Chunk *chunk)
+{
+    char path[1024], tmp[1040];
+    Render_Cache_Path(path, sizeof(path), dir, key);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    FILE *f = fopen(tmp, "wb");
+    if (f == NULL) return;
+
+    int ok = fwrite(chunk, sizeof(*chunk), 1, f) == 1 &&
+             fwrite(iq, 2 * sizeof(int16_t), chunk->samples, f) == chunk->samples;
+    if (fclose(f) != 0) ok = 0;
+    if (!ok || rename(tmp, path) != 0) remove(tmp);
+}
+
+/**
+ * @brief Shift a phase-0 chunk to the running phase: I cos(phi) + Q sin(phi)
+ */
+static void Render_Stitch(const int16_t *iq, uint32_t samples, uint32_t phase, int16_t *out)
+{
+    double phi = (double)phase * (6.283185307179586 / 4294967296.0);
+    int32_t c = (int32_t)lrint(32767.0 * cos(phi));
+    int32_t s = (int32_t)lrint(32767.0 * sin(phi));
+
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        out[i] = (int16_t)((iq[2 * i] * c + iq[2 * i + 1] * s) >> 15);
+    }
+}
+
+static double Render_Now_Ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+static void Render_Usage(void)
+{
+    fprintf(stderr,
+            "usage: render -t trace -o out.wav [-r rate_hz] [-s sample_rate]\n"
+            "              [-p samples_per_reading] [-c cache_dir] [--chunk readings]\n"
+            "              [--index file] [--from s] [--duration s]\n"
+            "              [--min hz] [--max hz] [--deadband hz] [--cutoff hz] [--glide ms]\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *trace_path = NULL, *out_path = NULL, *index_path = NULL;
+    double from_s = 0.0, duration_s = -1.0;
+    float rate_hz = 10.0f;  // One reading per 100 ms main loop
+    float cutoff_hz = 0.0f, glide_ms = 0.0f;
+    Render_Context ctx;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = (Pipeline_Config)PIPELINE_CONFIG_DEFAULT;
+    ctx.sample_rate = 16000;
+    ctx.samples_per_reading = 160;
+    ctx.chunk_readings = 3000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int bad = (val == NULL);
+
+        if (!bad && strcmp(opt, "-t") == 0) trace_path = val;
+        else if (!bad && strcmp(opt, "-o") == 0) out_path = val;
+        else if (!bad && strcmp(opt, "-r") == 0) rate_hz = strtof(val, NULL);
+        else if (!bad && strcmp(opt, "-s") == 0) ctx.sample_rate = (uint32_t)atoi(val);
+        else if (!bad && strcmp(opt, "-p") == 0) ctx.samples_per_reading = (uint32_t)atoi(val);
+        else if (!bad && strcmp(opt, "-c") == 0) ctx.cache_dir = val;
+        else if (!bad && strcmp(opt, "--chunk") == 0) ctx.chunk_readings = (uint32_t)atoi(val);
+        else if (!bad && strcmp(opt, "--index") == 0) index_path = val;
+        else if (!bad && strcmp(opt, "--from") == 0) from_s = strtod(val, NULL);
+        else if (!bad && strcmp(opt, "--duration") == 0) duration_s = strtod(val, NULL);
+        else if (!bad && strcmp(opt, "--min") == 0) ctx.cfg.min_freq = (uint32_t)atoi(val);
+        else if (!bad && strcmp(opt, "--max") == 0) ctx.cfg.max_freq = (uint32_t)atoi(val);
+        else if (!bad && strcmp(opt, "--deadband") == 0) ctx.cfg.deadband_hz = (uint32_t)atoi(val);
+        else if (!bad && strcmp(opt, "--cutoff") == 0) cutoff_hz = strtof(val, NULL);
+        else if (!bad && strcmp(opt, "--glide") == 0) glide_ms = strtof(val, NULL);
+        else bad = 1;
+
+        if (bad)
+        {
+            Render_Usage();
+            return 2;
+        }
+        i++;
+    }
+
+    if (trace_path == NULL || out_path == NULL || rate_hz <= 0.0f || ctx.sample_rate == 0 ||
+        ctx.samples_per_reading == 0 || ctx.chunk_readings == 0 || from_s < 0.0)
+    {
+        Render_Usage();
+        return 2;
+    }
+
+    ctx.cfg.filter_alpha = Pipeline_Alpha_From_Cutoff(cutoff_hz, rate_hz);
+    ctx.cfg.glide_alpha = Pipeline_Alpha_From_Time(glide_ms, 1000.0f / rate_hz);
+    ctx.config_hash = Render_Config_Hash(&ctx);
+    DDS_Init();
+
+    if (ctx.cache_dir != NULL && mkdir(ctx.cache_dir, 0777) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "render: cannot create cache directory %s\n", ctx.cache_dir);
+        return 1;
+    }
+
+    Trace trace;
+    if (Trace_Load(&trace, trace_path, rate_hz) != 0 || trace.count == 0)
+    {
+        fprintf(stderr, "render: cannot read trace %s\n", trace_path);
+        return 1;
+    }
+
+    size_t chunk_samples = (size_t)ctx.chunk_readings * ctx.samples_per_reading;
+    int16_t *iq = (int16_t *)malloc(chunk_samples * 2 * sizeof(int16_t));
+    int16_t *pcm = (int16_t *)malloc(chunk_samples * sizeof(int16_t));
+    if (iq == NULL || pcm == NULL)
+    {
+        fprintf(stderr, "render: out of memory\n");
+        return 1;
+    }
+
+    Wav_Writer wav;
+    if (Wav_Open(&wav, out_path, ctx.sample_rate) != 0)
+    {
+        fprintf(stderr, "render: cannot write %s\n", out_path);
+        return 1;
+    }
+
+    // Window in readings (whole trace by default)
+    size_t window_first = (size_t)(from_s * rate_hz);
+    size_t window_end = duration_s < 0.0 ? trace.count : window_first + (size_t)(duration_s * rate_hz);
+    if (window_end > trace.count) window_end = trace.count;
+    if (window_first >= window_end)
+    {
+        fprintf(stderr, "render: window is outside the trace\n");
+        return 1;
+    }
+
+    // Starting point: nearest chunk-boundary checkpoint at or before the window
+    Pipeline_State state;
+    uint32_t phase = 0;
+    size_t first_chunk = window_first / ctx.chunk_readings;
+
+    if (first_chunk > 0 || index_path != NULL)
+    {
+        Render_Index header;
+        memset(&header, 0, sizeof(header));
+        header.magic = RENDER_INDEX_MAGIC;
+        header.version = RENDER_INDEX_VERSION;
+        header.config_hash = ctx.config_hash;
+        header.trace_hash = Render_Trace_Hash(&trace);
+        header.readings = trace.count;
+        header.chunk_readings = ctx.chunk_readings;
+        header.count = (uint32_t)((trace.count + ctx.chunk_readings - 1) / ctx.chunk_readings);
+
+        Render_Checkpoint *checkpoints = (Render_Checkpoint *)malloc(header.count * sizeof(Render_Checkpoint));
+        if (checkpoints == NULL)
+        {
+            fprintf(stderr, "render: out of memory\n");
+            return 1;
+        }
+        if (index_path == NULL || Render_Index_Load(index_path, &header, checkpoints) != 0)
+        {
+            Render_Index_Build(&ctx, &trace, checkpoints, header.count);
+            if (index_path != NULL && Render_Index_Store(index_path, &header, checkpoints) != 0)
+            {
+                fprintf(stderr, "render: cannot write %s\n", index_path);
+            }
+        }
+        state = checkpoints[first_chunk].entry;
+        phase = checkpoints[first_chunk].phase;
+        free(checkpoints);
+    }
+    else
+    {
+        Pipeline_Init(&state, &ctx.cfg, Pipeline_Map(&ctx.cfg, trace.samples[0]));
+    }
+
+    size_t hits = 0, misses = 0;
+    double start = Render_Now_Ms();
+
+    for (size_t first = first_chunk * ctx.chunk_readings; first < window_end; first += ctx.chunk_readings)
+    {
+        size_t count = trace.count - first < ctx.chunk_readings ? trace.count - first : ctx.chunk_readings;
+        uint32_t samples = (uint32_t)(count * ctx.samples_per_reading);
+        uint64_t key = Render_Chunk_Key(&ctx, &trace.samples[first], count, &state);
+        Render_Chunk chunk;
+
+        if (ctx.cache_dir != NULL && Render_Cache_Load(ctx.cache_dir, key, samples, iq, &chunk) == 0)
+        {
+            hits++;
+        }
+        else
+        {
+            memset(&chunk, 0, sizeof(chunk));
+            chunk.magic = RENDER_CACHE_MAGIC;
+            chunk.version = RENDER_CACHE_VERSION;
+            chunk.key = key;
+            Render_Chunk_Run(&ctx, &trace.samples[first], count, &state, iq, &chunk);
+            if (ctx.cache_dir != NULL) Render_Cache_Store(ctx.cache_dir, key, iq, &chunk);
+            misses++;
+        }
+
+        Render_Stitch(iq, chunk.samples, phase, pcm);
+
+        // Crop to the window
+        size_t skip = first < window_first ? window_first - first : 0;
+        size_t keep = (first + count > window_end ? window_end - first : count) - skip;
+        if (Wav_Write(&wav, pcm + skip * ctx.samples_per_reading, keep * ctx.samples_per_reading) != 0)
+        {
+            fprintf(stderr, "render: cannot write %s\n", out_path);
+            return 1;
+        }
+        phase += chunk.phase_advance;
+        state = chunk.exit;
+    }
+
+    if (Wav_Close(&wav) != 0)
+    {
+        fprintf(stderr, "render: cannot write %s\n", out_path);
+        return 1;
+    }
+
+    fprintf(stderr, "render: %zu chunks (%zu cached, %zu rendered), %.1f s audio in %.0f ms\n",
+            hits + misses, hits, misses, (double)wav.samples / ctx.sample_rate, Render_Now_Ms() - start);
+
+    free(iq);
+    free(pcm);
+    Trace_Free(&trace);
+    return 0;
+}
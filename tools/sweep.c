@@ -0,0 +1,301 @@
+/**
+ * @file sweep.c
+ * @brief Parallel design-space sweep of the control pipeline over a trace
+ * @description Runs Pipeline_Step() over a recorded ADC trace for every
+ *              combination of frequency range, dead-band, filter cut-off and
+ *              glide time, and writes one CSV row of metrics per combination.
+ *
+ * Build:
+ *   gcc -O2 -pthread -I. tools/sweep.c tools/trace.c pipeline.c -lm -o sweep
+ *
+ * Usage:
+ *   sweep -t trace.txt [-r 10] [-j threads] [-o results.csv]
+ *         [--min 200,100] [--max 2000,4000] [--deadband 0,5,10]
+ *         [--cutoff 0,0.5,1] [--glide 0,200,500]
+ *
+ * The trace is loaded once and shared read-only by all worker threads; each
+ * job only owns a Pipeline_State, so memory stays flat as threads are added.
+ *
+ * Metrics (ideal pitch = unfiltered Pipeline_Map() of the raw reading):
+ *   retunes       number of output retunes (timer reprogramming)
+ *   latency_ms    mean time the output stays further than dead-band + 1 %
+ *                 from the ideal pitch once it leaves that band
+ *   err_hz        mean absolute tracking error against the ideal pitch
+ *   zipper_cents  RMS retune step in cents (audible stepping / splatter)
+ *   ns_per_sample host time per Pipeline_Step() call
+ */
+
+#include "../pipeline.h"
+#include "trace.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SWEEP_MAX_VALUES       32
+#define SWEEP_MAX_THREADS      256
+
+typedef struct {
+    float values[SWEEP_MAX_VALUES];
+    int count;
+} Sweep_Axis;
+
+typedef struct {
+    uint32_t min_freq;
+    uint32_t max_freq;
+    uint32_t deadband_hz;
+    float cutoff_hz;
+    float glide_ms;
+} Sweep_Point;
+
+typedef struct {
+    uint64_t retunes;
+    double latency_ms;
+    double err_hz;
+    double zipper_cents;
+    double ns_per_sample;
+} Sweep_Result;
+
+typedef struct {
+    const Trace *trace;         // Shared, read-only
+    const Sweep_Point *points;
+    Sweep_Result *results;
+    size_t count;
+    atomic_size_t next;         // Next job index
+} Sweep_Jobs;
+
+/**
+ * @brief Parse a comma separated list of numbers into an axis
+ * @return 0 on success, -1 on error
+ */
+static int Sweep_Parse_Axis(Sweep_Axis *axis, const char *list)
+{
+    char *end;
+    axis->count = 0;
+
+    while (*list != '\0' && axis->count < SWEEP_MAX_VALUES)
+    {
+        axis->values[axis->count++] = strtof(list, &end);
+        if (end == list) return -1;
+        list = (*end == ',') ? end + 1 : end;
+    }
+
+    return axis->count > 0 ? 0 : -1;
+}
+
+/**
+ * @brief Monotonic time in nanoseconds
+ */
+static double Sweep_Now_Ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Run the pipeline over the trace for one configuration
+ */
+static void Sweep_Evaluate(const Trace *trace, const Sweep_Point *point, Sweep_Result *result)
+{
+    float step_ms = 1000.0f / trace->rate_hz;
+    Pipeline_Config cfg = PIPELINE_CONFIG_DEFAULT;
+    Pipeline_State state;
+
+    cfg.min_freq = point->min_freq;
+    cfg.max_freq = point->max_freq;
+    cfg.deadband_hz = point->deadband_hz;
+    cfg.filter_alpha = Pipeline_Alpha_From_Cutoff(point->cutoff_hz, trace->rate_hz);
+    cfg.glide_alpha = Pipeline_Alpha_From_Time(point->glide_ms, step_ms);
+
+    // Timed pass: pipeline only
+    Pipeline_Init(&state, &cfg, Pipeline_Map(&cfg, trace->samples[0]));
+    double start = Sweep_Now_Ns();
+    for (size_t i = 0; i < trace->count; i++)
+    {
+        Pipeline_Step(&state, &cfg, trace->samples[i]);
+    }
+    result->ns_per_sample = (Sweep_Now_Ns() - start) / (double)trace->count;
+
+    // Metrics pass
+    uint64_t excursions = 0, excursion_steps = 0;
+    double err_sum = 0.0, zipper_sum = 0.0;
+    int outside = 0;
+
+    result->retunes = 0;
+    Pipeline_Init(&state, &cfg, Pipeline_Map(&cfg, trace->samples[0]));
+    for (size_t i = 0; i < trace->count; i++)
+    {
+        uint32_t previous = state.frequency;
+        if (Pipeline_Step(&state, &cfg, trace->samples[i]))
+        {
+            double cents = 1200.0 * log2((double)state.frequency / (double)previous);
+            zipper_sum += cents * cents;
+            result->retunes++;
+        }
+
+        double ideal = (double)Pipeline_Map(&cfg, trace->samples[i]);
+        double error = fabs((double)state.frequency - ideal);
+        err_sum += error;
+
+        if (error > (double)cfg.deadband_hz + ideal * 0.01)
+        {
+            if (!outside) excursions++;
+            excursion_steps++;
+            outside = 1;
+        }
+        else
+        {
+            outside = 0;
+        }
+    }
+
+    result->err_hz = err_sum / (double)trace->count;
+    result->latency_ms = excursions ? (double)excursion_steps * step_ms / (double)excursions : 0.0;
+    result->zipper_cents = result->retunes ? sqrt(zipper_sum / (double)result->retunes) : 0.0;
+}
+
+/**
+ * @brief Worker thread: pull jobs until the grid is exhausted
+ */
+static void *Sweep_Worker(void *arg)
+{
+    Sweep_Jobs *jobs = (Sweep_Jobs *)arg;
+
+    for (;;)
+    {
+        size_t index = atomic_fetch_add(&jobs->next, 1);
+        if (index >= jobs->count) break;
+        Sweep_Evaluate(jobs->trace, &jobs->points[index], &jobs->results[index]);
+    }
+
+    return NULL;
+}
+
+static void Sweep_Usage(void)
+{
+    fprintf(stderr,
+            "usage: sweep -t trace [-r rate_hz] [-j threads] [-o out.csv]\n"
+            "             [--min list] [--max list] [--deadband list]\n"
+            "             [--cutoff list] [--glide list]\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *trace_path = NULL, *out_path = NULL;
+    float rate_hz = 10.0f;  // One reading per 100 ms main loop
+    int threads = 4;
+    Sweep_Axis min_axis = { { 200 }, 1 }, max_axis = { { 2000 }, 1 };
+    Sweep_Axis deadband_axis = { { 5 }, 1 }, cutoff_axis = { { 0 }, 1 }, glide_axis = { { 0 }, 1 };
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int bad = (val == NULL);
+
+        if (!bad && strcmp(opt, "-t") == 0) trace_path = val;
+        else if (!bad && strcmp(opt, "-o") == 0) out_path = val;
+        else if (!bad && strcmp(opt, "-r") == 0) rate_hz = strtof(val, NULL);
+        else if (!bad && strcmp(opt, "-j") == 0) threads = atoi(val);
+        else if (!bad && strcmp(opt, "--min") == 0) bad = Sweep_Parse_Axis(&min_axis, val);
+        else if (!bad && strcmp(opt, "--max") == 0) bad = Sweep_Parse_Axis(&max_axis, val);
+        else if (!bad && strcmp(opt, "--deadband") == 0) bad = Sweep_Parse_Axis(&deadband_axis, val);
+        else if (!bad && strcmp(opt, "--cutoff") == 0) bad = Sweep_Parse_Axis(&cutoff_axis, val);
+        else if (!bad && strcmp(opt, "--glide") == 0) bad = Sweep_Parse_Axis(&glide_axis, val);
+        else bad = 1;
+
+        if (bad)
+        {
+            Sweep_Usage();
+            return 2;
+        }
+        i++;
+    }
+
+    if (trace_path == NULL || rate_hz <= 0.0f)
+    {
+        Sweep_Usage();
+        return 2;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > SWEEP_MAX_THREADS) threads = SWEEP_MAX_THREADS;
+
+    Trace trace;
+    if (Trace_Load(&trace, trace_path, rate_hz) != 0 || trace.count == 0)
+    {
+        fprintf(stderr, "sweep: cannot read trace %s\n", trace_path);
+        return 1;
+    }
+
+    // Expand the grid
+    size_t count = (size_t)min_axis.count * max_axis.count * deadband_axis.count *
+                   cutoff_axis.count * glide_axis.count;
+    Sweep_Point *points = (Sweep_Point *)calloc(count, sizeof(Sweep_Point));
+    Sweep_Result *results = (Sweep_Result *)calloc(count, sizeof(Sweep_Result));
+    if (points == NULL || results == NULL)
+    {
+        fprintf(stderr, "sweep: out of memory\n");
+        return 1;
+    }
+
+    size_t n = 0;
+    for (int a = 0; a < min_axis.count; a++)
+    for (int b = 0; b < max_axis.count; b++)
+    for (int c = 0; c < deadband_axis.count; c++)
+    for (int d = 0; d < cutoff_axis.count; d++)
+    for (int e = 0; e < glide_axis.count; e++)
+    {
+        points[n].min_freq = (uint32_t)min_axis.values[a];
+        points[n].max_freq = (uint32_t)max_axis.values[b];
+        points[n].deadband_hz = (uint32_t)deadband_axis.values[c];
+        points[n].cutoff_hz = cutoff_axis.values[d];
+        points[n].glide_ms = glide_axis.values[e];
+        n++;
+    }
+
+    // Run the grid in parallel
+    Sweep_Jobs jobs;
+    jobs.trace = &trace;
+    jobs.points = points;
+    jobs.results = results;
+    jobs.count = count;
+    atomic_init(&jobs.next, 0);
+
+    pthread_t workers[SWEEP_MAX_THREADS];
+    for (int t = 0; t < threads; t++)
+    {
+        pthread_create(&workers[t], NULL, Sweep_Worker, &jobs);
+    }
+    for (int t = 0; t < threads; t++)
+    {
+        pthread_join(workers[t], NULL);
+    }
+
+    // Results table
+    FILE *out = (out_path != NULL) ? fopen(out_path, "w") : stdout;
+    if (out == NULL)
+    {
+        fprintf(stderr, "sweep: cannot write %s\n", out_path);
+        return 1;
+    }
+
+    fprintf(out, "min_hz,max_hz,deadband_hz,cutoff_hz,glide_ms,retunes,latency_ms,err_hz,zipper_cents,ns_per_sample\n");
+    for (size_t i = 0; i < count; i++)
+    {
+        fprintf(out, "%u,%u,%u,%g,%g,%llu,%.1f,%.2f,%.2f,%.2f\n",
+                points[i].min_freq, points[i].max_freq, points[i].deadband_hz,
+                points[i].cutoff_hz, points[i].glide_ms,
+                (unsigned long long)results[i].retunes, results[i].latency_ms,
+                results[i].err_hz, results[i].zipper_cents, results[i].ns_per_sample);
+    }
+
+    if (out != stdout) fclose(out);
+    free(points);
+    free(results);
+    Trace_Free(&trace);
+    return 0;
+}
@@ -0,0 +1,253 @@
+/**
+ * @file thermal.c
+ * @brief Physical thermal-model trace generator for the host tools
+ */
+
+#include "thermal.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define THERMAL_STATES         2   // [sensor, heater]
+#define THERMAL_INPUTS         2   // [ambient C, heater W]
+#define THERMAL_AUG            (THERMAL_STATES + THERMAL_INPUTS)
+
+typedef double Thermal_Mat[THERMAL_AUG][THERMAL_AUG];
+
+// Per-offset response tables: sample k of a block is
+// p0[k] x0 + p1[k] x1 + q0[k] u0 + q1[k] u1
+typedef struct {
+    float p0[THERMAL_BLOCK], p1[THERMAL_BLOCK];
+    float q0[THERMAL_BLOCK], q1[THERMAL_BLOCK];
+    double a[THERMAL_BLOCK + 1][THERMAL_STATES][THERMAL_STATES];   // A^k
+    double s[THERMAL_BLOCK + 1][THERMAL_STATES][THERMAL_INPUTS];   // sum_{j<k} A^j B
+} Thermal_Tables;
+
+static void Thermal_Mat_Mul(Thermal_Mat out, Thermal_Mat a, Thermal_Mat b)
+{
+    Thermal_Mat r;
+    for (int i = 0; i < THERMAL_AUG; i++)
+    for (int j = 0; j < THERMAL_AUG; j++)
+    {
+        double acc = 0.0;
+        for (int k = 0; k < THERMAL_AUG; k++) acc += a[i][k] * b[k][j];
+        r[i][j] = acc;
+    }
+    memcpy(out, r, sizeof(r));
+}
+
+/**
+ * @brief Matrix exponential (scaling and squaring, Taylor series)
+ */
+static void Thermal_Expm(Thermal_Mat out, Thermal_Mat m)
+{
+    Thermal_Mat scaled, term;
+    double norm = 0.0;
+    int squarings = 0;
+
+    for (int i = 0; i < THERMAL_AUG; i++)
+    for (int j = 0; j < THERMAL_AUG; j++) norm = fmax(norm, fabs(m[i][j]));
+    while (norm > 0.5)
+    {
+        norm *= 0.5;
+        squarings++;
+    }
+
+    double scale = ldexp(1.0, -squarings);
+    for (int i = 0; i < THERMAL_AUG; i++)
+    for (int j = 0; j < THERMAL_AUG; j++)
+    {
+        scaled[i][j] = m[i][j] * scale;
+        out[i][j] = (i == j) ? 1.0 : 0.0;
+        term[i][j] = out[i][j];
+    }
+    for (int n = 1; n <= 16; n++)
+    {
+        Thermal_Mat_Mul(term, term, scaled);
+        for (int i = 0; i < THERMAL_AUG; i++)
+        for (int j = 0; j < THERMAL_AUG; j++)
+        {
+            term[i][j] /= n;
+            out[i][j] += term[i][j];
+        }
+    }
+    while (squarings-- > 0) Thermal_Mat_Mul(out, out, out);
+}
+
+/**
+ * @brief Exact discretization and per-offset response tables
+ */
+static void Thermal_Build(const Thermal_Model *model, float rate_hz, Thermal_Tables *tables)
+{
+    Thermal_Mat m, e;
+    double dt = 1.0 / rate_hz;
+    double cs = model->sensor_capacity, rsa = model->sensor_to_ambient;
+
+    // Continuous model dx/dt = Ac x + Bc u, augmented as [[Ac Bc] [0 0]] * dt
+    memset(m, 0, sizeof(m));
+    m[0][0] = -1.0 / (rsa * cs);
+    m[0][2] = 1.0 / (rsa * cs);
+    if (model->order == 2)
+    {
+        double ch = model->heater_capacity, rhs = model->heater_to_sensor;
+        m[0][0] -= 1.0 / (rhs * cs);
+        m[0][1] = 1.0 / (rhs * cs);
+        m[1][0] = 1.0 / (rhs * ch);
+        m[1][1] = -1.0 / (rhs * ch);
+        m[1][3] = 1.0 / ch;
+    }
+    else
+    {
+        m[0][3] = 1.0 / cs;     // Heater warms the sensor mass directly
+    }
+    for (int i = 0; i < THERMAL_AUG; i++)
+    for (int j = 0; j < THERMAL_AUG; j++) m[i][j] *= dt;
+
+    // exp = [[A Bd] [0 I]]
+    Thermal_Expm(e, m);
+
+    memset(tables->a[0], 0, sizeof(tables->a[0]));
+    memset(tables->s[0], 0, sizeof(tables->s[0]));
+    tables->a[0][0][0] = tables->a[0][1][1] = 1.0;
+    for (int k = 0; k < THERMAL_BLOCK; k++)
+    {
+        // A^(k+1) = A A^k, S(k+1) = S(k) + A^k Bd
+        for (int i = 0; i < THERMAL_STATES; i++)
+        {
+            for (int j = 0; j < THERMAL_STATES; j++)
+            {
+                double acc = 0.0;
+                for (int l = 0; l < THERMAL_STATES; l++) acc += e[i][l] * tables->a[k][l][j];
+                tables->a[k + 1][i][j] = acc;
+            }
+            for (int j = 0; j < THERMAL_INPUTS; j++)
+            {
+                double acc = tables->s[k][i][j];
+                for (int l = 0; l < THERMAL_STATES; l++) acc += tables->a[k][i][l] * e[l][THERMAL_STATES + j];
+                tables->s[k + 1][i][j] = acc;
+            }
+        }
+
+        // Output is the sensor temperature (state 0)
+        tables->p0[k] = (float)tables->a[k][0][0];
+        tables->p1[k] = (float)tables->a[k][0][1];
+        tables->q0[k] = (float)tables->s[k][0][0];
+        tables->q1[k] = (float)tables->s[k][0][1];
+    }
+}
+
+/**
+ * @brief Heater power at time t and the time of its next switching edge
+ */
+static double Thermal_Heater(const Thermal_Model *model, double t, double *next_edge)
+{
+    double off = model->heater_off_s;
+    double on = 0.0;
+
+    *next_edge = INFINITY;
+    if (off >= 0.0 && t >= off) return 0.0;
+    if (t < model->heater_on_s)
+    {
+        *next_edge = model->heater_on_s;
+    }
+    else if (model->heater_period_s <= 0.0)
+    {
+        on = model->heater_w;
+        *next_edge = off;
+    }
+    else
+    {
+        double period = model->heater_period_s;
+        double cycle_start = model->heater_on_s + floor((t - model->heater_on_s) / period) * period;
+        double on_end = cycle_start + model->heater_duty * period;
+
+        if (t < on_end)
+        {
+            on = model->heater_w;
+            *next_edge = on_end;
+        }
+        else
+        {
+            *next_edge = cycle_start + period;
+        }
+    }
+    if (off >= 0.0 && off < *next_edge) *next_edge = off;
+    return on;
+}
+
+/**
+ * @brief Generate an ADC trace
+ * @param model: Thermal model and sensor chain
+ * @param rate_hz: Samples per second
+ * @param out: ADC counts (0-4095)
+ * @param count: Number of samples
+ * @return 0 on success, -1 on an invalid model or out of memory
+ */
+int Thermal_Generate(const Thermal_Model *model, float rate_hz, uint16_t *out, size_t count)
+{
+    Thermal_Tables *tables;
+    double x0 = model->initial_c, x1 = model->initial_c;
+
+    if ((model->order != 1 && model->order != 2) || rate_hz <= 0.0f ||
+        model->sensor_capacity <= 0.0 || model->sensor_to_ambient <= 0.0 ||
+        (model->order == 2 && (model->heater_capacity <= 0.0 || model->heater_to_sensor <= 0.0)))
+    {
+        return -1;
+    }
+
+    // Per call, so concurrent generators with different models do not share tables
+    tables = (Thermal_Tables *)malloc(sizeof(Thermal_Tables));
+    if (tables == NULL) return -1;
+    Thermal_Build(model, rate_hz, tables);
+
+    // Sum of the four bytes of a hash: near-Gaussian, mean 510, RMS 147.8
+    const float noise_scale = (float)(model->noise_rms / 147.8);
+    const float gain = (float)model->adc_per_c;
+    const float offset = (float)model->adc_offset + 0.5f - 510.0f * noise_scale;
+    const uint32_t seed = model->seed * 0x9E3779B9UL;
+
+    size_t n = 0;
+    while (n < count)
+    {
+        double t = (double)n / rate_hz;
+        double next_edge;
+        double u1 = Thermal_Heater(model, t, &next_edge);
+        double u0 = model->ambient_c + model->ambient_drift * t / 3600.0 +
+                    model->ambient_daily * sin(t * (6.283185307179586 / 86400.0));
+
+        // Block: up to THERMAL_BLOCK samples, ending at the next heater edge
+        size_t m = count - n < THERMAL_BLOCK ? count - n : THERMAL_BLOCK;
+        double edge_samples = ceil((next_edge - t) * rate_hz);
+        if (edge_samples >= 1.0 && edge_samples < (double)m) m = (size_t)edge_samples;
+
+        const float fx0 = (float)x0, fx1 = (float)x1, fu0 = (float)u0, fu1 = (float)u1;
+        uint16_t *dst = out + n;
+        for (size_t k = 0; k < m; k++)
+        {
+            float temp = tables->p0[k] * fx0 + tables->p1[k] * fx1 + tables->q0[k] * fu0 + tables->q1[k] * fu1;
+
+            // Counter-based noise (murmur3 finalizer of the sample index)
+            uint32_t h = ((uint32_t)(n + k)) ^ seed;
+            h ^= h >> 16;
+            h *= 0x85EBCA6BUL;
+            h ^= h >> 13;
+            h *= 0xC2B2AE35UL;
+            h ^= h >> 16;
+            uint32_t bytes = (h & 0xFF) + ((h >> 8) & 0xFF) + ((h >> 16) & 0xFF) + (h >> 24);
+
+            // Quantize to 12 bits
+            float adc = temp * gain + offset + (float)bytes * noise_scale;
+            adc = adc < 0.0f ? 0.0f : (adc > 4095.0f ? 4095.0f : adc);
+            dst[k] = (uint16_t)adc;
+        }
+
+        // Advance the state to the end of the block
+        double nx0 = tables->a[m][0][0] * x0 + tables->a[m][0][1] * x1 + tables->s[m][0][0] * u0 + tables->s[m][0][1] * u1;
+        double nx1 = tables->a[m][1][0] * x0 + tables->a[m][1][1] * x1 + tables->s[m][1][0] * u0 + tables->s[m][1][1] * u1;
+        x0 = nx0;
+        x1 = nx1;
+        n += m;
+    }
+    free(tables);
+    return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file thermal.h
+ * @brief Physical thermal-model trace generator for the host tools
+ * @description Produces realistic ADC traces from a lumped RC thermal model:
+ *              a sensor mass coupled to ambient (first order), optionally fed
+ *              through a heater mass (second order), with a heater power
+ *              schedule, ambient drift, ADC noise and 12-bit quantization.
+ *
+ * The model is discretized exactly (matrix exponential) once. Inputs
+ * (ambient, heater power) are held over blocks of up to THERMAL_BLOCK
+ * samples, split at every heater switching edge, so within a block each
+ * output sample is a fixed linear combination of the block-start state and
+ * inputs. Samples therefore do not depend on each other and the inner loop
+ * vectorizes; noise comes from a counter-based hash of the sample index, so
+ * the output is the same for any blocking.
+ *
+ * The response tables (about 20 KB) are allocated per Thermal_Generate()
+ * call, so several threads may generate traces with different models at
+ * once.
+ */
+
+#ifndef THERMAL_H
+#define THERMAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define THERMAL_BLOCK          256
+
+typedef struct {
+    int order;                  // 1: sensor mass only, 2: heater mass -> sensor mass
+    double sensor_capacity;     // Sensor thermal mass (J/K)
+    double sensor_to_ambient;   // Sensor to ambient resistance (K/W)
+    double heater_capacity;     // Heater thermal mass (J/K), order 2
+    double heater_to_sensor;    // Heater to sensor resistance (K/W), order 2
+    double initial_c;           // Temperature of every mass at t = 0 (C)
+
+    double ambient_c;           // Ambient at t = 0 (C)
+    double ambient_drift;       // Linear ambient drift (C per hour)
+    double ambient_daily;       // Daily ambient swing amplitude (C)
+
+    double heater_w;            // Heater power while on (W); order 1 heats the sensor mass
+    double heater_on_s;         // First switch-on time (s)
+    double heater_off_s;        // Final switch-off time (s), < 0 = never
+    double heater_period_s;     // Thermostat cycle period (s), 0 = single step
+    double heater_duty;         // On fraction of each cycle (0-1)
+
+    double adc_per_c;           // ADC counts per C
+    double adc_offset;          // ADC count at 0 C
+    double noise_rms;           // ADC noise (counts RMS)
+    uint32_t seed;              // Noise seed
+} Thermal_Model;
+
+// 0-100 C over the ADC range, 60 s sensor, 20 W heater stepping on at 60 s
+// behind a 300 s heater block, 0.5 count noise
+#define THERMAL_MODEL_DEFAULT { 2, 30.0, 2.0, 150.0, 2.0, 25.0, \
+                                25.0, 0.0, 0.0, \
+                                20.0, 60.0, -1.0, 0.0, 1.0, \
+                                40.95, 0.0, 0.5, 1 }
+
+int Thermal_Generate(const Thermal_Model *model, float rate_hz, uint16_t *out, size_t count);
+
+#endif /* THERMAL_H */
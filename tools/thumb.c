@@ -0,0 +1,1802 @@
+/**
+ * @file thumb.c
+ * @brief Cortex-M4 (ARMv7E-M Thumb-2) instruction-set emulator with a cycle
+ *        model, for the host tools
+ */
+
+#include "thumb.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define THUMB_N                (1UL << 31)
+#define THUMB_Z                (1UL << 30)
+#define THUMB_C                (1UL << 29)
+#define THUMB_V                (1UL << 28)
+#define THUMB_Q                (1UL << 27)
+#define THUMB_GE_SHIFT         16
+#define THUMB_REFILL           2            // P: pipeline refill after a taken branch
+#define THUMB_NO_LINE          0xFFFFFFFFUL
+
+// Shift types (DecodeImmShift)
+#define THUMB_LSL              0
+#define THUMB_LSR              1
+#define THUMB_ASR              2
+#define THUMB_ROR              3
+#define THUMB_RRX              4
+
+typedef struct {
+    Thumb_Cpu *cpu;
+    uint32_t pc;            // Address of the instruction
+    uint32_t next;          // Address of the next instruction
+    uint32_t cost;          // Cycles, before flash stalls
+    int in_it;              // Inside an IT block (16-bit forms do not set flags)
+    int ldst;               // Single load/store (pipelines with the next one)
+    int status;
+} Thumb_Exec;
+
+static uint32_t Thumb_U16(const uint8_t *p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8); }
+static uint32_t Thumb_U32(const uint8_t *p) { return Thumb_U16(p) | (Thumb_U16(p + 2) << 16); }
+
+static int Thumb_Fault(Thumb_Cpu *cpu, const char *fmt, ...)
+{
+    if (cpu->fault[0] == 0)
+    {
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(cpu->fault, sizeof(cpu->fault), fmt, args);
+        va_end(args);
+    }
+    return THUMB_FAULT;
+}
+
+/**
+ * @brief Allocate memory and reset the core
+ * @param io: Peripheral / system-space hooks
+ * @return 0 on success, -1 if out of memory
+ */
+int Thumb_Init(Thumb_Cpu *cpu, const Thumb_Io *io)
+{
+    memset(cpu, 0, sizeof(*cpu));
+    cpu->flash = (uint8_t *)malloc(THUMB_FLASH_SIZE);
+    cpu->ccm = (uint8_t *)calloc(1, THUMB_CCM_SIZE);
+    cpu->sram = (uint8_t *)calloc(1, THUMB_SRAM_SIZE);
+    if (cpu->flash == NULL || cpu->ccm == NULL || cpu->sram == NULL)
+    {
+        Thumb_Free(cpu);
+        return -1;
+    }
+    memset(cpu->flash, 0xFF, THUMB_FLASH_SIZE);  // Erased flash
+    cpu->io = *io;
+    cpu->fetch_line = THUMB_NO_LINE;
+    return 0;
+}
+
+/**
+ * @brief Release emulator memory
+ */
+void Thumb_Free(Thumb_Cpu *cpu)
+{
+    free(cpu->flash);
+    free(cpu->ccm);
+    free(cpu->sram);
+    cpu->flash = cpu->ccm = cpu->sram = NULL;
+}
+
+/**
+ * @brief Host pointer to emulated memory
+ * @return Pointer to `size` bytes at `addr`, or NULL if the range is not
+ *         entirely inside flash, CCM or SRAM
+ */
+uint8_t *Thumb_Memory(Thumb_Cpu *cpu, uint32_t addr, uint32_t size)
+{
+    if (addr < THUMB_FLASH_SIZE && size <= THUMB_FLASH_SIZE - addr) return cpu->flash + addr;  // Boot alias
+    if (addr - THUMB_FLASH_BASE < THUMB_FLASH_SIZE && size <= THUMB_FLASH_SIZE - (addr - THUMB_FLASH_BASE))
+    {
+        return cpu->flash + (addr - THUMB_FLASH_BASE);
+    }
+    if (addr - THUMB_SRAM_BASE < THUMB_SRAM_SIZE && size <= THUMB_SRAM_SIZE - (addr - THUMB_SRAM_BASE))
+    {
+        return cpu->sram + (addr - THUMB_SRAM_BASE);
+    }
+    if (addr - THUMB_CCM_BASE < THUMB_CCM_SIZE && size <= THUMB_CCM_SIZE - (addr - THUMB_CCM_BASE))
+    {
+        return cpu->ccm + (addr - THUMB_CCM_BASE);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Offset into flash, or -1 if `addr` is not a flash address
+ */
+static int64_t Thumb_Flash_Offset(uint32_t addr)
+{
+    if (addr < THUMB_FLASH_SIZE) return addr;
+    if (addr - THUMB_FLASH_BASE < THUMB_FLASH_SIZE) return addr - THUMB_FLASH_BASE;
+    return -1;
+}
+
+/**
+ * @brief Look up a line in an LRU cache, inserting it on a miss
+ * @return 1 on a hit
+ */
+static int Thumb_Cache(uint32_t *tags, uint64_t *used, int lines, uint32_t line, uint64_t now)
+{
+    int victim = 0;
+
+    for (int i = 0; i < lines; i++)
+    {
+        if (tags[i] == line + 1)
+        {
+            used[i] = now;
+            return 1;
+        }
+        if (used[i] < used[victim]) victim = i;
+    }
+    tags[victim] = line + 1;
+    used[victim] = now;
+    return 0;
+}
+
+/**
+ * @brief Instruction fetch through the flash interface
+ */
+static void Thumb_Fetch(Thumb_Cpu *cpu, uint32_t addr)
+{
+    int64_t offset = Thumb_Flash_Offset(addr);
+    const Thumb_Flash_Config *cfg = &cpu->flash_cfg;
+
+    if (offset < 0 || cfg->wait_states <= 0) return;
+
+    uint32_t line = (uint32_t)(offset / THUMB_FLASH_LINE);
+    if (line == cpu->fetch_line) return;
+
+    uint64_t stall = (uint64_t)cfg->wait_states;
+    if (cfg->icache && Thumb_Cache(cpu->icache_tag, cpu->icache_used, THUMB_ICACHE_LINES, line, cpu->cycles))
+    {
+        stall = 0;
+    }
+    else if (cfg->prefetch && line == cpu->fetch_line + 1)
+    {
+        stall = cpu->fetch_ready > cpu->cycles ? cpu->fetch_ready - cpu->cycles : 0;
+    }
+
+    cpu->cycles += stall;
+    cpu->flash_stalls += stall;
+    cpu->fetch_line = line;
+    cpu->fetch_ready = cpu->cycles + (uint64_t)cfg->wait_states;   // Next line streams in meanwhile
+}
+
+/**
+ * @brief Data read latency from flash (literal pools, const tables)
+ */
+static void Thumb_Flash_Data(Thumb_Cpu *cpu, int64_t offset)
+{
+    const Thumb_Flash_Config *cfg = &cpu->flash_cfg;
+    uint32_t line = (uint32_t)(offset / THUMB_FLASH_LINE);
+
+    if (cfg->wait_states <= 0) return;
+    if (cfg->dcache && Thumb_Cache(cpu->dcache_tag, cpu->dcache_used, THUMB_DCACHE_LINES, line, cpu->cycles)) return;
+    cpu->cycles += (uint64_t)cfg->wait_states;
+    cpu->flash_stalls += (uint64_t)cfg->wait_states;
+}
+
+static uint32_t Thumb_Read(Thumb_Cpu *cpu, uint32_t addr, int size)
+{
+    uint8_t *p = Thumb_Memory(cpu, addr, (uint32_t)size);
+
+    if (p != NULL)
+    {
+        int64_t offset = Thumb_Flash_Offset(addr);
+        if (offset >= 0) Thumb_Flash_Data(cpu, offset);
+        if (size == 1) return p[0];
+        if (size == 2) return Thumb_U16(p);
+        return Thumb_U32(p);
+    }
+    if (addr >= 0x40000000UL && addr < 0x60000000UL) return cpu->io.read(cpu->io.ctx, addr, size);
+    if (addr >= 0xE0000000UL) return cpu->io.read(cpu->io.ctx, addr, size);
+    Thumb_Fault(cpu, "read of unmapped address 0x%08X at pc 0x%08X", addr, cpu->r[15]);
+    return 0;
+}
+
+static void Thumb_Write(Thumb_Cpu *cpu, uint32_t addr, uint32_t value, int size)
+{
+    uint8_t *p = Thumb_Memory(cpu, addr, (uint32_t)size);
+
+    if (p != NULL && Thumb_Flash_Offset(addr) < 0)
+    {
+        for (int i = 0; i < size; i++) p[i] = (uint8_t)(value >> (8 * i));
+        return;
+    }
+    if (p != NULL)
+    {
+        Thumb_Fault(cpu, "write to flash 0x%08X at pc 0x%08X", addr, cpu->r[15]);
+        return;
+    }
+    if ((addr >= 0x40000000UL && addr < 0x60000000UL) || addr >= 0xE0000000UL)
+    {
+        cpu->io.write(cpu->io.ctx, addr, value, size);
+        return;
+    }
+    Thumb_Fault(cpu, "write to unmapped address 0x%08X at pc 0x%08X", addr, cpu->r[15]);
+}
+
+/**
+ * @brief Reset from the vector table (initial SP at word 0, reset handler at word 1)
+ * @return 0 on success, -1 if the vector table is not plausible
+ */
+int Thumb_Reset(Thumb_Cpu *cpu)
+{
+    uint32_t sp = Thumb_U32(cpu->flash), reset = Thumb_U32(cpu->flash + 4);
+
+    memset(cpu->r, 0, sizeof(cpu->r));
+    memset(cpu->s, 0, sizeof(cpu->s));
+    cpu->apsr = 0;
+    cpu->fpscr = 0;
+    cpu->it = 0;
+    cpu->primask = 0;
+    cpu->handler = 0;
+    cpu->fetch_line = THUMB_NO_LINE;
+
+    if (!(reset & 1) || Thumb_Memory(cpu, reset & ~1UL, 2) == NULL || Thumb_Memory(cpu, sp - 4, 4) == NULL) return -1;
+    cpu->r[13] = sp & ~3UL;
+    cpu->r[14] = 0xFFFFFFFFUL;
+    cpu->r[15] = reset & ~1UL;
+    return 0;
+}
+
+/**
+ * @brief Set up a call: function(arg0) returning to THUMB_RETURN_MAGIC
+ * @note The stack pointer is left as it is.
+ */
+void Thumb_Call(Thumb_Cpu *cpu, uint32_t function, uint32_t arg0)
+{
+    cpu->r[0] = arg0;
+    cpu->r[14] = THUMB_RETURN_MAGIC;
+    cpu->r[15] = function & ~1UL;
+    cpu->it = 0;
+}
+
+/**
+ * @brief Take an interrupt: stack the basic frame and enter `handler`
+ * @return 1 if taken, 0 if masked (PRIMASK) or nested too deep, -1 on a
+ *         stacking fault
+ */
+int Thumb_Interrupt(Thumb_Cpu *cpu, uint32_t handler)
+{
+    if (cpu->primask || cpu->handler >= THUMB_MAX_NESTING) return 0;
+
+    uint32_t sp = cpu->r[13];
+    uint32_t xpsr = (cpu->apsr & 0xF80F0000UL) | (1UL << 24) |
+                    ((uint32_t)(cpu->it & 0xFC) << 8) | ((uint32_t)(cpu->it & 0x03) << 25);
+    if (sp & 4)
+    {
+        sp -= 4;
+        xpsr |= 1UL << 9;   // Stack realigned to 8 bytes
+    }
+    sp -= 32;
+
+    const uint32_t frame[8] = { cpu->r[0], cpu->r[1], cpu->r[2], cpu->r[3], cpu->r[12], cpu->r[14], cpu->r[15], xpsr };
+    for (int i = 0; i < 8; i++) Thumb_Write(cpu, sp + 4 * (uint32_t)i, frame[i], 4);
+    if (cpu->fault[0] != 0) return -1;
+
+    // S0-S15 and FPSCR are kept aside rather than stacked (lazy stacking hides the cost)
+    memcpy(cpu->fp_stack[cpu->handler].s, cpu->s, sizeof(cpu->fp_stack[0].s));
+    cpu->fp_stack[cpu->handler].fpscr = cpu->fpscr;
+
+    cpu->handler++;
+    cpu->r[13] = sp;
+    cpu->r[14] = THUMB_EXC_RETURN;
+    cpu->r[15] = handler & ~1UL;
+    cpu->it = 0;
+    cpu->cycles += 12;
+    cpu->fetch_line = THUMB_NO_LINE;
+    return 1;
+}
+
+/**
+ * @brief Exception return: unstack the frame pushed by Thumb_Interrupt()
+ */
+static int Thumb_Exception_Return(Thumb_Exec *x)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    uint32_t sp = cpu->r[13], frame[8];
+
+    if (cpu->handler == 0) return Thumb_Fault(cpu, "exception return outside a handler at pc 0x%08X", x->pc);
+    for (int i = 0; i < 8; i++) frame[i] = Thumb_Read(cpu, sp + 4 * (uint32_t)i, 4);
+    if (cpu->fault[0] != 0) return THUMB_FAULT;
+
+    cpu->handler--;
+    memcpy(cpu->s, cpu->fp_stack[cpu->handler].s, sizeof(cpu->fp_stack[0].s));
+    cpu->fpscr = cpu->fp_stack[cpu->handler].fpscr;
+
+    cpu->r[0] = frame[0];
+    cpu->r[1] = frame[1];
+    cpu->r[2] = frame[2];
+    cpu->r[3] = frame[3];
+    cpu->r[12] = frame[4];
+    cpu->r[14] = frame[5];
+    cpu->apsr = frame[7] & 0xF80F0000UL;
+    cpu->it = (uint8_t)(((frame[7] >> 8) & 0xFC) | ((frame[7] >> 25) & 0x03));
+    cpu->r[13] = sp + 32 + ((frame[7] & (1UL << 9)) ? 4 : 0);
+    x->next = frame[6] & ~1UL;
+    x->cost += 10;
+    return THUMB_OK;
+}
+
+/**
+ * @brief Write PC with interworking (BX, BLX, POP/LDM/LDR into PC)
+ */
+static int Thumb_Bx(Thumb_Exec *x, uint32_t target)
+{
+    x->cost += THUMB_REFILL;
+    if (target == THUMB_RETURN_MAGIC)
+    {
+        x->next = target;
+        return THUMB_STOPPED;
+    }
+    if ((target & 0xFFFFFF00UL) == 0xFFFFFF00UL) return Thumb_Exception_Return(x);
+    if (!(target & 1)) return Thumb_Fault(x->cpu, "branch to ARM state (0x%08X) at pc 0x%08X", target, x->pc);
+    x->next = target & ~1UL;
+    return THUMB_OK;
+}
+
+/**
+ * @brief Write PC without interworking (B, ADD/MOV to PC)
+ */
+static void Thumb_Branch(Thumb_Exec *x, uint32_t target)
+{
+    x->next = target & ~1UL;
+    x->cost += THUMB_REFILL;
+}
+
+/**
+ * @brief Register read as an operand (PC reads as the instruction address + 4)
+ */
+static uint32_t Thumb_Reg(const Thumb_Exec *x, uint32_t n)
+{
+    return n == 15 ? x->pc + 4 : x->cpu->r[n];
+}
+
+static void Thumb_Set_NZ(Thumb_Cpu *cpu, uint32_t result)
+{
+    cpu->apsr &= ~(THUMB_N | THUMB_Z);
+    cpu->apsr |= (result & THUMB_N) | (result == 0 ? THUMB_Z : 0);
+}
+
+static void Thumb_Set_NZC(Thumb_Cpu *cpu, uint32_t result, int carry)
+{
+    Thumb_Set_NZ(cpu, result);
+    cpu->apsr = (cpu->apsr & ~THUMB_C) | (carry ? THUMB_C : 0);
+}
+
+static int Thumb_Carry(const Thumb_Cpu *cpu)
+{
+    return (cpu->apsr & THUMB_C) != 0;
+}
+
+/**
+ * @brief AddWithCarry(), updating NZCV when `setflags`
+ */
+static uint32_t Thumb_Add(Thumb_Cpu *cpu, uint32_t a, uint32_t b, uint32_t carry, int setflags)
+{
+    uint64_t sum = (uint64_t)a + b + carry;
+    uint32_t result = (uint32_t)sum;
+
+    if (setflags)
+    {
+        Thumb_Set_NZC(cpu, result, (int)(sum >> 32));
+        cpu->apsr = (cpu->apsr & ~THUMB_V) | ((~(a ^ b) & (a ^ result) & 0x80000000UL) ? THUMB_V : 0);
+    }
+    return result;
+}
+
+/**
+ * @brief Shift_C(): shift with carry out (amount 0 passes value and carry through)
+ */
+static uint32_t Thumb_Shift_C(uint32_t value, int type, uint32_t amount, int carry_in, int *carry_out)
+{
+    *carry_out = carry_in;
+    if (type == THUMB_RRX)
+    {
+        *carry_out = (int)(value & 1);
+        return ((uint32_t)carry_in << 31) | (value >> 1);
+    }
+    if (amount == 0) return value;
+
+    switch (type)
+    {
+    case THUMB_LSL:
+        if (amount > 32)
+        {
+            *carry_out = 0;
+            return 0;
+        }
+        *carry_out = (int)((value >> (32 - amount)) & 1);
+        return amount == 32 ? 0 : value << amount;
+    case THUMB_LSR:
+        if (amount > 32)
+        {
+            *carry_out = 0;
+            return 0;
+        }
+        *carry_out = (int)((value >> (amount - 1)) & 1);
+        return amount == 32 ? 0 : value >> amount;
+    case THUMB_ASR:
+        if (amount >= 32)
+        {
+            *carry_out = (int)(value >> 31);
+            return (value & 0x80000000UL) ? 0xFFFFFFFFUL : 0;
+        }
+        *carry_out = (int)(((int32_t)value >> (amount - 1)) & 1);
+        return (uint32_t)((int32_t)value >> amount);
+    default:    // ROR
+        amount &= 31;
+        if (amount != 0) value = (value >> amount) | (value << (32 - amount));
+        *carry_out = (int)(value >> 31);
+        return value;
+    }
+}
+
+static uint32_t Thumb_Shift(uint32_t value, int type, uint32_t amount, int carry_in)
+{
+    int carry;
+    return Thumb_Shift_C(value, type, amount, carry_in, &carry);
+}
+
+/**
+ * @brief DecodeImmShift()
+ */
+static void Thumb_Decode_Shift(uint32_t type, uint32_t imm5, int *shift_type, uint32_t *amount)
+{
+    *shift_type = (int)type;
+    *amount = imm5;
+    if ((type == THUMB_LSR || type == THUMB_ASR) && imm5 == 0) *amount = 32;
+    if (type == THUMB_ROR && imm5 == 0)
+    {
+        *shift_type = THUMB_RRX;
+        *amount = 1;
+    }
+}
+
+/**
+ * @brief ThumbExpandImm_C()
+ */
+static uint32_t Thumb_Expand_Imm(uint32_t imm12, int carry_in, int *carry_out)
+{
+    uint32_t imm8 = imm12 & 0xFF;
+
+    *carry_out = carry_in;
+    if ((imm12 & 0xC00) == 0)
+    {
+        switch ((imm12 >> 8) & 3)
+        {
+        case 0: return imm8;
+        case 1: return imm8 | (imm8 << 16);
+        case 2: return (imm8 << 8) | (imm8 << 24);
+        default: return imm8 | (imm8 << 8) | (imm8 << 16) | (imm8 << 24);
+        }
+    }
+    uint32_t unrotated = 0x80 | (imm12 & 0x7F), amount = imm12 >> 7;
+    uint32_t value = (unrotated >> amount) | (unrotated << (32 - amount));
+    *carry_out = (int)(value >> 31);
+    return value;
+}
+
+static int Thumb_Condition(uint32_t apsr, uint32_t cond)
+{
+    int n = (apsr & THUMB_N) != 0, z = (apsr & THUMB_Z) != 0;
+    int c = (apsr & THUMB_C) != 0, v = (apsr & THUMB_V) != 0;
+    int result;
+
+    switch (cond >> 1)
+    {
+    case 0: result = z; break;
+    case 1: result = c; break;
+    case 2: result = n; break;
+    case 3: result = v; break;
+    case 4: result = c && !z; break;
+    case 5: result = n == v; break;
+    case 6: result = !z && n == v; break;
+    default: return 1;
+    }
+    return (cond & 1) ? !result : result;
+}
+
+/**
+ * @brief Signed saturation to `bits` bits, setting Q when it clips
+ */
+static int32_t Thumb_Ssat(Thumb_Cpu *cpu, int64_t value, uint32_t bits)
+{
+    int64_t max = ((int64_t)1 << (bits - 1)) - 1, min = -((int64_t)1 << (bits - 1));
+
+    if (value > max || value < min)
+    {
+        cpu->apsr |= THUMB_Q;
+        return (int32_t)(value > max ? max : min);
+    }
+    return (int32_t)value;
+}
+
+static uint32_t Thumb_Usat(Thumb_Cpu *cpu, int64_t value, uint32_t bits)
+{
+    int64_t max = ((int64_t)1 << bits) - 1;
+
+    if (value > max || value < 0)
+    {
+        cpu->apsr |= THUMB_Q;
+        return (uint32_t)(value < 0 ? 0 : max);
+    }
+    return (uint32_t)value;
+}
+
+/**
+ * @brief Single load/store: two cycles, one when it pipelines with the previous one
+ */
+static void Thumb_Ldst_Cost(Thumb_Exec *x)
+{
+    x->cost = x->cpu->last_was_ldst ? 1 : 2;
+    x->ldst = 1;
+}
+
+/**
+ * @brief Load into a register (LoadWritePC for PC)
+ */
+static int Thumb_Load_Reg(Thumb_Exec *x, uint32_t t, uint32_t value)
+{
+    if (t == 15) return Thumb_Bx(x, value);
+    x->cpu->r[t] = value;
+    return THUMB_OK;
+}
+
+/**
+ * @brief Result of a data-processing instruction (ALUWritePC for PC)
+ */
+static void Thumb_Set_Reg(Thumb_Exec *x, uint32_t d, uint32_t value)
+{
+    if (d == 15) Thumb_Branch(x, value);
+    else x->cpu->r[d] = value;
+}
+
+/**
+ * @brief LDM/STM/PUSH/POP: ascending addresses from `addr`
+ */
+static int Thumb_Multiple(Thumb_Exec *x, uint32_t addr, uint32_t list, int load, int rn, uint32_t writeback)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    uint32_t count = 0, pc_value = 0;
+
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        if (!(list & (1UL << i))) continue;
+        if (load)
+        {
+            uint32_t value = Thumb_Read(cpu, addr, 4);
+            if (i == 15) pc_value = value;
+            else cpu->r[i] = value;
+        }
+        else
+        {
+            Thumb_Write(cpu, addr, Thumb_Reg(x, i), 4);
+        }
+        addr += 4;
+        count++;
+    }
+    x->cost = 1 + count;
+    if (rn >= 0 && !(load && (list & (1UL << rn)))) cpu->r[rn] = writeback;
+    if (load && (list & 0x8000)) return Thumb_Bx(x, pc_value);
+    return THUMB_OK;
+}
+
+static uint32_t Thumb_Rev(uint32_t v)
+{
+    return (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+}
+
+/**
+ * @brief 16-bit Thumb instructions
+ */
+static int Thumb_Exec16(Thumb_Exec *x, uint32_t hw)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    uint32_t *r = cpu->r;
+    const int setflags = !x->in_it;
+    const uint32_t op = hw >> 11;
+    int carry;
+
+    switch (op)
+    {
+    case 0: case 1: case 2:
+    {
+        // LSL/LSR/ASR (immediate); LSL #0 is MOVS
+        uint32_t d = hw & 7, m = (hw >> 3) & 7;
+        int type;
+        uint32_t amount;
+        Thumb_Decode_Shift(op, (hw >> 6) & 31, &type, &amount);
+        uint32_t result = Thumb_Shift_C(r[m], type, amount, Thumb_Carry(cpu), &carry);
+        r[d] = result;
+        if (setflags) Thumb_Set_NZC(cpu, result, carry);
+        return THUMB_OK;
+    }
+    case 3:
+    {
+        uint32_t d = hw & 7, n = (hw >> 3) & 7, v = (hw >> 6) & 7;
+        uint32_t operand = (hw & 0x400) ? v : r[v];
+        if (hw & 0x200) r[d] = Thumb_Add(cpu, r[n], ~operand, 1, setflags);
+        else r[d] = Thumb_Add(cpu, r[n], operand, 0, setflags);
+        return THUMB_OK;
+    }
+    case 4:
+        r[(hw >> 8) & 7] = hw & 0xFF;
+        if (setflags) Thumb_Set_NZ(cpu, hw & 0xFF);
+        return THUMB_OK;
+    case 5:
+        Thumb_Add(cpu, r[(hw >> 8) & 7], ~(hw & 0xFF), 1, 1);
+        return THUMB_OK;
+    case 6:
+        r[(hw >> 8) & 7] = Thumb_Add(cpu, r[(hw >> 8) & 7], hw & 0xFF, 0, setflags);
+        return THUMB_OK;
+    case 7:
+        r[(hw >> 8) & 7] = Thumb_Add(cpu, r[(hw >> 8) & 7], ~(hw & 0xFF), 1, setflags);
+        return THUMB_OK;
+    case 8:
+        if (!(hw & 0x400))
+        {
+            // Data processing (register)
+            uint32_t d = hw & 7, m = (hw >> 3) & 7, a = r[d], b = r[m], result;
+            switch ((hw >> 6) & 15)
+            {
+            case 0: r[d] = result = a & b; if (setflags) Thumb_Set_NZ(cpu, result); break;
+            case 1: r[d] = result = a ^ b; if (setflags) Thumb_Set_NZ(cpu, result); break;
+            case 2: case 3: case 4: case 7:
+            {
+                static const int types[8] = { 0, 0, THUMB_LSL, THUMB_LSR, THUMB_ASR, 0, 0, THUMB_ROR };
+                r[d] = result = Thumb_Shift_C(a, types[(hw >> 6) & 7], b & 0xFF, Thumb_Carry(cpu), &carry);
+                if (setflags) Thumb_Set_NZC(cpu, result, carry);
+                break;
+            }
+            case 5: r[d] = Thumb_Add(cpu, a, b, (uint32_t)Thumb_Carry(cpu), setflags); break;
+            case 6: r[d] = Thumb_Add(cpu, a, ~b, (uint32_t)Thumb_Carry(cpu), setflags); break;
+            case 8: Thumb_Set_NZ(cpu, a & b); break;
+            case 9: r[d] = Thumb_Add(cpu, ~b, 0, 1, setflags); break;
+            case 10: Thumb_Add(cpu, a, ~b, 1, 1); break;
+            case 11: Thumb_Add(cpu, a, b, 0, 1); break;
+            case 12: r[d] = result = a | b; if (setflags) Thumb_Set_NZ(cpu, result); break;
+            case 13: r[d] = result = a * b; if (setflags) Thumb_Set_NZ(cpu, result); break;
+            case 14: r[d] = result = a & ~b; if (setflags) Thumb_Set_NZ(cpu, result); break;
+            default: r[d] = result = ~b; if (setflags) Thumb_Set_NZ(cpu, result); break;
+            }
+            return THUMB_OK;
+        }
+        else
+        {
+            // Special data processing and branch-exchange (high registers)
+            uint32_t d = (hw & 7) | ((hw >> 4) & 8), m = (hw >> 3) & 15;
+            switch ((hw >> 8) & 3)
+            {
+            case 0: Thumb_Set_Reg(x, d, Thumb_Reg(x, d) + Thumb_Reg(x, m)); return THUMB_OK;
+            case 1: Thumb_Add(cpu, Thumb_Reg(x, d), ~Thumb_Reg(x, m), 1, 1); return THUMB_OK;
+            case 2: Thumb_Set_Reg(x, d, Thumb_Reg(x, m)); return THUMB_OK;
+            default:
+            {
+                uint32_t target = Thumb_Reg(x, m);
+                if (hw & 0x80)
+                {
+                    r[14] = (x->pc + 2) | 1;
+                    cpu->event = THUMB_EVENT_CALL;
+                    cpu->event_target = target & ~1UL;
+                    cpu->event_return = x->pc + 2;
+                }
+                return Thumb_Bx(x, target);
+            }
+            }
+        }
+    case 9:
+    {
+        uint32_t addr = ((x->pc + 4) & ~3UL) + ((hw & 0xFF) << 2);
+        Thumb_Ldst_Cost(x);
+        r[(hw >> 8) & 7] = Thumb_Read(cpu, addr, 4);
+        return THUMB_OK;
+    }
+    case 10: case 11:
+    {
+        uint32_t t = hw & 7, addr = r[(hw >> 3) & 7] + r[(hw >> 6) & 7];
+        Thumb_Ldst_Cost(x);
+        switch ((hw >> 9) & 7)
+        {
+        case 0: Thumb_Write(cpu, addr, r[t], 4); break;
+        case 1: Thumb_Write(cpu, addr, r[t], 2); break;
+        case 2: Thumb_Write(cpu, addr, r[t], 1); break;
+        case 3: r[t] = (uint32_t)(int32_t)(int8_t)Thumb_Read(cpu, addr, 1); break;
+        case 4: r[t] = Thumb_Read(cpu, addr, 4); break;
+        case 5: r[t] = Thumb_Read(cpu, addr, 2); break;
+        case 6: r[t] = Thumb_Read(cpu, addr, 1); break;
+        default: r[t] = (uint32_t)(int32_t)(int16_t)Thumb_Read(cpu, addr, 2); break;
+        }
+        return THUMB_OK;
+    }
+    case 12: case 13: case 14: case 15: case 16: case 17:
+    {
+        static const int sizes[6] = { 4, 4, 1, 1, 2, 2 };
+        int size = sizes[op - 12];
+        uint32_t t = hw & 7, addr = r[(hw >> 3) & 7] + ((hw >> 6) & 31) * (uint32_t)size;
+        Thumb_Ldst_Cost(x);
+        if (op & 1) r[t] = Thumb_Read(cpu, addr, size);
+        else Thumb_Write(cpu, addr, r[t], size);
+        return THUMB_OK;
+    }
+    case 18: case 19:
+    {
+        uint32_t t = (hw >> 8) & 7, addr = r[13] + ((hw & 0xFF) << 2);
+        Thumb_Ldst_Cost(x);
+        if (op & 1) r[t] = Thumb_Read(cpu, addr, 4);
+        else Thumb_Write(cpu, addr, r[t], 4);
+        return THUMB_OK;
+    }
+    case 20:
+        r[(hw >> 8) & 7] = ((x->pc + 4) & ~3UL) + ((hw & 0xFF) << 2);
+        return THUMB_OK;
+    case 21:
+        r[(hw >> 8) & 7] = r[13] + ((hw & 0xFF) << 2);
+        return THUMB_OK;
+    case 22: case 23:
+        // Miscellaneous 16-bit instructions
+        if ((hw & 0xFF00) == 0xB000)
+        {
+            uint32_t imm = (hw & 0x7F) << 2;
+            r[13] = (hw & 0x80) ? r[13] - imm : r[13] + imm;
+            return THUMB_OK;
+        }
+        if ((hw & 0xF500) == 0xB100)
+        {
+            // CBZ / CBNZ
+            uint32_t offset = ((hw >> 3) & 0x1F) << 1 | ((hw >> 9) & 1) << 6;
+            int nonzero = (hw & 0x800) != 0;
+            if ((r[hw & 7] != 0) == nonzero) Thumb_Branch(x, x->pc + 4 + offset);
+            return THUMB_OK;
+        }
+        if ((hw & 0xFF00) == 0xB200)
+        {
+            uint32_t d = hw & 7, m = r[(hw >> 3) & 7];
+            switch ((hw >> 6) & 3)
+            {
+            case 0: r[d] = (uint32_t)(int32_t)(int16_t)m; break;
+            case 1: r[d] = (uint32_t)(int32_t)(int8_t)m; break;
+            case 2: r[d] = m & 0xFFFF; break;
+            default: r[d] = m & 0xFF; break;
+            }
+            return THUMB_OK;
+        }
+        if ((hw & 0xFE00) == 0xB400)
+        {
+            uint32_t list = (hw & 0xFF) | ((hw & 0x100) << 6);
+            uint32_t bytes = 4 * (uint32_t)__builtin_popcount(list);
+            int status = Thumb_Multiple(x, r[13] - bytes, list, 0, -1, 0);
+            r[13] -= bytes;
+            return status;
+        }
+        if ((hw & 0xFFE8) == 0xB660)
+        {
+            if (hw & 2) cpu->primask = (uint8_t)((hw >> 4) & 1);
+            return THUMB_OK;
+        }
+        if ((hw & 0xFF00) == 0xBA00 && ((hw >> 6) & 3) != 2)
+        {
+            uint32_t d = hw & 7, m = r[(hw >> 3) & 7];
+            switch ((hw >> 6) & 3)
+            {
+            case 0: r[d] = Thumb_Rev(m); break;
+            case 1: r[d] = ((m >> 8) & 0x00FF00FFUL) | ((m << 8) & 0xFF00FF00UL); break;
+            default: r[d] = (uint32_t)(int32_t)(int16_t)(((m >> 8) & 0xFF) | ((m & 0xFF) << 8)); break;
+            }
+            return THUMB_OK;
+        }
+        if ((hw & 0xFE00) == 0xBC00)
+        {
+            uint32_t list = (hw & 0xFF) | ((hw & 0x100) << 7);
+            uint32_t bytes = 4 * (uint32_t)__builtin_popcount(list);
+            return Thumb_Multiple(x, r[13], list, 1, 13, r[13] + bytes);
+        }
+        if ((hw & 0xFF00) == 0xBE00)
+        {
+            x->next = x->pc;
+            snprintf(cpu->fault, sizeof(cpu->fault), "BKPT #%u at pc 0x%08X", hw & 0xFF, x->pc);
+            return THUMB_STOPPED;
+        }
+        if ((hw & 0xFF00) == 0xBF00)
+        {
+            if (hw & 15)
+            {
+                cpu->it = (uint8_t)(hw & 0xFF);
+            }
+            else if (((hw >> 4) & 15) == 2 || ((hw >> 4) & 15) == 3)
+            {
+                cpu->event = THUMB_EVENT_WFI;
+            }
+            return THUMB_OK;
+        }
+        return Thumb_Fault(cpu, "undefined instruction 0x%04X at pc 0x%08X", hw, x->pc);
+    case 24: case 25:
+    {
+        uint32_t n = (hw >> 8) & 7, list = hw & 0xFF;
+        uint32_t bytes = 4 * (uint32_t)__builtin_popcount(list);
+        return Thumb_Multiple(x, r[n], list, op & 1, (int)n, r[n] + bytes);
+    }
+    case 26: case 27:
+    {
+        uint32_t cond = (hw >> 8) & 15;
+        if (cond >= 14) return Thumb_Fault(cpu, "%s at pc 0x%08X", cond == 15 ? "SVC" : "UDF", x->pc);
+        if (Thumb_Condition(cpu->apsr, cond)) Thumb_Branch(x, x->pc + 4 + (uint32_t)((int32_t)(int8_t)(hw & 0xFF) << 1));
+        return THUMB_OK;
+    }
+    default:
+    {
+        int32_t offset = (int32_t)((hw & 0x7FF) << 21) >> 20;
+        Thumb_Branch(x, x->pc + 4 + (uint32_t)offset);
+        return THUMB_OK;
+    }
+    }
+}
+
+/**
+ * @brief Data processing with a shifted-register or modified-immediate operand
+ * @param op: Operation (bits 24:21)
+ * @param operand: Second operand after the shift/expansion
+ * @param carry: Shifter carry out (for the logical operations)
+ */
+static int Thumb_Data_Processing(Thumb_Exec *x, uint32_t op, int setflags, uint32_t n, uint32_t d,
+                                 uint32_t operand, int carry)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    uint32_t a = Thumb_Reg(x, n), result;
+    int logical = 1, write = 1;
+
+    switch (op)
+    {
+    case 0:     // AND / TST
+        result = a & operand;
+        write = d != 15;
+        break;
+    case 1: result = a & ~operand; break;                       // BIC
+    case 2: result = (n == 15) ? operand : a | operand; break;  // ORR / MOV
+    case 3: result = (n == 15) ? ~operand : a | ~operand; break; // ORN / MVN
+    case 4:     // EOR / TEQ
+        result = a ^ operand;
+        write = d != 15;
+        break;
+    case 8:     // ADD / CMN
+        result = Thumb_Add(cpu, a, operand, 0, setflags);
+        logical = 0;
+        write = !(d == 15 && setflags);
+        break;
+    case 10: result = Thumb_Add(cpu, a, operand, (uint32_t)Thumb_Carry(cpu), setflags); logical = 0; break;
+    case 11: result = Thumb_Add(cpu, a, ~operand, (uint32_t)Thumb_Carry(cpu), setflags); logical = 0; break;
+    case 13:    // SUB / CMP
+        result = Thumb_Add(cpu, a, ~operand, 1, setflags);
+        logical = 0;
+        write = !(d == 15 && setflags);
+        break;
+    case 14: result = Thumb_Add(cpu, operand, ~a, 1, setflags); logical = 0; break;  // RSB
+    default:
+        return Thumb_Fault(cpu, "undefined data-processing op %u at pc 0x%08X", op, x->pc);
+    }
+
+    if (logical && setflags) Thumb_Set_NZC(cpu, result, carry);
+    if (write) Thumb_Set_Reg(x, d, result);
+    return THUMB_OK;
+}
+
+/**
+ * @brief LDR/STR (byte, halfword, word; immediate, register, literal)
+ */
+static int Thumb_Load_Store(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    const uint32_t n = hw1 & 15, t = hw2 >> 12;
+    const int size = 1 << ((hw1 >> 5) & 3), load = (hw1 >> 4) & 1, sign = (hw1 >> 8) & 1;
+    uint32_t addr, writeback = 0;
+    int wb = 0;
+
+    if (size > 4 || (!load && sign)) return Thumb_Fault(cpu, "undefined load/store at pc 0x%08X", x->pc);
+
+    if (n == 15)
+    {
+        if (!load) return Thumb_Fault(cpu, "store to a PC-relative address at pc 0x%08X", x->pc);
+        uint32_t base = (x->pc + 4) & ~3UL, imm = hw2 & 0xFFF;
+        addr = (hw1 & 0x80) ? base + imm : base - imm;
+    }
+    else if (hw1 & 0x80)
+    {
+        addr = Thumb_Reg(x, n) + (hw2 & 0xFFF);
+    }
+    else if (hw2 & 0x800)
+    {
+        uint32_t imm = hw2 & 0xFF, base = Thumb_Reg(x, n);
+        uint32_t offset = (hw2 & 0x200) ? base + imm : base - imm;
+        addr = (hw2 & 0x400) ? offset : base;
+        wb = (hw2 & 0x100) != 0;
+        writeback = offset;
+    }
+    else if ((hw2 & 0xFC0) == 0)
+    {
+        addr = Thumb_Reg(x, n) + (Thumb_Reg(x, hw2 & 15) << ((hw2 >> 4) & 3));
+    }
+    else
+    {
+        return Thumb_Fault(cpu, "undefined load/store 0x%04X%04X at pc 0x%08X", hw1, hw2, x->pc);
+    }
+
+    Thumb_Ldst_Cost(x);
+    if (load && t == 15 && size < 4) return THUMB_OK;  // PLD / PLI
+    if (load)
+    {
+        uint32_t value = Thumb_Read(cpu, addr, size);
+        if (sign) value = (size == 1) ? (uint32_t)(int32_t)(int8_t)value : (uint32_t)(int32_t)(int16_t)value;
+        if (wb) cpu->r[n] = writeback;
+        return Thumb_Load_Reg(x, t, value);
+    }
+    Thumb_Write(cpu, addr, Thumb_Reg(x, t), size);
+    if (wb) cpu->r[n] = writeback;
+    return THUMB_OK;
+}
+
+/**
+ * @brief LDRD/STRD, exclusives, TBB/TBH
+ */
+static int Thumb_Dual(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    const uint32_t n = hw1 & 15, t = hw2 >> 12;
+    uint32_t *r = cpu->r;
+
+    switch (hw1 & 0xFFF0)
+    {
+    case 0xE840:    // STREX (always succeeds: single core, no monitor contention)
+        Thumb_Ldst_Cost(x);
+        Thumb_Write(cpu, Thumb_Reg(x, n) + ((hw2 & 0xFF) << 2), r[t], 4);
+        r[(hw2 >> 8) & 15] = 0;
+        return THUMB_OK;
+    case 0xE850:    // LDREX
+        Thumb_Ldst_Cost(x);
+        r[t] = Thumb_Read(cpu, Thumb_Reg(x, n) + ((hw2 & 0xFF) << 2), 4);
+        return THUMB_OK;
+    case 0xE8C0:    // STREXB / STREXH
+        Thumb_Ldst_Cost(x);
+        Thumb_Write(cpu, Thumb_Reg(x, n), r[t], ((hw2 >> 4) & 15) == 4 ? 1 : 2);
+        r[hw2 & 15] = 0;
+        return THUMB_OK;
+    case 0xE8D0:
+    {
+        uint32_t op = (hw2 >> 4) & 15;
+        if (op <= 1)
+        {
+            // TBB / TBH
+            uint32_t base = Thumb_Reg(x, n), index = Thumb_Reg(x, hw2 & 15);
+            uint32_t half = op ? Thumb_Read(cpu, base + 2 * index, 2) : Thumb_Read(cpu, base + index, 1);
+            Thumb_Branch(x, x->pc + 4 + 2 * half);
+            x->cost += 1;
+            return THUMB_OK;
+        }
+        Thumb_Ldst_Cost(x);
+        r[t] = Thumb_Read(cpu, Thumb_Reg(x, n), op == 4 ? 1 : 2);
+        return THUMB_OK;
+    }
+    default:
+        break;
+    }
+
+    if (!(hw1 & 0x120)) return Thumb_Fault(cpu, "undefined 0x%04X%04X at pc 0x%08X", hw1, hw2, x->pc);
+
+    // LDRD / STRD
+    uint32_t imm = (hw2 & 0xFF) << 2, t2 = (hw2 >> 8) & 15;
+    uint32_t base = (n == 15) ? ((x->pc + 4) & ~3UL) : r[n];
+    uint32_t offset = (hw1 & 0x80) ? base + imm : base - imm;
+    uint32_t addr = (hw1 & 0x100) ? offset : base;
+
+    x->cost = 3;
+    if (hw1 & 0x10)
+    {
+        uint32_t lo = Thumb_Read(cpu, addr, 4), hi = Thumb_Read(cpu, addr + 4, 4);
+        r[t] = lo;
+        r[t2] = hi;
+    }
+    else
+    {
+        Thumb_Write(cpu, addr, r[t], 4);
+        Thumb_Write(cpu, addr + 4, r[t2], 4);
+    }
+    if (hw1 & 0x20) r[n] = offset;
+    return THUMB_OK;
+}
+
+/**
+ * @brief Data processing (plain binary immediate): ADDW, SUBW, MOVW, MOVT,
+ *        SSAT, USAT, SBFX, UBFX, BFI, BFC
+ */
+static int Thumb_Plain_Immediate(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    const uint32_t n = hw1 & 15, d = (hw2 >> 8) & 15, op = (hw1 >> 4) & 0x1F;
+    const uint32_t imm12 = ((hw1 >> 10) & 1) << 11 | ((hw2 >> 12) & 7) << 8 | (hw2 & 0xFF);
+    const uint32_t lsb = ((hw2 >> 12) & 7) << 2 | ((hw2 >> 6) & 3);
+    const uint32_t rn = Thumb_Reg(x, n);
+    uint32_t *r = cpu->r;
+
+    switch (op)
+    {
+    case 0x00: r[d] = (n == 15 ? (rn & ~3UL) : rn) + imm12; return THUMB_OK;
+    case 0x0A: r[d] = (n == 15 ? (rn & ~3UL) : rn) - imm12; return THUMB_OK;
+    case 0x04: r[d] = (hw1 & 15) << 12 | imm12; return THUMB_OK;
+    case 0x0C: r[d] = (r[d] & 0xFFFF) | ((hw1 & 15) << 12 | imm12) << 16; return THUMB_OK;
+    case 0x10: case 0x12: case 0x18: case 0x1A:
+    {
+        int is_signed = op < 0x18, asr = (op & 2) != 0;
+        uint32_t bits = (hw2 & 31) + (is_signed ? 1 : 0);
+        if (asr && lsb == 0)
+        {
+            // SSAT16 / USAT16
+            bits = (hw2 & 15) + (is_signed ? 1 : 0);
+            int32_t lo = (int16_t)(rn & 0xFFFF), hi = (int16_t)(rn >> 16);
+            uint32_t rlo = is_signed ? (uint32_t)Thumb_Ssat(cpu, lo, bits) : Thumb_Usat(cpu, lo, bits);
+            uint32_t rhi = is_signed ? (uint32_t)Thumb_Ssat(cpu, hi, bits) : Thumb_Usat(cpu, hi, bits);
+            r[d] = (rlo & 0xFFFF) | (rhi << 16);
+            return THUMB_OK;
+        }
+        int64_t value = (int32_t)Thumb_Shift(rn, asr ? THUMB_ASR : THUMB_LSL, lsb, 0);
+        r[d] = is_signed ? (uint32_t)Thumb_Ssat(cpu, value, bits) : Thumb_Usat(cpu, value, bits);
+        return THUMB_OK;
+    }
+    case 0x14: case 0x1C:
+    {
+        uint32_t width = (hw2 & 31) + 1;
+        if (lsb + width > 32) return Thumb_Fault(cpu, "bad bitfield at pc 0x%08X", x->pc);
+        uint32_t field = (rn >> lsb) & (width == 32 ? 0xFFFFFFFFUL : (1UL << width) - 1);
+        if (op == 0x14 && width < 32 && (field & (1UL << (width - 1)))) field |= ~0UL << width;
+        r[d] = field;
+        return THUMB_OK;
+    }
+    case 0x16:
+    {
+        uint32_t msb = hw2 & 31;
+        if (msb < lsb) return Thumb_Fault(cpu, "bad bitfield at pc 0x%08X", x->pc);
+        uint32_t width = msb - lsb + 1;
+        uint32_t mask = (width == 32 ? 0xFFFFFFFFUL : (1UL << width) - 1) << lsb;
+        uint32_t source = (n == 15) ? 0 : rn << lsb;
+        r[d] = (r[d] & ~mask) | (source & mask);
+        return THUMB_OK;
+    }
+    default:
+        return Thumb_Fault(cpu, "undefined immediate op 0x%02X at pc 0x%08X", op, x->pc);
+    }
+}
+
+/**
+ * @brief Branches and miscellaneous control (B, BL, MSR, MRS, hints, barriers)
+ */
+static int Thumb_Branch_Misc(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    const uint32_t op1 = (hw2 >> 12) & 5;
+    const uint32_t s = (hw1 >> 10) & 1, j1 = (hw2 >> 13) & 1, j2 = (hw2 >> 11) & 1;
+
+    if (op1 == 0)
+    {
+        if (((hw1 >> 7) & 7) != 7)
+        {
+            // B<c>.W: S:J2:J1:imm6:imm11:0
+            uint32_t imm = s << 20 | j2 << 19 | j1 << 18 | (hw1 & 0x3F) << 12 | (hw2 & 0x7FF) << 1;
+            int32_t offset = (int32_t)(imm << 11) >> 11;
+            if (Thumb_Condition(cpu->apsr, (hw1 >> 6) & 15)) Thumb_Branch(x, x->pc + 4 + (uint32_t)offset);
+            return THUMB_OK;
+        }
+
+        if ((hw1 & 0xFFE0) == 0xF380)
+        {
+            // MSR
+            uint32_t value = Thumb_Reg(x, hw1 & 15), sysm = hw2 & 0xFF, mask = (hw2 >> 10) & 3;
+            if (sysm < 8)
+            {
+                if (mask & 2) cpu->apsr = (cpu->apsr & 0x07FFFFFFUL) | (value & 0xF8000000UL);
+                if (mask & 1) cpu->apsr = (cpu->apsr & ~0x000F0000UL) | (value & 0x000F0000UL);
+            }
+            else if (sysm == 8 || sysm == 9)
+            {
+                cpu->r[13] = value & ~3UL;
+            }
+            else if (sysm == 16)
+            {
+                cpu->primask = (uint8_t)(value & 1);
+            }
+            x->cost = 2;
+            return THUMB_OK;
+        }
+        if ((hw1 & 0xFFE0) == 0xF3E0)
+        {
+            // MRS
+            uint32_t sysm = hw2 & 0xFF, value = 0;
+            if (sysm < 8) value = cpu->apsr & 0xF80F0000UL;
+            else if (sysm == 8 || sysm == 9) value = cpu->r[13];
+            else if (sysm == 16) value = cpu->primask;
+            if (sysm >= 1 && sysm <= 3 && cpu->handler) value |= 16;   // IPSR: some external interrupt
+            cpu->r[(hw2 >> 8) & 15] = value;
+            return THUMB_OK;
+        }
+        if ((hw1 & 0xFFF0) == 0xF3A0)
+        {
+            // NOP.W, YIELD.W, WFE.W, WFI.W, SEV.W
+            if ((hw2 & 0xFF) == 2 || (hw2 & 0xFF) == 3) cpu->event = THUMB_EVENT_WFI;
+            return THUMB_OK;
+        }
+        if ((hw1 & 0xFFF0) == 0xF3B0)
+        {
+            // DSB / DMB / ISB
+            if (((hw2 >> 4) & 15) == 6) x->cost += THUMB_REFILL;
+            return THUMB_OK;
+        }
+        return Thumb_Fault(cpu, "undefined 0x%04X%04X at pc 0x%08X", hw1, hw2, x->pc);
+    }
+
+    // B.W / BL: S:I1:I2:imm10:imm11:0, I = NOT(J XOR S)
+    uint32_t i1 = !(j1 ^ s), i2 = !(j2 ^ s);
+    uint32_t imm = s << 24 | i1 << 23 | i2 << 22 | (hw1 & 0x3FF) << 12 | (hw2 & 0x7FF) << 1;
+    uint32_t target = x->pc + 4 + (uint32_t)((int32_t)(imm << 7) >> 7);
+
+    if (op1 == 1)
+    {
+        Thumb_Branch(x, target);
+        return THUMB_OK;
+    }
+    if (op1 == 5)
+    {
+        cpu->r[14] = (x->pc + 4) | 1;
+        cpu->event = THUMB_EVENT_CALL;
+        cpu->event_target = target;
+        cpu->event_return = x->pc + 4;
+        Thumb_Branch(x, target);
+        return THUMB_OK;
+    }
+    return Thumb_Fault(cpu, "BLX to ARM state at pc 0x%08X", x->pc);
+}
+
+/**
+ * @brief One lane of the parallel add/subtract instructions
+ * @param kind: 0 modular (sets GE), 1 saturating, 2 halving
+ * @param ge: Set when the lane's GE condition holds (no signed overflow
+ *            below zero, unsigned carry out, or no unsigned borrow)
+ */
+static uint32_t Thumb_Lane(int32_t value, int bits, int is_unsigned, int is_sub, int kind, int *ge)
+{
+    if (kind == 1)
+    {
+        int32_t max = is_unsigned ? (1 << bits) - 1 : (1 << (bits - 1)) - 1;
+        int32_t min = is_unsigned ? 0 : -(1 << (bits - 1));
+        value = value > max ? max : (value < min ? min : value);
+    }
+    else if (kind == 2)
+    {
+        value >>= 1;
+    }
+    *ge = (is_unsigned && !is_sub) ? value >= (1 << bits) : value >= 0;
+    return (uint32_t)value & ((1UL << bits) - 1);
+}
+
+/**
+ * @brief SADD16, UQSUB8, SHASX, ... (parallel add/subtract)
+ * @param op: ADD8 0, ADD16 1, ASX 2, SUB8 4, SUB16 5, SAX 6
+ */
+static uint32_t Thumb_Parallel(Thumb_Cpu *cpu, uint32_t op, int is_unsigned, int kind, uint32_t a, uint32_t b)
+{
+    const int bits = (op == 0 || op == 4) ? 8 : 16, lanes = 32 / bits;
+    const uint32_t mask = (1UL << bits) - 1;
+    uint32_t result = 0, ge = 0;
+
+    for (int i = 0; i < lanes; i++)
+    {
+        // ASX/SAX cross the halfwords of the second operand
+        int j = (op == 2 || op == 6) ? 1 - i : i;
+        int is_sub = (op >= 4 && op != 6) || (op == 2 && i == 0) || (op == 6 && i == 1);
+        uint32_t ua = (a >> (bits * i)) & mask, ub = (b >> (bits * j)) & mask;
+        int32_t x = is_unsigned ? (int32_t)ua : (int32_t)(ua << (32 - bits)) >> (32 - bits);
+        int32_t y = is_unsigned ? (int32_t)ub : (int32_t)(ub << (32 - bits)) >> (32 - bits);
+        int lane_ge;
+
+        result |= Thumb_Lane(is_sub ? x - y : x + y, bits, is_unsigned, is_sub, kind, &lane_ge) << (bits * i);
+        if (lane_ge) ge |= (bits == 8 ? 1UL : 3UL) << (i * (bits / 8));
+    }
+    if (kind == 0) cpu->apsr = (cpu->apsr & ~0x000F0000UL) | (ge << THUMB_GE_SHIFT);
+    return result;
+}
+
+/**
+ * @brief Data processing (register): shifts by register, extends, parallel
+ *        add/subtract, REV, RBIT, CLZ, QADD, SEL
+ */
+static int Thumb_Data_Register(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    const uint32_t op1 = (hw1 >> 4) & 15, op2 = (hw2 >> 4) & 15;
+    const uint32_t d = (hw2 >> 8) & 15, n = hw1 & 15;
+    const uint32_t a = Thumb_Reg(x, n), b = Thumb_Reg(x, hw2 & 15);
+    uint32_t *r = cpu->r;
+
+    if ((hw2 & 0xF000) != 0xF000) return Thumb_Fault(cpu, "undefined 0x%04X%04X at pc 0x%08X", hw1, hw2, x->pc);
+
+    if (!(op1 & 8) && op2 == 0)
+    {
+        int carry;
+        uint32_t result = Thumb_Shift_C(a, (int)((op1 >> 1) & 3), b & 0xFF, Thumb_Carry(cpu), &carry);
+        r[d] = result;
+        if (op1 & 1) Thumb_Set_NZC(cpu, result, carry);
+        return THUMB_OK;
+    }
+    if (!(op1 & 8) && (op2 & 8))
+    {
+        uint32_t rotated = Thumb_Shift(b, THUMB_ROR, (op2 & 3) * 8, 0);
+        uint32_t add = (n == 15) ? 0 : a, value;
+        switch (op1)
+        {
+        case 0: value = add + (uint32_t)(int32_t)(int16_t)rotated; break;
+        case 1: value = add + (rotated & 0xFFFF); break;
+        case 2:
+        case 3:
+        {
+            uint32_t lo = (op1 == 2) ? (uint32_t)(int32_t)(int8_t)rotated : (rotated & 0xFF);
+            uint32_t hi = (op1 == 2) ? (uint32_t)(int32_t)(int8_t)(rotated >> 16) : ((rotated >> 16) & 0xFF);
+            value = ((add + lo) & 0xFFFF) | (((add >> 16) + hi) << 16);
+            break;
+        }
+        case 4: value = add + (uint32_t)(int32_t)(int8_t)rotated; break;
+        case 5: value = add + (rotated & 0xFF); break;
+        default: return Thumb_Fault(cpu, "undefined extend at pc 0x%08X", x->pc);
+        }
+        r[d] = value;
+        return THUMB_OK;
+    }
+    if ((op1 & 8) && !(op2 & 8))
+    {
+        uint32_t kind = op2 & 3;
+        if (kind == 3) return Thumb_Fault(cpu, "undefined parallel op at pc 0x%08X", x->pc);
+        r[d] = Thumb_Parallel(cpu, op1 & 7, (op2 >> 2) & 1, (int)kind, a, b);
+        return THUMB_OK;
+    }
+    if ((op1 & 0xC) == 8 && (op2 & 0xC) == 8)
+    {
+        switch (((op1 & 3) << 2) | (op2 & 3))
+        {
+        case 0: r[d] = (uint32_t)Thumb_Ssat(cpu, (int64_t)(int32_t)b + (int32_t)a, 32); break;      // QADD
+        case 1: r[d] = (uint32_t)Thumb_Ssat(cpu, (int64_t)(int32_t)b + Thumb_Ssat(cpu, 2 * (int64_t)(int32_t)a, 32), 32); break;
+        case 2: r[d] = (uint32_t)Thumb_Ssat(cpu, (int64_t)(int32_t)b - (int32_t)a, 32); break;      // QSUB
+        case 3: r[d] = (uint32_t)Thumb_Ssat(cpu, (int64_t)(int32_t)b - Thumb_Ssat(cpu, 2 * (int64_t)(int32_t)a, 32), 32); break;
+        case 4: r[d] = Thumb_Rev(b); break;
+        case 5: r[d] = ((b >> 8) & 0x00FF00FFUL) | ((b << 8) & 0xFF00FF00UL); break;
+        case 6:
+        {
+            uint32_t v = 0;
+            for (int i = 0; i < 32; i++) v |= ((b >> i) & 1) << (31 - i);
+            r[d] = v;
+            break;
+        }
+        case 7: r[d] = (uint32_t)(int32_t)(int16_t)(((b >> 8) & 0xFF) | ((b & 0xFF) << 8)); break;
+        case 8:
+        {
+            // SEL: bytes from Rn where GE is set, else from Rm
+            uint32_t ge = (cpu->apsr >> THUMB_GE_SHIFT) & 15, v = 0;
+            for (int i = 0; i < 4; i++) v |= (((ge >> i) & 1) ? a : b) & (0xFFUL << (8 * i));
+            r[d] = v;
+            break;
+        }
+        case 12: r[d] = b ? (uint32_t)__builtin_clz(b) : 32; break;
+        default: return Thumb_Fault(cpu, "undefined 0x%04X%04X at pc 0x%08X", hw1, hw2, x->pc);
+        }
+        return THUMB_OK;
+    }
+    return Thumb_Fault(cpu, "undefined 0x%04X%04X at pc 0x%08X", hw1, hw2, x->pc);
+}
+
+static int32_t Thumb_Half(uint32_t v, int high)
+{
+    return high ? (int16_t)(v >> 16) : (int16_t)v;
+}
+
+/**
+ * @brief 32-bit multiplies and multiply-accumulates (MUL, MLA, SMLAxy, SMLAD, ...)
+ */
+static int Thumb_Multiply(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    const uint32_t op1 = (hw1 >> 4) & 7, op2 = (hw2 >> 4) & 3;
+    const uint32_t ra = hw2 >> 12, d = (hw2 >> 8) & 15;
+    const uint32_t a = cpu->r[hw1 & 15], b = cpu->r[hw2 & 15], acc = cpu->r[ra];
+    const int accumulate = ra != 15;
+    int64_t value;
+
+    switch (op1)
+    {
+    case 0:
+        if (op2 == 0) cpu->r[d] = a * b + (accumulate ? acc : 0);
+        else cpu->r[d] = acc - a * b;
+        if (accumulate) x->cost = 2;
+        return THUMB_OK;
+    case 1:     // SMLA<x><y> / SMUL<x><y>
+        value = (int64_t)Thumb_Half(a, (op2 >> 1) & 1) * Thumb_Half(b, op2 & 1);
+        if (accumulate)
+        {
+            value += (int32_t)acc;
+            if (value != (int32_t)value) cpu->apsr |= THUMB_Q;
+        }
+        cpu->r[d] = (uint32_t)value;
+        return THUMB_OK;
+    case 2:     // SMLAD / SMUAD
+    case 4:     // SMLSD / SMUSD
+    {
+        uint32_t m = (op2 & 1) ? Thumb_Shift(b, THUMB_ROR, 16, 0) : b;
+        int64_t p1 = (int64_t)Thumb_Half(a, 0) * Thumb_Half(m, 0), p2 = (int64_t)Thumb_Half(a, 1) * Thumb_Half(m, 1);
+        value = (op1 == 2 ? p1 + p2 : p1 - p2) + (accumulate ? (int32_t)acc : 0);
+        if (value != (int32_t)value) cpu->apsr |= THUMB_Q;
+        cpu->r[d] = (uint32_t)value;
+        return THUMB_OK;
+    }
+    case 3:     // SMLAW<y> / SMULW<y>
+        value = ((int64_t)(int32_t)a * Thumb_Half(b, op2 & 1)) >> 16;
+        if (accumulate)
+        {
+            value += (int32_t)acc;
+            if (value != (int32_t)value) cpu->apsr |= THUMB_Q;
+        }
+        cpu->r[d] = (uint32_t)value;
+        return THUMB_OK;
+    case 5:     // SMMLA / SMMUL
+    case 6:     // SMMLS
+    {
+        int64_t product = (int64_t)(int32_t)a * (int32_t)b;
+        int64_t base = accumulate ? (int64_t)((uint64_t)acc << 32) : 0;
+        uint64_t sum = (uint64_t)(op1 == 5 ? base + product : base - product);
+        if (op2 & 1) sum += 0x80000000ULL;
+        cpu->r[d] = (uint32_t)(sum >> 32);
+        return THUMB_OK;
+    }
+    default:    // USAD8 / USADA8
+    {
+        uint32_t sum = accumulate ? acc : 0;
+        for (int i = 0; i < 4; i++)
+        {
+            int32_t diff = (int32_t)((a >> (8 * i)) & 0xFF) - (int32_t)((b >> (8 * i)) & 0xFF);
+            sum += (uint32_t)(diff < 0 ? -diff : diff);
+        }
+        cpu->r[d] = sum;
+        return THUMB_OK;
+    }
+    }
+}
+
+/**
+ * @brief Long multiplies and divides (SMULL, UMLAL, SDIV, UDIV, ...)
+ */
+static int Thumb_Long_Multiply(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    const uint32_t op1 = (hw1 >> 4) & 7, op2 = (hw2 >> 4) & 15;
+    const uint32_t lo = hw2 >> 12, hi = (hw2 >> 8) & 15;
+    const uint32_t a = cpu->r[hw1 & 15], b = cpu->r[hw2 & 15];
+    uint64_t acc = ((uint64_t)cpu->r[hi] << 32) | cpu->r[lo], result;
+
+    if ((op1 == 1 || op1 == 3) && op2 == 15)
+    {
+        // SDIV / UDIV: early termination, 2-12 cycles depending on the quotient size
+        uint32_t quotient;
+        if (b == 0) quotient = 0;
+        else if (op1 == 3) quotient = a / b;
+        else if (a == 0x80000000UL && b == 0xFFFFFFFFUL) quotient = a;
+        else quotient = (uint32_t)((int32_t)a / (int32_t)b);
+
+        uint32_t magnitude = (op1 == 1 && (int32_t)quotient < 0) ? 0u - quotient : quotient;
+        uint32_t bits = magnitude ? 32 - (uint32_t)__builtin_clz(magnitude) : 0;
+        x->cost = 2 + (bits + 3) / 4;
+        if (x->cost > 12) x->cost = 12;
+        cpu->r[hi] = quotient;
+        return THUMB_OK;
+    }
+
+    switch (op1 << 4 | op2)
+    {
+    case 0x00: result = (uint64_t)((int64_t)(int32_t)a * (int32_t)b); break;             // SMULL
+    case 0x20: result = (uint64_t)a * b; break;                                          // UMULL
+    case 0x40: result = acc + (uint64_t)((int64_t)(int32_t)a * (int32_t)b); break;       // SMLAL
+    case 0x60: result = acc + (uint64_t)a * b; break;                                    // UMLAL
+    case 0x66: result = (uint64_t)a * b + cpu->r[lo] + cpu->r[hi]; break;               // UMAAL
+    case 0x48: case 0x49: case 0x4A: case 0x4B:                                          // SMLALxy
+        result = acc + (uint64_t)((int64_t)Thumb_Half(a, (op2 >> 1) & 1) * Thumb_Half(b, op2 & 1));
+        break;
+    case 0x4C: case 0x4D: case 0x5C: case 0x5D:                                          // SMLALD / SMLSLD
+    {
+        uint32_t m = (op2 & 1) ? Thumb_Shift(b, THUMB_ROR, 16, 0) : b;
+        int64_t p1 = (int64_t)Thumb_Half(a, 0) * Thumb_Half(m, 0), p2 = (int64_t)Thumb_Half(a, 1) * Thumb_Half(m, 1);
+        result = acc + (uint64_t)(op1 == 4 ? p1 + p2 : p1 - p2);
+        break;
+    }
+    default:
+        return Thumb_Fault(cpu, "undefined multiply 0x%04X%04X at pc 0x%08X", hw1, hw2, x->pc);
+    }
+    cpu->r[lo] = (uint32_t)result;
+    cpu->r[hi] = (uint32_t)(result >> 32);
+    return THUMB_OK;
+}
+
+static float Thumb_Sf(const Thumb_Cpu *cpu, uint32_t reg)
+{
+    float f;
+    memcpy(&f, &cpu->s[reg], sizeof(f));
+    return f;
+}
+
+static void Thumb_Set_Sf(Thumb_Cpu *cpu, uint32_t reg, float f)
+{
+    memcpy(&cpu->s[reg], &f, sizeof(f));
+}
+
+/**
+ * @brief Float to integer conversion with ARM saturation (NaN converts to 0)
+ */
+static uint32_t Thumb_Float_To_Int(float value, int is_signed, int toward_zero, uint32_t rmode)
+{
+    double v = value;
+
+    if (isnan(v)) return 0;
+    if (toward_zero || rmode == 3) v = trunc(v);
+    else if (rmode == 0) v = nearbyint(v);
+    else if (rmode == 1) v = ceil(v);
+    else v = floor(v);
+
+    if (is_signed)
+    {
+        if (v >= 2147483647.0) return 0x7FFFFFFFUL;
+        if (v <= -2147483648.0) return 0x80000000UL;
+        return (uint32_t)(int32_t)v;
+    }
+    if (v >= 4294967295.0) return 0xFFFFFFFFUL;
+    if (v <= 0.0) return 0;
+    return (uint32_t)v;
+}
+
+/**
+ * @brief VFP data processing, single precision
+ */
+static int Thumb_Vfp_Data(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    Thumb_Cpu *cpu = x->cpu;
+    const uint32_t opc1 = ((hw1 >> 5) & 4) | ((hw1 >> 4) & 3), op = (hw2 >> 6) & 1;
+    const uint32_t sd = ((hw2 >> 12) & 15) << 1 | ((hw1 >> 6) & 1);
+    const uint32_t sn = (hw1 & 15) << 1 | ((hw2 >> 7) & 1);
+    const uint32_t sm = (hw2 & 15) << 1 | ((hw2 >> 5) & 1);
+    const float d = Thumb_Sf(cpu, sd), n = Thumb_Sf(cpu, sn), m = Thumb_Sf(cpu, sm);
+    volatile float product;     // Rounded separately from the accumulate (no host FMA contraction)
+
+    if (hw2 & 0x100) return Thumb_Fault(cpu, "double-precision VFP at pc 0x%08X", x->pc);
+
+    switch (opc1)
+    {
+    case 0:     // VMLA / VMLS
+        product = n * m;
+        Thumb_Set_Sf(cpu, sd, op ? d - product : d + product);
+        x->cost = 3;
+        return THUMB_OK;
+    case 1:     // VNMLS / VNMLA
+        product = n * m;
+        Thumb_Set_Sf(cpu, sd, op ? -d - product : -d + product);
+        x->cost = 3;
+        return THUMB_OK;
+    case 2:
+        product = n * m;
+        Thumb_Set_Sf(cpu, sd, op ? -product : product);
+        return THUMB_OK;
+    case 3:
+        Thumb_Set_Sf(cpu, sd, op ? n - m : n + m);
+        return THUMB_OK;
+    case 4:
+        Thumb_Set_Sf(cpu, sd, n / m);
+        x->cost = 14;
+        return THUMB_OK;
+    case 5:     // VFNMS / VFNMA
+        Thumb_Set_Sf(cpu, sd, fmaf(op ? -n : n, m, -d));
+        x->cost = 3;
+        return THUMB_OK;
+    case 6:     // VFMA / VFMS
+        Thumb_Set_Sf(cpu, sd, fmaf(op ? -n : n, m, d));
+        x->cost = 3;
+        return THUMB_OK;
+    default:
+        break;
+    }
+
+    if (!op)
+    {
+        // VMOV immediate (VFPExpandImm)
+        uint32_t imm8 = (hw1 & 15) << 4 | (hw2 & 15);
+        cpu->s[sd] = (imm8 & 0x80) << 24 | ((imm8 & 0x40) ? 0x3E000000UL : 0x40000000UL) | (imm8 & 0x3F) << 19;
+        return THUMB_OK;
+    }
+
+    const uint32_t opc2 = hw1 & 15, bit7 = (hw2 >> 7) & 1;
+    const uint32_t rmode = (cpu->fpscr >> 22) & 3;
+    switch (opc2)
+    {
+    case 0:
+        if (bit7) Thumb_Set_Sf(cpu, sd, fabsf(m));
+        else cpu->s[sd] = cpu->s[sm];
+        return THUMB_OK;
+    case 1:
+        if (bit7)
+        {
+            Thumb_Set_Sf(cpu, sd, sqrtf(m));
+            x->cost = 14;
+        }
+        else
+        {
+            cpu->s[sd] = cpu->s[sm] ^ 0x80000000UL;
+        }
+        return THUMB_OK;
+    case 4:
+    case 5:
+    {
+        float b = (opc2 == 5) ? 0.0f : m;
+        uint32_t nzcv = (isnan(d) || isnan(b)) ? 0x3 : (d == b) ? 0x6 : (d < b) ? 0x8 : 0x2;
+        cpu->fpscr = (cpu->fpscr & 0x0FFFFFFFUL) | (nzcv << 28);
+        return THUMB_OK;
+    }
+    case 8:     // VCVT.F32.S32 / .U32
+        Thumb_Set_Sf(cpu, sd, bit7 ? (float)(int32_t)cpu->s[sm] : (float)cpu->s[sm]);
+        return THUMB_OK;
+    case 12:
+    case 13:    // VCVT(R).S32/U32.F32
+        cpu->s[sd] = Thumb_Float_To_Int(m, opc2 & 1, (int)bit7, rmode);
+        return THUMB_OK;
+    case 10: case 11: case 14: case 15:
+    {
+        // VCVT between float and fixed point, in place on Sd
+        uint32_t size = bit7 ? 32 : 16;
+        uint32_t imm = (hw2 & 15) << 1 | ((hw2 >> 5) & 1);
+        int frac = (int)size - (int)imm;
+        int is_unsigned = opc2 & 1;
+        if (opc2 & 4)
+        {
+            uint32_t v = Thumb_Float_To_Int(ldexpf(d, frac), !is_unsigned, 1, rmode);
+            if (size == 16)
+            {
+                int64_t wide = is_unsigned ? (int64_t)v : (int64_t)(int32_t)v;
+                v = is_unsigned ? (uint32_t)(wide > 65535 ? 65535 : wide)
+                                : (uint32_t)(int32_t)(wide > 32767 ? 32767 : (wide < -32768 ? -32768 : wide)) & 0xFFFF;
+                if (!is_unsigned) v = (uint32_t)(int32_t)(int16_t)v;
+            }
+            cpu->s[sd] = v;
+        }
+        else
+        {
+            uint32_t raw = cpu->s[sd];
+            double v = is_unsigned ? (size == 16 ? (double)(raw & 0xFFFF) : (double)raw)
+                                   : (size == 16 ? (double)(int16_t)raw : (double)(int32_t)raw);
+            Thumb_Set_Sf(cpu, sd, (float)ldexp(v, -frac));
+        }
+        return THUMB_OK;
+    }
+    default:
+        return Thumb_Fault(cpu, "unsupported VFP op 0x%04X%04X at pc 0x%08X", hw1, hw2, x->pc);
+    }
+}
+
+/**
+ * @brief Coprocessor space: VFP data processing, register transfers,
+ *        VLDR/VSTR/VLDM/VSTM/VPUSH/VPOP
+ */
+static int Thumb_Vfp(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    Thumb_Cpu *cpu = x->cpu;
+
+    if ((hw2 & 0x0E00) != 0x0A00) return Thumb_Fault(cpu, "coprocessor instruction at pc 0x%08X", x->pc);
+
+    if ((hw1 & 0xFF00) == 0xEE00)
+    {
+        if (!(hw2 & 0x10)) return Thumb_Vfp_Data(x, hw1, hw2);
+
+        uint32_t t = hw2 >> 12, load = (hw1 >> 4) & 1;
+        if ((hw1 & 0xE0) == 0 && !(hw2 & 0x100))
+        {
+            // VMOV Sn <-> Rt
+            uint32_t sn = (hw1 & 15) << 1 | ((hw2 >> 7) & 1);
+            if (load) cpu->r[t] = cpu->s[sn];
+            else cpu->s[sn] = cpu->r[t];
+            return THUMB_OK;
+        }
+        if ((hw1 & 0xE0) == 0xE0 && (hw1 & 15) == 1)
+        {
+            // VMRS / VMSR (FPSCR)
+            if (!load) cpu->fpscr = cpu->r[t];
+            else if (t == 15) cpu->apsr = (cpu->apsr & 0x0FFFFFFFUL) | (cpu->fpscr & 0xF0000000UL);
+            else cpu->r[t] = cpu->fpscr;
+            return THUMB_OK;
+        }
+        return Thumb_Fault(cpu, "unsupported VFP transfer at pc 0x%08X", x->pc);
+    }
+
+    const uint32_t is_double = (hw2 >> 8) & 1;
+    if ((hw1 & 0xFFE0) == 0xEC40)
+    {
+        // VMOV two core registers <-> two singles / one double
+        uint32_t m = (hw2 & 15) << 1 | ((hw2 >> 5) & 1), t = hw2 >> 12, t2 = hw1 & 15;
+        if (is_double) m = ((hw2 & 15) | ((hw2 >> 1) & 16)) << 1;
+        if (m > 30) return Thumb_Fault(cpu, "bad VMOV at pc 0x%08X", x->pc);
+        if (hw1 & 0x10)
+        {
+            cpu->r[t] = cpu->s[m];
+            cpu->r[t2] = cpu->s[m + 1];
+        }
+        else
+        {
+            cpu->s[m] = cpu->r[t];
+            cpu->s[m + 1] = cpu->r[t2];
+        }
+        x->cost = 2;
+        return THUMB_OK;
+    }
+
+    if ((hw1 & 0xFE00) != 0xEC00)
+    {
+        return Thumb_Fault(cpu, "coprocessor instruction at pc 0x%08X", x->pc);
+    }
+
+    // Extension register load/store; doubles move as register pairs
+    const uint32_t p = (hw1 >> 8) & 1, u = (hw1 >> 7) & 1, w = (hw1 >> 5) & 1, load = (hw1 >> 4) & 1;
+    const uint32_t n = hw1 & 15, imm = (hw2 & 0xFF) << 2;
+    const uint32_t first = is_double ? ((((hw1 >> 6) & 1) << 4) | (hw2 >> 12)) << 1 : (hw2 >> 12) << 1 | ((hw1 >> 6) & 1);
+    const uint32_t base = (n == 15) ? ((x->pc + 4) & ~3UL) : cpu->r[n];
+    uint32_t addr, words;
+
+    if (p && !w)
+    {
+        // VLDR / VSTR
+        addr = u ? base + imm : base - imm;
+        words = is_double ? 2 : 1;
+        Thumb_Ldst_Cost(x);
+        if (is_double) x->cost++;
+    }
+    else if (p == u)
+    {
+        return Thumb_Fault(cpu, "undefined VFP load/store at pc 0x%08X", x->pc);
+    }
+    else
+    {
+        // VLDM / VSTM / VPUSH / VPOP
+        words = (hw2 & 0xFF) & (is_double ? 0xFE : 0xFF);
+        addr = u ? base : base - imm;
+        if (w) cpu->r[n] = u ? base + imm : base - imm;
+        x->cost = 1 + words;
+    }
+
+    if (first + words > 32) return Thumb_Fault(cpu, "VFP register list out of range at pc 0x%08X", x->pc);
+    for (uint32_t i = 0; i < words; i++)
+    {
+        if (load) cpu->s[first + i] = Thumb_Read(cpu, addr + 4 * i, 4);
+        else Thumb_Write(cpu, addr + 4 * i, cpu->s[first + i], 4);
+    }
+    return THUMB_OK;
+}
+
+/**
+ * @brief 32-bit Thumb-2 instructions
+ */
+static int Thumb_Exec32(Thumb_Exec *x, uint32_t hw1, uint32_t hw2)
+{
+    const uint32_t op1 = (hw1 >> 11) & 3, op2 = (hw1 >> 4) & 0x7F;
+    Thumb_Cpu *cpu = x->cpu;
+
+    if (op1 == 1)
+    {
+        if ((op2 & 0x64) == 0x00)
+        {
+            // LDM/STM (IA, DB); PUSH.W/POP.W
+            uint32_t n = hw1 & 15, list = hw2, bytes = 4 * (uint32_t)__builtin_popcount(hw2 & 0xFFFF);
+            uint32_t base = cpu->r[n], db = ((hw1 >> 7) & 3) == 2;
+            uint32_t wb = (hw1 & 0x20) ? (db ? base - bytes : base + bytes) : base;
+            if (((hw1 >> 7) & 3) == 0 || ((hw1 >> 7) & 3) == 3) return Thumb_Fault(cpu, "undefined LDM/STM at pc 0x%08X", x->pc);
+            return Thumb_Multiple(x, db ? base - bytes : base, list & 0xFFFF, (hw1 >> 4) & 1, (hw1 & 0x20) ? (int)n : -1, wb);
+        }
+        if ((op2 & 0x64) == 0x04) return Thumb_Dual(x, hw1, hw2);
+        if ((op2 & 0x60) == 0x20)
+        {
+            const uint32_t op = (hw1 >> 5) & 15, setflags = (hw1 >> 4) & 1;
+            const uint32_t n = hw1 & 15, d = (hw2 >> 8) & 15, m = hw2 & 15;
+            const uint32_t imm5 = ((hw2 >> 12) & 7) << 2 | ((hw2 >> 6) & 3);
+            int type, carry;
+            uint32_t amount;
+
+            if (op == 6)
+            {
+                // PKHBT / PKHTB
+                uint32_t tb = (hw2 >> 5) & 1;
+                Thumb_Decode_Shift(tb ? THUMB_ASR : THUMB_LSL, imm5, &type, &amount);
+                uint32_t shifted = Thumb_Shift(Thumb_Reg(x, m), type, amount, 0), a = Thumb_Reg(x, n);
+                cpu->r[d] = tb ? (a & 0xFFFF0000UL) | (shifted & 0xFFFF) : (a & 0xFFFF) | (shifted & 0xFFFF0000UL);
+                return THUMB_OK;
+            }
+            Thumb_Decode_Shift((hw2 >> 4) & 3, imm5, &type, &amount);
+            uint32_t operand = Thumb_Shift_C(Thumb_Reg(x, m), type, amount, Thumb_Carry(cpu), &carry);
+            return Thumb_Data_Processing(x, op, (int)setflags, n, d, operand, carry);
+        }
+        return Thumb_Vfp(x, hw1, hw2);
+    }
+
+    if (op1 == 2)
+    {
+        if (hw2 & 0x8000) return Thumb_Branch_Misc(x, hw1, hw2);
+        if (op2 & 0x20) return Thumb_Plain_Immediate(x, hw1, hw2);
+
+        const uint32_t imm12 = ((hw1 >> 10) & 1) << 11 | ((hw2 >> 12) & 7) << 8 | (hw2 & 0xFF);
+        int carry;
+        uint32_t operand = Thumb_Expand_Imm(imm12, Thumb_Carry(cpu), &carry);
+        return Thumb_Data_Processing(x, (hw1 >> 5) & 15, (hw1 >> 4) & 1, hw1 & 15, (hw2 >> 8) & 15, operand, carry);
+    }
+
+    if ((op2 & 0x71) == 0x00 || (op2 & 0x67) == 0x01 || (op2 & 0x67) == 0x03 || (op2 & 0x67) == 0x05)
+    {
+        return Thumb_Load_Store(x, hw1, hw2);
+    }
+    if ((op2 & 0x70) == 0x20) return Thumb_Data_Register(x, hw1, hw2);
+    if ((op2 & 0x78) == 0x30) return Thumb_Multiply(x, hw1, hw2);
+    if ((op2 & 0x78) == 0x38) return Thumb_Long_Multiply(x, hw1, hw2);
+    if (op2 & 0x40) return Thumb_Vfp(x, hw1, hw2);
+    return Thumb_Fault(cpu, "undefined 0x%04X%04X at pc 0x%08X", hw1, hw2, x->pc);
+}
+
+/**
+ * @brief Execute one instruction
+ * @return THUMB_OK, THUMB_STOPPED (returned to THUMB_RETURN_MAGIC or hit a
+ *         BKPT) or THUMB_FAULT (message in cpu->fault)
+ */
+int Thumb_Step(Thumb_Cpu *cpu)
+{
+    const uint32_t pc = cpu->r[15];
+    const uint8_t *p = Thumb_Memory(cpu, pc, 2);
+    Thumb_Exec x;
+
+    cpu->event = 0;
+    if (p == NULL) return Thumb_Fault(cpu, "instruction fetch from 0x%08X", pc);
+
+    uint32_t hw1 = Thumb_U16(p), hw2 = 0;
+    int wide = (hw1 >> 11) >= 0x1D;
+    if (wide)
+    {
+        p = Thumb_Memory(cpu, pc + 2, 2);
+        if (p == NULL) return Thumb_Fault(cpu, "instruction fetch from 0x%08X", pc + 2);
+        hw2 = Thumb_U16(p);
+    }
+
+    Thumb_Fetch(cpu, pc);
+    if (wide) Thumb_Fetch(cpu, pc + 2);
+
+    x.cpu = cpu;
+    x.pc = pc;
+    x.next = pc + (wide ? 4 : 2);
+    x.cost = 1;
+    x.in_it = (cpu->it & 15) != 0;
+    x.ldst = 0;
+
+    int is_it = !wide && (hw1 & 0xFF00) == 0xBF00 && (hw1 & 15) != 0;
+    int execute = 1;
+    if (x.in_it && !is_it)
+    {
+        execute = Thumb_Condition(cpu->apsr, cpu->it >> 4);
+        cpu->it = (cpu->it & 7) == 0 ? 0 : (uint8_t)((cpu->it & 0xE0) | ((cpu->it << 1) & 0x1F));
+    }
+
+    int status = THUMB_OK;
+    if (execute) status = wide ? Thumb_Exec32(&x, hw1, hw2) : Thumb_Exec16(&x, hw1);
+    if (cpu->fault[0] != 0 && status != THUMB_STOPPED) return THUMB_FAULT;
+    if (status == THUMB_FAULT) return status;
+
+    cpu->cycles += x.cost;
+    cpu->instructions++;
+    cpu->last_was_ldst = x.ldst;
+    cpu->r[15] = x.next;
+    return status;
+}
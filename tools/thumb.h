@@ -0,0 +1,119 @@
+/**
+ * @file thumb.h
+ * @brief Cortex-M4 (ARMv7E-M Thumb-2) instruction-set emulator with a cycle
+ *        model, for the host tools
+ * @description Executes firmware images instruction by instruction: the
+ *              Thumb and Thumb-2 integer instructions GCC emits for the
+ *              Cortex-M4 (including the DSP multiplies, saturation and
+ *              parallel add/subtract) and the single-precision FPU.
+ *
+ * Memory: flash at 0x08000000 (aliased at 0), CCM RAM at 0x10000000, SRAM at
+ * 0x20000000, all owned by the emulator. Accesses to 0x40000000-0x5FFFFFFF
+ * (peripherals) and 0xE0000000-0xFFFFFFFF (system control space) go to the
+ * caller's `io` hooks; anything else is a fault.
+ *
+ * Cycles follow the Cortex-M4 TRM instruction timings: one cycle for most
+ * instructions, 1+P for taken branches (P = 2, pipeline refill), two for a
+ * load/store that does not pipeline with the previous one, 1+N for load/store
+ * multiple, 2-12 for divides (early termination), 14 for VDIV/VSQRT.
+ *
+ * Flash wait states follow the STM32F4 flash interface: the core fetches
+ * 128-bit lines, each new line costs `wait_states` cycles unless it is in
+ * the ART accelerator (64-line instruction cache, 8-line data cache) or was
+ * prefetched (the sequentially next line is read while the current one
+ * executes, hiding as many wait states as cycles spent on the current line).
+ * Literal pool and constant-table reads from flash pay the same latency
+ * through the data cache.
+ *
+ * Exceptions: Thumb_Interrupt() stacks R0-R3, R12, LR, PC, xPSR and enters a
+ * handler (12 cycles); the handler returns with EXC_RETURN (10 cycles).
+ */
+
+#ifndef THUMB_H
+#define THUMB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define THUMB_FLASH_BASE       0x08000000UL
+#define THUMB_FLASH_SIZE       0x00100000UL  // 1 MB
+#define THUMB_CCM_BASE         0x10000000UL
+#define THUMB_CCM_SIZE         0x00010000UL  // 64 KB
+#define THUMB_SRAM_BASE        0x20000000UL
+#define THUMB_SRAM_SIZE        0x00020000UL  // 128 KB (SRAM1 + SRAM2)
+
+#define THUMB_FLASH_LINE       16            // Bytes per flash line (128 bits)
+#define THUMB_ICACHE_LINES     64
+#define THUMB_DCACHE_LINES     8
+#define THUMB_MAX_NESTING      8             // Exception nesting depth
+
+#define THUMB_RETURN_MAGIC     0xFFFFFFFEUL  // LR for Thumb_Call(): returning there stops
+#define THUMB_EXC_RETURN       0xFFFFFFF9UL  // Return to thread mode, main stack
+
+// Thumb_Step() results
+#define THUMB_OK               0
+#define THUMB_STOPPED          1             // Returned to THUMB_RETURN_MAGIC or BKPT
+#define THUMB_FAULT            -1            // See cpu->fault
+
+// Events of the last step (cpu->event)
+#define THUMB_EVENT_CALL       1             // BL/BLX: event_target called, returns to event_return
+#define THUMB_EVENT_WFI        2             // WFI/WFE executed
+
+typedef struct {
+    // Peripheral and system-space accesses; size is 1, 2 or 4 bytes
+    uint32_t (*read)(void *ctx, uint32_t addr, int size);
+    void (*write)(void *ctx, uint32_t addr, uint32_t value, int size);
+    void *ctx;
+} Thumb_Io;
+
+typedef struct {
+    int wait_states;        // Flash latency (cycles per line read)
+    int prefetch;           // Prefetch of the next sequential line
+    int icache;             // ART instruction cache
+    int dcache;             // ART data cache
+} Thumb_Flash_Config;
+
+typedef struct {
+    uint32_t r[16];         // R0-R12, SP, LR, PC (address of the current instruction)
+    uint32_t apsr;          // N Z C V Q (bits 31-27) and GE (19-16)
+    uint32_t s[32];         // FPU single-precision registers
+    uint32_t fpscr;
+    uint8_t it;             // ITSTATE (IT[7:0])
+    uint8_t primask;
+    uint8_t handler;        // Exception nesting depth
+    struct {
+        uint32_t s[16];
+        uint32_t fpscr;
+    } fp_stack[THUMB_MAX_NESTING];  // FP caller-saved context per active exception
+
+    uint8_t *flash, *ccm, *sram;
+    Thumb_Io io;
+    Thumb_Flash_Config flash_cfg;
+
+    // Cycle model state
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t flash_stalls;  // Cycles lost to flash wait states
+    int last_was_ldst;      // Previous instruction was a single load/store
+    uint32_t fetch_line;    // Line in the fetch buffer (+1: none)
+    uint64_t fetch_ready;   // Cycle at which the prefetched next line is available
+    uint32_t icache_tag[THUMB_ICACHE_LINES];
+    uint64_t icache_used[THUMB_ICACHE_LINES];
+    uint32_t dcache_tag[THUMB_DCACHE_LINES];
+    uint64_t dcache_used[THUMB_DCACHE_LINES];
+
+    int event;
+    uint32_t event_target;
+    uint32_t event_return;
+    char fault[96];
+} Thumb_Cpu;
+
+int Thumb_Init(Thumb_Cpu *cpu, const Thumb_Io *io);
+void Thumb_Free(Thumb_Cpu *cpu);
+uint8_t *Thumb_Memory(Thumb_Cpu *cpu, uint32_t addr, uint32_t size);
+int Thumb_Reset(Thumb_Cpu *cpu);
+int Thumb_Step(Thumb_Cpu *cpu);
+void Thumb_Call(Thumb_Cpu *cpu, uint32_t function, uint32_t arg0);
+int Thumb_Interrupt(Thumb_Cpu *cpu, uint32_t handler);
+
+#endif /* THUMB_H */
@@ -0,0 +1,529 @@
+/**
+ * @file thumbsim.c
+ * @brief Cycle-level profile of the ARM firmware image on the host
+ * @description Loads the firmware ELF (the real Cortex-M4 build, not the
+ *              host simulation), executes it in the Thumb-2 emulator of
+ *              thumb.c and prints cycles per function, including the
+ *              cycles lost to flash wait states.
+ *
+ * Build:
+ *   gcc -O2 -I. tools/thumbsim.c tools/thumb.c tools/elf.c tools/trace.c -lm -o thumbsim
+ *
+ * Usage:
+ *   thumbsim firmware.elf [--call fn[:count]]... [--stub fn]... [--adc value | -t trace]
+ *            [--irq fn:period_cycles] [--ws n] [--art on|off] [--mhz 84]
+ *            [--max-cycles n] [--uart]
+ *
+ *   --call         Run fn(0) `count` times (default 1) from a fresh return;
+ *                  repeat to run several functions in order, e.g.
+ *                  --call App_Init --call App_Poll:1000. Without --call the
+ *                  image runs from the reset vector until --max-cycles.
+ *   --stub         Return from fn immediately (e.g. Delay_ms busy loops)
+ *   --adc / -t     Value of every ADC1->DR read, or the next reading of a
+ *                  trace per read (wrapping)
+ *   --irq          Enter handler fn every period_cycles (TIM2 update flag
+ *                  set beforehand); held pending while PRIMASK is set
+ *   --ws / --art   Flash wait states and ART accelerator (prefetch,
+ *                  instruction and data cache). By default both follow the
+ *                  firmware's own FLASH->ACR writes, as on the device.
+ *   --uart         Copy USART2->DR writes to stdout
+ *
+ * Peripheral registers are plain memory laid out as in stm32f4xx.h, with the
+ * ready/status bits the host simulation presets (sim/sim.c) held set, so the
+ * firmware's polling loops fall through. DWT->CYCCNT counts emulated cycles.
+ *
+ * "self" is cycles spent in the function's own instructions; "total" adds
+ * everything it called (BL/BLX) and is summed per call.
+ */
+
+#include "stm32f4xx.h"
+#include "elf.h"
+#include "thumb.h"
+#include "trace.h"
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define THUMBSIM_MAX_CALLS     32
+#define THUMBSIM_MAX_STUBS     16
+#define THUMBSIM_MAX_DEPTH     256
+#define THUMBSIM_PERIPH_SIZE   0x00040000UL    // 0x40000000-0x4003FFFF (APB1, APB2, AHB1)
+#define THUMBSIM_SCS_BASE      0xE0000000UL
+#define THUMBSIM_SCS_SIZE      0x00100000UL    // Private peripheral bus (DWT, NVIC, SCB)
+
+#define THUMBSIM_ADC1_DR       (ADC1_BASE + offsetof(ADC_TypeDef, DR))
+#define THUMBSIM_ADC1_SR       (ADC1_BASE + offsetof(ADC_TypeDef, SR))
+#define THUMBSIM_USART2_SR     (USART2_BASE + offsetof(USART_TypeDef, SR))
+#define THUMBSIM_USART2_DR     (USART2_BASE + offsetof(USART_TypeDef, DR))
+#define THUMBSIM_RCC_CR        (RCC_BASE + offsetof(RCC_TypeDef, CR))
+#define THUMBSIM_RCC_CFGR      (RCC_BASE + offsetof(RCC_TypeDef, CFGR))
+#define THUMBSIM_TIM2_SR       (TIM2_BASE + offsetof(TIM_TypeDef, SR))
+#define THUMBSIM_FLASH_ACR     (FLASH_BASE + offsetof(FLASH_TypeDef, ACR))
+#define THUMBSIM_DWT_CYCCNT    (DWT_BASE + offsetof(DWT_Type, CYCCNT))
+
+#define THUMBSIM_ACR_PRFTEN    (1UL << 8)
+#define THUMBSIM_ACR_ICEN      (1UL << 9)
+#define THUMBSIM_ACR_DCEN      (1UL << 10)
+
+typedef struct {
+    const char *name;
+    uint32_t addr;
+    uint32_t count;
+} Thumbsim_Call;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t self;          // Cycles in the function's own instructions
+    uint64_t total;         // Self plus callees, per completed call
+    uint64_t instructions;
+    uint64_t stalls;        // Flash wait-state cycles in its own instructions
+} Thumbsim_Stats;
+
+typedef struct {
+    size_t function;        // Stats index of the callee
+    uint32_t ret;           // Return address
+    uint8_t handler;        // Exception depth of the caller
+    uint8_t interrupt;      // Entered by an interrupt rather than a call
+    uint64_t start;         // Cycle count at entry
+    uint64_t irq_start;     // thumbsim_irq_cycles at entry
+} Thumbsim_Frame;
+
+typedef struct {
+    Thumb_Cpu *cpu;
+    uint8_t *periph;
+    uint8_t *scs;
+    uint16_t adc;           // Fixed ADC reading (no trace)
+    const Trace *trace;
+    size_t trace_pos;
+    int uart;
+    int ws_override;        // -1: follow FLASH->ACR
+    int art_override;       // -1: follow FLASH->ACR
+    uint64_t cyccnt_base;
+} Thumbsim_Io;
+
+static const Elf_File *thumbsim_elf;
+static Thumbsim_Stats *thumbsim_stats;      // One per ELF symbol, plus "unknown"
+static Thumbsim_Frame thumbsim_stack[THUMBSIM_MAX_DEPTH];
+static size_t thumbsim_depth;
+static uint64_t thumbsim_irq_cycles;        // Spent in interrupt handlers (kept out of callers' totals)
+
+static uint8_t *Thumbsim_Reg(Thumbsim_Io *io, uint32_t addr, int size)
+{
+    if (addr - PERIPH_BASE <= THUMBSIM_PERIPH_SIZE - (uint32_t)size) return io->periph + (addr - PERIPH_BASE);
+    if (addr - THUMBSIM_SCS_BASE <= THUMBSIM_SCS_SIZE - (uint32_t)size) return io->scs + (addr - THUMBSIM_SCS_BASE);
+    return NULL;
+}
+
+/**
+ * @brief Apply FLASH->ACR (latency, prefetch, caches) unless overridden
+ */
+static void Thumbsim_Flash_Config(Thumbsim_Io *io, uint32_t acr)
+{
+    Thumb_Flash_Config *cfg = &io->cpu->flash_cfg;
+
+    cfg->wait_states = io->ws_override >= 0 ? io->ws_override : (int)(acr & FLASH_ACR_LATENCY);
+    if (io->art_override >= 0)
+    {
+        cfg->prefetch = cfg->icache = cfg->dcache = io->art_override;
+    }
+    else
+    {
+        cfg->prefetch = (acr & THUMBSIM_ACR_PRFTEN) != 0;
+        cfg->icache = (acr & THUMBSIM_ACR_ICEN) != 0;
+        cfg->dcache = (acr & THUMBSIM_ACR_DCEN) != 0;
+    }
+}
+
+static uint32_t Thumbsim_Read(void *ctx, uint32_t addr, int size)
+{
+    Thumbsim_Io *io = (Thumbsim_Io *)ctx;
+    uint8_t *p = Thumbsim_Reg(io, addr, size);
+    uint32_t value = 0;
+
+    if (addr == THUMBSIM_ADC1_DR)
+    {
+        if (io->trace == NULL) return io->adc;
+        value = io->trace->samples[io->trace_pos];
+        io->trace_pos = (io->trace_pos + 1) % io->trace->count;
+        return value;
+    }
+    if (addr == THUMBSIM_DWT_CYCCNT) return (uint32_t)(io->cpu->cycles - io->cyccnt_base);
+    if (p == NULL) return 0;
+
+    for (int i = 0; i < size; i++) value |= (uint32_t)p[i] << (8 * i);
+    if (addr == THUMBSIM_ADC1_SR) value |= ADC_SR_EOC;
+    if (addr == THUMBSIM_USART2_SR) value |= USART_SR_TXE | USART_SR_TC;
+    if (addr == THUMBSIM_RCC_CR) value |= RCC_CR_HSERDY | RCC_CR_PLLRDY;
+    if (addr == THUMBSIM_RCC_CFGR) value |= RCC_CFGR_SWS_PLL;
+    return value;
+}
+
+static void Thumbsim_Write(void *ctx, uint32_t addr, uint32_t value, int size)
+{
+    Thumbsim_Io *io = (Thumbsim_Io *)ctx;
+    uint8_t *p = Thumbsim_Reg(io, addr, size);
+
+    if (addr == THUMBSIM_USART2_DR && io->uart) putchar((int)(value & 0xFF));
+    if (addr == THUMBSIM_DWT_CYCCNT) io->cyccnt_base = io->cpu->cycles - value;
+    if (addr == THUMBSIM_FLASH_ACR) Thumbsim_Flash_Config(io, value);
+    if (p == NULL) return;
+    for (int i = 0; i < size; i++) p[i] = (uint8_t)(value >> (8 * i));
+}
+
+/**
+ * @brief Copy the PT_LOAD segments into emulated memory
+ * @note Initialised data is placed at its run address as well as its load
+ *       address, so functions can be called without running the startup
+ *       code's copy loop.
+ */
+static int Thumbsim_Load(Thumb_Cpu *cpu, const Elf_File *elf)
+{
+    int loaded = 0;
+
+    for (size_t i = 0; i < elf->segment_count; i++)
+    {
+        const Elf_Segment *seg = &elf->segments[i];
+        uint64_t targets[2] = { seg->vaddr, seg->paddr };
+
+        if (seg->memsz == 0 || seg->offset + seg->filesz > elf->size) continue;
+        for (int t = 0; t < (seg->paddr != seg->vaddr ? 2 : 1); t++)
+        {
+            uint32_t size = (uint32_t)(t == 0 ? seg->memsz : seg->filesz);
+            uint8_t *dest = Thumb_Memory(cpu, (uint32_t)targets[t], size);
+            if (dest == NULL)
+            {
+                fprintf(stderr, "thumbsim: segment at 0x%08" PRIX64 " (%" PRIu64 " bytes) is outside flash/RAM\n",
+                        targets[t], (uint64_t)size);
+                return -1;
+            }
+            memcpy(dest, elf->data + seg->offset, (size_t)seg->filesz);
+            if (size > seg->filesz) memset(dest + seg->filesz, 0, (size_t)(size - seg->filesz));
+            loaded++;
+        }
+    }
+    return loaded ? 0 : -1;
+}
+
+static size_t Thumbsim_Function(uint32_t pc)
+{
+    static const Elf_Symbol *last;
+    const Elf_Symbol *sym = last;
+
+    if (sym == NULL || pc < sym->addr || pc >= sym->addr + (sym->size ? sym->size : 1))
+    {
+        sym = Elf_Find_Symbol(thumbsim_elf, pc);
+        if (sym == NULL) return thumbsim_elf->symbol_count;
+        last = sym;
+    }
+    return (size_t)(sym - thumbsim_elf->symbols);
+}
+
+static void Thumbsim_Push(Thumb_Cpu *cpu, uint32_t target, uint32_t ret)
+{
+    if (thumbsim_depth == THUMBSIM_MAX_DEPTH) return;
+    Thumbsim_Frame *frame = &thumbsim_stack[thumbsim_depth++];
+    frame->function = Thumbsim_Function(target);
+    frame->ret = ret;
+    frame->handler = cpu->handler;
+    frame->interrupt = 0;
+    frame->start = cpu->cycles;
+    frame->irq_start = thumbsim_irq_cycles;
+    thumbsim_stats[frame->function].calls++;
+}
+
+/**
+ * @brief Close the innermost frame
+ */
+static void Thumbsim_Close(Thumb_Cpu *cpu)
+{
+    Thumbsim_Frame *frame = &thumbsim_stack[--thumbsim_depth];
+    uint64_t elapsed = cpu->cycles - frame->start;
+
+    thumbsim_stats[frame->function].total += elapsed - (thumbsim_irq_cycles - frame->irq_start);
+    if (frame->interrupt) thumbsim_irq_cycles += elapsed;
+}
+
+/**
+ * @brief Close every frame whose return address was just reached
+ */
+static void Thumbsim_Pop(Thumb_Cpu *cpu)
+{
+    while (thumbsim_depth > 0)
+    {
+        Thumbsim_Frame *frame = &thumbsim_stack[thumbsim_depth - 1];
+        if (cpu->r[15] != frame->ret || cpu->handler != frame->handler) return;
+        Thumbsim_Close(cpu);
+    }
+}
+
+static int Thumbsim_Compare(const void *a, const void *b)
+{
+    uint64_t sa = thumbsim_stats[*(const size_t *)a].self, sb = thumbsim_stats[*(const size_t *)b].self;
+    return (sa < sb) - (sa > sb);
+}
+
+static uint32_t Thumbsim_Symbol(const Elf_File *elf, const char *name)
+{
+    const Elf_Symbol *sym = Elf_Lookup(elf, name);
+    if (sym == NULL)
+    {
+        fprintf(stderr, "thumbsim: no function %s in the ELF\n", name);
+        exit(1);
+    }
+    return (uint32_t)sym->addr;
+}
+
+static int Thumbsim_Usage(void)
+{
+    fprintf(stderr,
+            "usage: thumbsim firmware.elf [--call fn[:count]]... [--stub fn]... [--adc value | -t trace]\n"
+            "                [--irq fn:period_cycles] [--ws n] [--art on|off] [--mhz 84]\n"
+            "                [--max-cycles n] [--uart]\n");
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    Thumbsim_Call calls[THUMBSIM_MAX_CALLS];
+    const char *stub_names[THUMBSIM_MAX_STUBS];
+    size_t call_count = 0, stub_count = 0;
+    const char *trace_path = NULL, *irq_name = NULL;
+    uint64_t irq_period = 0, max_cycles = 0;
+    double mhz = 84.0;
+    Thumbsim_Io io;
+    Thumb_Cpu cpu;
+    Elf_File elf;
+    Trace trace;
+
+    memset(&io, 0, sizeof(io));
+    io.adc = 2048;
+    io.ws_override = -1;
+    io.art_override = -1;
+
+    if (argc < 2 || argv[1][0] == '-') return Thumbsim_Usage();
+    for (int i = 2; i < argc; i++)
+    {
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--uart") == 0)
+        {
+            io.uart = 1;
+            continue;
+        }
+        if (val == NULL) return Thumbsim_Usage();
+
+        if (strcmp(argv[i], "--call") == 0 && call_count < THUMBSIM_MAX_CALLS)
+        {
+            char *colon = strchr(argv[i + 1], ':');
+            calls[call_count].count = colon ? (uint32_t)strtoul(colon + 1, NULL, 0) : 1;
+            if (colon) *colon = '\0';
+            calls[call_count++].name = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--stub") == 0 && stub_count < THUMBSIM_MAX_STUBS)
+        {
+            stub_names[stub_count++] = val;
+        }
+        else if (strcmp(argv[i], "--adc") == 0) io.adc = (uint16_t)(strtoul(val, NULL, 0) & 0x0FFF);
+        else if (strcmp(argv[i], "-t") == 0) trace_path = val;
+        else if (strcmp(argv[i], "--irq") == 0)
+        {
+            char *colon = strchr(argv[i + 1], ':');
+            if (colon == NULL) return Thumbsim_Usage();
+            *colon = '\0';
+            irq_name = argv[i + 1];
+            irq_period = strtoull(colon + 1, NULL, 0);
+            if (irq_period == 0) return Thumbsim_Usage();
+        }
+        else if (strcmp(argv[i], "--ws") == 0) io.ws_override = atoi(val);
+        else if (strcmp(argv[i], "--art") == 0) io.art_override = strcmp(val, "on") == 0;
+        else if (strcmp(argv[i], "--mhz") == 0) mhz = atof(val);
+        else if (strcmp(argv[i], "--max-cycles") == 0) max_cycles = strtoull(val, NULL, 0);
+        else return Thumbsim_Usage();
+        i++;
+    }
+    if (mhz <= 0.0) return Thumbsim_Usage();
+    if (max_cycles == 0) max_cycles = (uint64_t)(mhz * 1e6);    // One emulated second
+
+    if (Elf_Load(&elf, argv[1]) != 0)
+    {
+        fprintf(stderr, "thumbsim: cannot read ELF %s\n", argv[1]);
+        return 1;
+    }
+    if (elf.is64 || elf.machine != 40)
+    {
+        fprintf(stderr, "thumbsim: %s is not an ARM image\n", argv[1]);
+        return 1;
+    }
+    if (trace_path != NULL)
+    {
+        if (Trace_Load(&trace, trace_path, 0.0f) != 0 || trace.count == 0)
+        {
+            fprintf(stderr, "thumbsim: cannot read trace %s\n", trace_path);
+            return 1;
+        }
+        io.trace = &trace;
+    }
+
+    const Thumb_Io hooks = { Thumbsim_Read, Thumbsim_Write, &io };
+    io.periph = (uint8_t *)calloc(1, THUMBSIM_PERIPH_SIZE);
+    io.scs = (uint8_t *)calloc(1, THUMBSIM_SCS_SIZE);
+    thumbsim_stats = (Thumbsim_Stats *)calloc(elf.symbol_count + 1, sizeof(Thumbsim_Stats));
+    if (io.periph == NULL || io.scs == NULL || thumbsim_stats == NULL || Thumb_Init(&cpu, &hooks) != 0)
+    {
+        fprintf(stderr, "thumbsim: out of memory\n");
+        return 1;
+    }
+    io.cpu = &cpu;
+    thumbsim_elf = &elf;
+    Thumbsim_Flash_Config(&io, 0);
+    if (Thumbsim_Load(&cpu, &elf) != 0)
+    {
+        fprintf(stderr, "thumbsim: %s has no loadable segments\n", argv[1]);
+        return 1;
+    }
+
+    uint32_t stubs[THUMBSIM_MAX_STUBS];
+    for (size_t i = 0; i < stub_count; i++) stubs[i] = Thumbsim_Symbol(&elf, stub_names[i]);
+    for (size_t i = 0; i < call_count; i++) calls[i].addr = Thumbsim_Symbol(&elf, calls[i].name);
+    uint32_t irq_handler = irq_name ? Thumbsim_Symbol(&elf, irq_name) : 0;
+
+    if (Thumb_Reset(&cpu) != 0)
+    {
+        if (call_count == 0)
+        {
+            fprintf(stderr, "thumbsim: %s has no usable vector table; use --call\n", argv[1]);
+            return 1;
+        }
+        cpu.r[13] = THUMB_SRAM_BASE + THUMB_SRAM_SIZE;
+    }
+    const uint32_t initial_sp = cpu.r[13];
+
+    // Run: each call (or the reset handler) until it returns, faults or runs out of cycles
+    uint64_t next_irq = irq_period, sleep_cycles = 0;
+    size_t call_index = 0;
+    uint32_t repeat = 0;
+    int status = THUMB_OK, started = 0;
+
+    if (call_count == 0) Thumbsim_Push(&cpu, cpu.r[15], THUMB_RETURN_MAGIC);
+    while (cpu.cycles < max_cycles)
+    {
+        if (call_count > 0 && (!started || status == THUMB_STOPPED))
+        {
+            while (call_index < call_count && repeat == calls[call_index].count)
+            {
+                call_index++;
+                repeat = 0;
+            }
+            if (call_index == call_count) break;
+            cpu.r[13] = initial_sp;
+            Thumb_Call(&cpu, calls[call_index].addr, 0);
+            Thumbsim_Push(&cpu, calls[call_index].addr, THUMB_RETURN_MAGIC);
+            repeat++;
+            started = 1;
+            status = THUMB_OK;
+        }
+        else if (status == THUMB_STOPPED)
+        {
+            break;
+        }
+
+        if (irq_handler != 0 && cpu.handler == 0 && cpu.cycles >= next_irq)
+        {
+            uint32_t interrupted = cpu.r[15];
+            uint8_t handler = cpu.handler;
+            uint32_t *sr = (uint32_t *)(io.periph + (THUMBSIM_TIM2_SR - PERIPH_BASE));
+            *sr |= TIM_SR_UIF;
+            int taken = Thumb_Interrupt(&cpu, irq_handler);
+            if (taken < 0) break;
+            if (taken)
+            {
+                thumbsim_stats[Thumbsim_Function(irq_handler)].self += 12;
+                Thumbsim_Push(&cpu, irq_handler, interrupted);
+                thumbsim_stack[thumbsim_depth - 1].handler = handler;
+                thumbsim_stack[thumbsim_depth - 1].interrupt = 1;
+                thumbsim_stack[thumbsim_depth - 1].start -= 12;
+                next_irq += irq_period;
+            }
+        }
+
+        size_t function = Thumbsim_Function(cpu.r[15]);
+        uint64_t cycles = cpu.cycles, stalls = cpu.flash_stalls;
+        int stubbed = 0;
+        for (size_t i = 0; i < stub_count && !stubbed; i++) stubbed = (cpu.r[15] == stubs[i]);
+
+        if (stubbed)
+        {
+            status = cpu.r[14] == THUMB_RETURN_MAGIC ? THUMB_STOPPED : THUMB_OK;
+            cpu.r[15] = cpu.r[14] & ~1UL;
+            cpu.cycles += 1 + 2;    // BX LR
+        }
+        else
+        {
+            status = Thumb_Step(&cpu);
+            if (status == THUMB_FAULT || (status == THUMB_STOPPED && cpu.fault[0] != 0)) break;
+            if (cpu.event == THUMB_EVENT_CALL) Thumbsim_Push(&cpu, cpu.event_target, cpu.event_return);
+            thumbsim_stats[function].instructions++;
+        }
+        thumbsim_stats[function].self += cpu.cycles - cycles;
+        thumbsim_stats[function].stalls += cpu.flash_stalls - stalls;
+
+        if (status == THUMB_STOPPED && thumbsim_depth > 0 && thumbsim_stack[thumbsim_depth - 1].ret == THUMB_RETURN_MAGIC)
+        {
+            Thumbsim_Close(&cpu);
+        }
+        Thumbsim_Pop(&cpu);
+
+        if (cpu.event == THUMB_EVENT_WFI && irq_handler != 0 && next_irq > cpu.cycles)
+        {
+            // Sleep until the next interrupt
+            sleep_cycles += next_irq - cpu.cycles;
+            cpu.cycles = next_irq;
+        }
+    }
+
+    if (status == THUMB_FAULT) fprintf(stderr, "thumbsim: %s\n", cpu.fault);
+    else if (status == THUMB_STOPPED && cpu.fault[0] != 0) fprintf(stderr, "thumbsim: stopped: %s\n", cpu.fault);
+
+    // Report, hottest self first
+    size_t *order = (size_t *)malloc((elf.symbol_count + 1) * sizeof(size_t));
+    size_t used = 0;
+    uint64_t busy = cpu.cycles - sleep_cycles;
+    if (order == NULL)
+    {
+        fprintf(stderr, "thumbsim: out of memory\n");
+        return 1;
+    }
+    for (size_t i = 0; i <= elf.symbol_count; i++)
+    {
+        if (thumbsim_stats[i].self != 0 || thumbsim_stats[i].calls != 0) order[used++] = i;
+    }
+    qsort(order, used, sizeof(size_t), Thumbsim_Compare);
+
+    printf("# %" PRIu64 " cycles (%.3f ms at %.0f MHz), %" PRIu64 " instructions, CPI %.2f, %" PRIu64 " asleep\n",
+           cpu.cycles, (double)cpu.cycles / (mhz * 1e3), mhz, cpu.instructions,
+           cpu.instructions ? (double)busy / (double)cpu.instructions : 0.0, sleep_cycles);
+    printf("# flash: %d wait states, prefetch %s, icache %s, dcache %s; %" PRIu64 " stall cycles (%.1f%%)\n",
+           cpu.flash_cfg.wait_states, cpu.flash_cfg.prefetch ? "on" : "off", cpu.flash_cfg.icache ? "on" : "off",
+           cpu.flash_cfg.dcache ? "on" : "off", cpu.flash_stalls,
+           busy ? 100.0 * (double)cpu.flash_stalls / (double)busy : 0.0);
+    printf("%8s %12s %7s %12s %12s %8s %7s  %s\n", "calls", "self", "%", "total", "instr", "stall%", "cyc/call", "function");
+    for (size_t i = 0; i < used; i++)
+    {
+        const Thumbsim_Stats *s = &thumbsim_stats[order[i]];
+        const char *name = order[i] < elf.symbol_count ? elf.symbols[order[i]].name : "(unknown)";
+        printf("%8" PRIu64 " %12" PRIu64 " %7.2f %12" PRIu64 " %12" PRIu64 " %8.1f %7.0f  %s\n",
+               s->calls, s->self, busy ? 100.0 * (double)s->self / (double)busy : 0.0, s->total, s->instructions,
+               s->self ? 100.0 * (double)s->stalls / (double)s->self : 0.0,
+               s->calls ? (double)s->total / (double)s->calls : 0.0, name);
+    }
+
+    free(order);
+    free(thumbsim_stats);
+    free(io.periph);
+    free(io.scs);
+    if (trace_path != NULL) Trace_Free(&trace);
+    Thumb_Free(&cpu);
+    Elf_Free(&elf);
+    return status == THUMB_FAULT ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file trace.c
+ * @brief Recorded ADC traces for the host tools
+ */
+
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Check whether a path names a raw binary trace
+ */
+static int Trace_Is_Binary(const char *path)
+{
+    const char *ext = strrchr(path, '.');
+    return ext != NULL && (strcmp(ext, ".u16") == 0 || strcmp(ext, ".bin") == 0);
+}
+
+/**
+ * @brief Load a trace from disk
+ * @param trace: Destination (samples are heap allocated)
+ * @param path: Trace file
+ * @param rate_hz: Sample rate to record in the trace
+ * @return 0 on success, -1 on error
+ */
+int Trace_Load(Trace *trace, const char *path, float rate_hz)
+{
+    FILE *f = fopen(path, Trace_Is_Binary(path) ? "rb" : "r");
+    size_t capacity = 4096;
+
+    memset(trace, 0, sizeof(*trace));
+    trace->rate_hz = rate_hz;
+    if (f == NULL) return -1;
+
+    trace->samples = (uint16_t *)malloc(capacity * sizeof(uint16_t));
+    if (trace->samples == NULL)
+    {
+        fclose(f);
+        return -1;
+    }
+
+    if (Trace_Is_Binary(path))
+    {
+        uint8_t raw[2];
+        while (fread(raw, 1, 2, f) == 2)
+        {
+            if (trace->count == capacity)
+            {
+                capacity *= 2;
+                uint16_t *grown = (uint16_t *)realloc(trace->samples, capacity * sizeof(uint16_t));
+                if (grown == NULL) break;
+                trace->samples = grown;
+            }
+            trace->samples[trace->count++] = (uint16_t)((raw[0] | (raw[1] << 8)) & 0x0FFF);
+        }
+    }
+    else
+    {
+        char line[128];
+        while (fgets(line, sizeof(line), f) != NULL)
+        {
+            char *end;
+            long value = strtol(line, &end, 10);
+            if (end == line) continue;  // Blank line or comment
+            if (value < 0) value = 0;
+            if (value > 4095) value = 4095;
+
+            if (trace->count == capacity)
+            {
+                capacity *= 2;
+                uint16_t *grown = (uint16_t *)realloc(trace->samples, capacity * sizeof(uint16_t));
+                if (grown == NULL) break;
+                trace->samples = grown;
+            }
+            trace->samples[trace->count++] = (uint16_t)value;
+        }
+    }
+
+    fclose(f);
+    return 0;
+}
+
+/**
+ * @brief Write a trace to disk (format chosen by the file extension)
+ * @param trace: Trace to write
+ * @param path: Destination file
+ * @return 0 on success, -1 on error
+ */
+int Trace_Save(const Trace *trace, const char *path)
+{
+    FILE *f = fopen(path, Trace_Is_Binary(path) ? "wb" : "w");
+    int ok = 1;
+
+    if (f == NULL) return -1;
+
+    for (size_t i = 0; i < trace->count && ok; i++)
+    {
+        if (Trace_Is_Binary(path))
+        {
+            uint8_t raw[2] = { (uint8_t)(trace->samples[i] & 0xFF), (uint8_t)(trace->samples[i] >> 8) };
+            ok = fwrite(raw, 1, 2, f) == 2;
+        }
+        else
+        {
+            ok = fprintf(f, "%u\n", trace->samples[i]) > 0;
+        }
+    }
+
+    if (fclose(f) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief Release trace memory
+ */
+void Trace_Free(Trace *trace)
+{
+    free(trace->samples);
+    memset(trace, 0, sizeof(*trace));
+}
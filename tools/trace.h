@@ -0,0 +1,28 @@
+/**
+ * @file trace.h
+ * @brief Recorded ADC traces for the host tools
+ * @description A trace is a sequence of 12-bit ADC readings taken at the
+ *              firmware control rate (one reading per main loop iteration).
+ *
+ * File formats:
+ *   - *.u16 / *.bin: raw little-endian uint16 samples
+ *   - anything else: text, one ADC value per line, '#' starts a comment
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint16_t *samples;      // ADC readings (0-4095)
+    size_t count;           // Number of readings
+    float rate_hz;          // Readings per second
+} Trace;
+
+int Trace_Load(Trace *trace, const char *path, float rate_hz);
+int Trace_Save(const Trace *trace, const char *path);
+void Trace_Free(Trace *trace);
+
+#endif /* TRACE_H */
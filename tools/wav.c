@@ -0,0 +1,213 @@
+/**
+ * @file wav.c
+ * @brief WAV input and 16-bit mono PCM WAV output for the host tools
+ */
+
+#include "wav.h"
+#include <string.h>
+
+#define WAV_HEADER_BYTES       44
+#define WAV_FORMAT_PCM         1
+#define WAV_FORMAT_FLOAT       3
+#define WAV_FORMAT_EXTENSIBLE  0xFFFE
+
+static void Wav_Put16(uint8_t *p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void Wav_Put32(uint8_t *p, uint32_t v) { Wav_Put16(p, v); Wav_Put16(p + 2, v >> 16); }
+static uint32_t Wav_Get16(const uint8_t *p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8); }
+static uint32_t Wav_Get32(const uint8_t *p) { return Wav_Get16(p) | (Wav_Get16(p + 2) << 16); }
+
+/**
+ * @brief Canonical 44-byte header for `samples` mono 16-bit samples
+ */
+static int Wav_Write_Header(Wav_Writer *wav)
+{
+    uint8_t h[WAV_HEADER_BYTES];
+    uint64_t data_bytes = wav->samples * 2;
+    uint32_t data_size = data_bytes > 0xFFFFFFFFULL - 36 ? 0xFFFFFFFFUL - 36 : (uint32_t)data_bytes;
+
+    memcpy(h, "RIFF", 4);
+    Wav_Put32(h + 4, 36 + data_size);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    Wav_Put32(h + 16, 16);                      // fmt chunk size
+    Wav_Put16(h + 20, 1);                       // PCM
+    Wav_Put16(h + 22, 1);                       // Mono
+    Wav_Put32(h + 24, wav->sample_rate);
+    Wav_Put32(h + 28, wav->sample_rate * 2);    // Byte rate
+    Wav_Put16(h + 32, 2);                       // Block align
+    Wav_Put16(h + 34, 16);                      // Bits per sample
+    memcpy(h + 36, "data", 4);
+    Wav_Put32(h + 40, data_size);
+
+    return fwrite(h, 1, sizeof(h), wav->file) == sizeof(h) ? 0 : -1;
+}
+
+/**
+ * @brief Create a WAV file
+ * @return 0 on success, -1 on error
+ */
+int Wav_Open(Wav_Writer *wav, const char *path, uint32_t sample_rate)
+{
+    wav->file = fopen(path, "wb");
+    wav->sample_rate = sample_rate;
+    wav->samples = 0;
+    if (wav->file == NULL) return -1;
+    return Wav_Write_Header(wav);
+}
+
+/**
+ * @brief Append samples
+ * @return 0 on success, -1 on error
+ */
+int Wav_Write(Wav_Writer *wav, const int16_t *samples, size_t count)
+{
+    uint8_t buf[2048];
+
+    while (count > 0)
+    {
+        size_t n = count < sizeof(buf) / 2 ? count : sizeof(buf) / 2;
+        for (size_t i = 0; i < n; i++) Wav_Put16(buf + 2 * i, (uint16_t)samples[i]);
+        if (fwrite(buf, 2, n, wav->file) != n) return -1;
+        wav->samples += n;
+        samples += n;
+        count -= n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Patch the header sizes and close the file
+ * @return 0 on success, -1 on error
+ */
+int Wav_Close(Wav_Writer *wav)
+{
+    int status = 0;
+
+    if (fseek(wav->file, 0, SEEK_SET) != 0 || Wav_Write_Header(wav) != 0) status = -1;
+    if (fclose(wav->file) != 0) status = -1;
+    wav->file = NULL;
+    return status;
+}
+
+/**
+ * @brief Open a WAV file for reading and position it at the first sample
+ * @return 0 on success, -1 if the file cannot be read or the format is not
+ *         supported
+ */
+int Wav_Read_Open(Wav_Reader *wav, const char *path)
+{
+    uint8_t h[40];
+    int have_format = 0;
+
+    memset(wav, 0, sizeof(*wav));
+    wav->file = fopen(path, "rb");
+    if (wav->file == NULL) return -1;
+
+    if (fread(h, 1, 12, wav->file) != 12 || memcmp(h, "RIFF", 4) != 0 || memcmp(h + 8, "WAVE", 4) != 0)
+    {
+        Wav_Read_Close(wav);
+        return -1;
+    }
+
+    // Walk the chunks up to "data"; chunks are padded to even sizes
+    for (;;)
+    {
+        if (fread(h, 1, 8, wav->file) != 8) break;
+        uint32_t size = Wav_Get32(h + 4);
+
+        if (memcmp(h, "fmt ", 4) == 0 && size >= 16)
+        {
+            uint32_t keep = size < sizeof(h) ? size : (uint32_t)sizeof(h);
+            if (fread(h, 1, keep, wav->file) != keep) break;
+            if (fseek(wav->file, (long)(size - keep + (size & 1)), SEEK_CUR) != 0) break;
+
+            uint32_t format = Wav_Get16(h);
+            if (format == WAV_FORMAT_EXTENSIBLE && keep >= 26) format = Wav_Get16(h + 24);  // Sub-format GUID
+            wav->channels = (uint16_t)Wav_Get16(h + 2);
+            wav->sample_rate = Wav_Get32(h + 4);
+            wav->bits = (uint16_t)Wav_Get16(h + 14);
+            wav->is_float = (format == WAV_FORMAT_FLOAT);
+            have_format = (format == WAV_FORMAT_PCM && wav->bits >= 8 && wav->bits <= 32 && wav->bits % 8 == 0) ||
+                          (wav->is_float && wav->bits == 32);
+            have_format = have_format && wav->channels > 0 && wav->sample_rate > 0;
+        }
+        else if (memcmp(h, "data", 4) == 0)
+        {
+            if (!have_format) break;
+            wav->frames = size / ((uint32_t)wav->channels * (wav->bits / 8));
+            wav->remaining = wav->frames;
+            return 0;
+        }
+        else if (fseek(wav->file, (long)size + (size & 1), SEEK_CUR) != 0)
+        {
+            break;
+        }
+    }
+
+    Wav_Read_Close(wav);
+    return -1;
+}
+
+/**
+ * @brief Read up to `count` frames, mixed down to mono
+ * @param samples: Output, -1..1
+ * @return Frames read; 0 at the end of the data (or on a read error)
+ */
+size_t Wav_Read(Wav_Reader *wav, float *samples, size_t count)
+{
+    uint8_t buf[8192];
+    const uint32_t bytes = wav->bits / 8;
+    const uint32_t frame_bytes = bytes * wav->channels;
+    const size_t per_read = sizeof(buf) / frame_bytes;
+    const float scale = 1.0f / ((float)wav->channels * (wav->is_float ? 1.0f : 2147483648.0f));
+    size_t done = 0;
+
+    if (per_read == 0) return 0;    // Frames larger than the buffer (hundreds of channels)
+    if (count > wav->remaining) count = (size_t)wav->remaining;
+
+    while (done < count)
+    {
+        size_t n = count - done < per_read ? count - done : per_read;
+        n = fread(buf, frame_bytes, n, wav->file);
+        if (n == 0) break;
+
+        const uint8_t *p = buf;
+        for (size_t i = 0; i < n; i++)
+        {
+            float sum = 0.0f;
+            for (uint32_t c = 0; c < wav->channels; c++, p += bytes)
+            {
+                if (wav->is_float)
+                {
+                    uint32_t raw = Wav_Get32(p);
+                    float v;
+                    memcpy(&v, &raw, sizeof(v));
+                    sum += v;
+                }
+                else if (bytes == 1)
+                {
+                    sum += (float)(int32_t)((uint32_t)(p[0] ^ 0x80) << 24);    // 8-bit PCM is unsigned
+                }
+                else
+                {
+                    // Left-align to 32 bits so every width shares one scale
+                    uint32_t raw = 0;
+                    for (uint32_t b = 0; b < bytes; b++) raw |= (uint32_t)p[b] << (8 * (4 - bytes + b));
+                    sum += (float)(int32_t)raw;
+                }
+            }
+            samples[done + i] = sum * scale;
+        }
+        done += n;
+        wav->remaining -= n;
+    }
+    return done;
+}
+
+/**
+ * @brief Close a file opened with Wav_Read_Open()
+ */
+void Wav_Read_Close(Wav_Reader *wav)
+{
+    if (wav->file != NULL) fclose(wav->file);
+    wav->file = NULL;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file wav.h
+ * @brief WAV input and 16-bit mono PCM WAV output for the host tools
+ * @description Samples are streamed to disk; the RIFF sizes are patched in
+ *              when the file is closed, so the length need not be known up
+ *              front.
+ *
+ * The reader accepts what phones and editors export: PCM 8/16/24/32-bit or
+ * IEEE float 32-bit, any channel count (mixed down to mono), plain or
+ * WAVE_FORMAT_EXTENSIBLE headers. Samples come out as floats in -1..1.
+ */
+
+#ifndef WAV_H
+#define WAV_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct {
+    FILE *file;
+    uint32_t sample_rate;
+    uint64_t samples;       // Written so far
+} Wav_Writer;
+
+typedef struct {
+    FILE *file;
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t bits;          // Bits per sample (container)
+    int is_float;           // IEEE float samples
+    uint64_t frames;        // Frames in the data chunk
+    uint64_t remaining;     // Frames not read yet
+} Wav_Reader;
+
+int Wav_Open(Wav_Writer *wav, const char *path, uint32_t sample_rate);
+int Wav_Write(Wav_Writer *wav, const int16_t *samples, size_t count);
+int Wav_Close(Wav_Writer *wav);
+
+int Wav_Read_Open(Wav_Reader *wav, const char *path);
+size_t Wav_Read(Wav_Reader *wav, float *samples, size_t count);
+void Wav_Read_Close(Wav_Reader *wav);
+
+#endif /* WAV_H */
@@ -0,0 +1,146 @@
+/**
+ * @file uart.c
+ * @brief Debug/report UART (USART2 on PA2/PA3, 115200 8N1)
+ */
+
+#include "stm32f4xx.h"
+#include "uart.h"
+
+#ifdef HOST_SIMULATION
+#include <stdio.h>
+#endif
+
+// Bytes received by USART2_IRQHandler() and not yet read
+SIM_RAM volatile uint8_t uart_rx[UART_RX_SIZE];
+SIM_RAM volatile uint8_t uart_rx_head = 0;   // Next slot written by the interrupt
+SIM_RAM volatile uint8_t uart_rx_tail = 0;   // Next slot read by UART_Getc()
+
+/**
+ * @brief USART2 on PA2 (AF7), 115200 baud from the 42 MHz APB1 clock
+ * @note Does nothing if USART2 is already enabled.
+ */
+void UART_Init(void)
+{
+    // Shared by several reporters: a second call must not undo UART_Rx_Init()
+    if (USART2->CR1 & USART_CR1_UE) return;
+
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
+    RCC->APB1ENR |= RCC_APB1ENR_USART2EN;
+
+    GPIOA->MODER = (GPIOA->MODER & ~GPIO_MODER_MODER2) | (2UL << 4);     // AF mode
+    GPIOA->AFR[0] = (GPIOA->AFR[0] & ~(0xFUL << 8)) | (7UL << 8);       // AF7
+
+    USART2->BRR = (42000000UL + 115200UL / 2) / 115200UL;
+    USART2->CR1 = USART_CR1_UE | USART_CR1_TE;
+}
+
+/**
+ * @brief Send one character (blocking)
+ */
+void UART_Putc(char c)
+{
+#ifdef HOST_SIMULATION
+    putchar(c);
+#else
+    while (!(USART2->SR & USART_SR_TXE));
+    USART2->DR = (uint8_t)c;
+#endif
+}
+
+/**
+ * @brief Send a string
+ */
+void UART_Puts(const char *s)
+{
+    while (*s) UART_Putc(*s++);
+}
+
+/**
+ * @brief Send an unsigned decimal number
+ */
+void UART_Put_Uint(uint32_t value)
+{
+    char digits[10];
+    int n = 0;
+
+    do
+    {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (n > 0) UART_Putc(digits[--n]);
+}
+
+/**
+ * @brief Send a signed decimal number
+ */
+void UART_Put_Int(int32_t value)
+{
+    if (value < 0)
+    {
+        UART_Putc('-');
+        UART_Put_Uint(0u - (uint32_t)value);
+        return;
+    }
+    UART_Put_Uint((uint32_t)value);
+}
+
+/**
+ * @brief Send a number as 8 hex digits
+ */
+void UART_Put_Hex(uint32_t value)
+{
+    for (int shift = 28; shift >= 0; shift -= 4)
+    {
+        UART_Putc("0123456789abcdef"[(value >> shift) & 0xF]);
+    }
+}
+
+/**
+ * @brief Enable reception on PA3 (AF7) with the RXNE interrupt
+ * @note Call after UART_Init().
+ */
+void UART_Rx_Init(void)
+{
+    GPIOA->MODER = (GPIOA->MODER & ~GPIO_MODER_MODER3) | (2UL << 6);     // AF mode
+    GPIOA->AFR[0] = (GPIOA->AFR[0] & ~(0xFUL << 12)) | (7UL << 12);     // AF7
+
+    uart_rx_head = 0;
+    uart_rx_tail = 0;
+    USART2->CR1 |= USART_CR1_RE | USART_CR1_RXNEIE;
+
+    NVIC->IP[USART2_IRQn] = 0x40;   // Below the audio sample interrupt
+    NVIC->ISER[USART2_IRQn >> 5] = 1UL << (USART2_IRQn & 31);
+}
+
+/**
+ * @brief Take the next received character
+ * @return Character (0-255), or -1 if nothing has been received
+ */
+int UART_Getc(void)
+{
+    if (uart_rx_tail == uart_rx_head) return -1;
+
+    uint8_t c = uart_rx[uart_rx_tail];
+    uart_rx_tail = (uint8_t)((uart_rx_tail + 1) & (UART_RX_SIZE - 1));
+    return c;
+}
+
+/**
+ * @brief Queue a received byte (dropped when the queue is full)
+ */
+void USART2_IRQHandler(void)
+{
+    if (!(USART2->SR & USART_SR_RXNE)) return;
+
+    uint8_t c = (uint8_t)USART2->DR;    // Clears RXNE (and an overrun)
+#ifdef HOST_SIMULATION
+    USART2->SR &= ~USART_SR_RXNE;
+#endif
+    uint8_t next = (uint8_t)((uart_rx_head + 1) & (UART_RX_SIZE - 1));
+    if (next == uart_rx_tail) return;
+
+    uart_rx[uart_rx_head] = c;
+    uart_rx_head = next;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file uart.h
+ * @brief Debug/report UART (USART2 on PA2/PA3, 115200 8N1)
+ * @description Blocking byte output used by the benchmark and profiler
+ *              reports. In the host simulation the bytes go to stdout.
+ *              Reception is optional (UART_Rx_Init()): an RXNE interrupt
+ *              queues bytes so a 100 ms main loop tick does not overrun the
+ *              single-byte data register, and UART_Getc() drains the queue.
+ */
+
+#ifndef UART_H
+#define UART_H
+
+#include <stdint.h>
+
+#define UART_RX_SIZE           32   // Receive queue (power of two)
+
+void UART_Init(void);
+void UART_Putc(char c);
+void UART_Puts(const char *s);
+void UART_Put_Uint(uint32_t value);
+void UART_Put_Int(int32_t value);
+void UART_Put_Hex(uint32_t value);
+void UART_Rx_Init(void);
+int UART_Getc(void);
+void USART2_IRQHandler(void);
+
+#endif /* UART_H */